@@ -0,0 +1,164 @@
+#include "active.h"
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+
+/* 事件放入对象的队列并唤醒宿主任务，队列满时返回 pdFAIL，否则返回 pdPASS；
+ * 唤醒了宿主任务时把本核是否需要切换写入 *pxYieldRequired，没有唤醒时不修改，调用者要先置为 pdFALSE；必须在临界区中调用 */
+static BaseType_t prvPost(ActiveObject_t *const pxObject, const ActiveEvent_t *const pxEvent, BaseType_t *const pxYieldRequired)
+{
+    ActiveHost_t *const pxHost = pxObject->pxHost;
+
+    if (pxObject->uxWaiting >= pxObject->uxLength)
+    {
+        return pdFAIL;
+    }
+    pxObject->ppxQueue[pxObject->uxWriteIndex] = pxEvent;
+    if (++(pxObject->uxWriteIndex) == pxObject->uxLength)
+    {
+        pxObject->uxWriteIndex = (UBaseType_t)0;
+    }
+    if (++(pxObject->uxWaiting) > pxObject->uxMaxWaiting)
+    {
+        pxObject->uxMaxWaiting = pxObject->uxWaiting;
+    }
+    if (listLIST_IS_EMPTY(&(pxHost->xHostWaiting)) == pdFALSE)
+    {
+        *pxYieldRequired = xTaskRemoveFromEventList(&(pxHost->xHostWaiting));
+    }
+    return pdPASS;
+}
+
+void vActiveHostInitialise(ActiveHost_t *const pxHost)
+{
+    pxHost->pxObjects = NULL;
+    vListInitialise(&(pxHost->xHostWaiting));
+    pxHost->uxDispatched = (UBaseType_t)0;
+}
+
+void vActiveHostTask(void *pvParameters)
+{
+    ActiveHost_t *const pxHost = (ActiveHost_t *)pvParameters;
+    ActiveObject_t *pxObject;
+    const ActiveEvent_t *pxEvent = NULL;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            // 对象按优先级排好，第一个队列不空的就是要分发的
+            for (pxObject = pxHost->pxObjects; pxObject != NULL; pxObject = pxObject->pxNext)
+            {
+                if (pxObject->uxWaiting > (UBaseType_t)0)
+                {
+                    pxEvent = pxObject->ppxQueue[pxObject->uxReadIndex];
+                    if (++(pxObject->uxReadIndex) == pxObject->uxLength)
+                    {
+                        pxObject->uxReadIndex = (UBaseType_t)0;
+                    }
+                    pxObject->uxWaiting--;
+                    break;
+                }
+            }
+            if (pxObject == NULL)
+            {
+                vTaskPlaceOnEventList(&(pxHost->xHostWaiting), portMAX_DELAY);
+                taskYIELD();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if (pxObject != NULL)
+        {
+            pxObject->pxDispatch(pxObject, pxEvent);
+            vMsgBusRelease((void *)pxEvent);
+            pxHost->uxDispatched++;
+        }
+    }
+}
+
+void vActiveObjectCreate(ActiveObject_t *const pxObject,
+                         ActiveHost_t *const pxHost,
+                         ActiveDispatch_t pxDispatch,
+                         UBaseType_t uxPriority,
+                         const ActiveEvent_t **const ppxQueueStorage,
+                         const UBaseType_t uxQueueLength)
+{
+    ActiveObject_t **ppxLink = &(pxHost->pxObjects);
+
+    configASSERT((pxDispatch != NULL) && (ppxQueueStorage != NULL) && (uxQueueLength > (UBaseType_t)0));
+    pxObject->pxHost = pxHost;
+    pxObject->pxDispatch = pxDispatch;
+    pxObject->uxPriority = uxPriority;
+    pxObject->ppxQueue = ppxQueueStorage;
+    pxObject->uxLength = uxQueueLength;
+    pxObject->uxWaiting = (UBaseType_t)0;
+    pxObject->uxReadIndex = (UBaseType_t)0;
+    pxObject->uxWriteIndex = (UBaseType_t)0;
+    pxObject->uxMaxWaiting = (UBaseType_t)0;
+
+    taskENTER_CRITICAL();
+    {
+        // 同优先级的排在已有对象之后
+        while ((*ppxLink != NULL) && ((*ppxLink)->uxPriority >= uxPriority))
+        {
+            ppxLink = &((*ppxLink)->pxNext);
+        }
+        pxObject->pxNext = *ppxLink;
+        *ppxLink = pxObject;
+    }
+    taskEXIT_CRITICAL();
+}
+
+ActiveEvent_t *pxActiveEventAlloc(MsgPool_t *const pxPool, const UBaseType_t uxSignal, TickType_t xTicksToWait)
+{
+    ActiveEvent_t *const pxEvent = (ActiveEvent_t *)pvMsgBusAlloc(pxPool, xTicksToWait);
+
+    if (pxEvent != NULL)
+    {
+        pxEvent->uxSignal = uxSignal;
+    }
+    return pxEvent;
+}
+
+BaseType_t xActivePost(ActiveObject_t *const pxObject, const ActiveEvent_t *const pxEvent)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    BaseType_t xReturn;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvPost(pxObject, pxEvent, &xYieldRequired);
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+    if (xReturn == pdFAIL)
+    {
+        vMsgBusRelease((void *)pxEvent);
+    }
+    return xReturn;
+}
+
+BaseType_t xActivePostFromISR(ActiveObject_t *const pxObject, const ActiveEvent_t *const pxEvent, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvPost(pxObject, pxEvent, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    if (xReturn == pdFAIL)
+    {
+        vMsgBusReleaseFromISR((void *)pxEvent, &xYieldRequired);
+    }
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return xReturn;
+}
+
+#endif /* configUSE_ACTIVE_OBJECTS */
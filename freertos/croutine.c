@@ -0,0 +1,322 @@
+#include <string.h>
+#include "task.h"
+#include "croutine.h"
+
+#if (configUSE_CO_ROUTINES == 1)
+
+/** 协程的就绪与延时队列，结构和任务的一样
+ *  只有运行协程的那个任务会修改就绪与延时队列，不需要临界区；
+ *  中断可能唤醒等待队列的协程，但不能碰就绪队列，所以唤醒的协程先挂到 xPendingReadyCoRoutineList，下次调度时再移到就绪队列，
+ *  队列的等待链表和 xPendingReadyCoRoutineList 中断也会修改，访问它们都在临界区中
+ */
+static List_t pxReadyCoRoutineLists[configMAX_CO_ROUTINE_PRIORITIES];
+static List_t xDelayedCoRoutineList1, xDelayedCoRoutineList2;
+static List_t *pxDelayedCoRoutineList = NULL;           // 为NULL表示还没有初始化
+static List_t *pxOverflowDelayedCoRoutineList = NULL;
+static List_t xPendingReadyCoRoutineList;
+static CRCB_t *pxCurrentCoRoutine = NULL;
+static UBaseType_t uxTopCoRoutineReadyPriority = 0U;    // 可能有协程的最高就绪优先级，调度时往下找
+static TickType_t xCoRoutineTickCount = (TickType_t)configINITIAL_TICK_COUNT;  // 已经处理到的tick，追赶 xTaskGetTickCount()
+
+#define prvAddCoRoutineToReadyQueue(pxCRCB)                                                      \
+    do                                                                                           \
+    {                                                                                            \
+        if ((pxCRCB)->uxPriority > uxTopCoRoutineReadyPriority)                                  \
+        {                                                                                        \
+            uxTopCoRoutineReadyPriority = (pxCRCB)->uxPriority;                                  \
+        }                                                                                        \
+        vListInsertEnd(&(pxReadyCoRoutineLists[(pxCRCB)->uxPriority]), &((pxCRCB)->xGenericListItem)); \
+    } while (0)
+
+static void prvInitialiseCoRoutineLists(void)
+{
+    for (UBaseType_t uxPriority = 0U; uxPriority < (UBaseType_t)configMAX_CO_ROUTINE_PRIORITIES; uxPriority++)
+    {
+        vListInitialise(&(pxReadyCoRoutineLists[uxPriority]));
+    }
+    vListInitialise(&xDelayedCoRoutineList1);
+    vListInitialise(&xDelayedCoRoutineList2);
+    vListInitialise(&xPendingReadyCoRoutineList);
+    pxDelayedCoRoutineList = &xDelayedCoRoutineList1;
+    pxOverflowDelayedCoRoutineList = &xDelayedCoRoutineList2;
+}
+
+/* 创建协程，要在调度器启动前或在运行协程的任务中调用 */
+BaseType_t xCoRoutineCreateStatic(crCOROUTINE_CODE pxCoRoutineCode,
+                                  UBaseType_t uxPriority,
+                                  UBaseType_t uxIndex,
+                                  CRCB_t *const pxCoRoutineBuffer)
+{
+    CRCB_t *const pxCRCB = pxCoRoutineBuffer;
+
+    configASSERT(pxCRCB != NULL);
+    if (pxDelayedCoRoutineList == NULL)
+    {
+        prvInitialiseCoRoutineLists();
+    }
+    if (uxPriority >= (UBaseType_t)configMAX_CO_ROUTINE_PRIORITIES)
+    {
+        uxPriority = (UBaseType_t)configMAX_CO_ROUTINE_PRIORITIES - 1U;
+    }
+
+    pxCRCB->pxCoRoutineFunction = pxCoRoutineCode;
+    pxCRCB->uxPriority = (uint16_t)uxPriority;
+    pxCRCB->uxState = 0U;
+    pxCRCB->uxIndex = uxIndex;
+    vListInitialiseItem(&(pxCRCB->xGenericListItem));
+    vListInitialiseItem(&(pxCRCB->xEventListItem));
+    listSE_LIST_ITEM_OWNER(&(pxCRCB->xGenericListItem), pxCRCB);
+    listSE_LIST_ITEM_OWNER(&(pxCRCB->xEventListItem), pxCRCB);
+    // 等待链表按这个值从小到大排序，优先级越高越靠前
+    listSET_LIST_ITEM_VALUE(&(pxCRCB->xEventListItem), (TickType_t)configMAX_CO_ROUTINE_PRIORITIES - (TickType_t)uxPriority);
+
+    if (pxCurrentCoRoutine == NULL)
+    {
+        pxCurrentCoRoutine = pxCRCB;
+    }
+    prvAddCoRoutineToReadyQueue(pxCRCB);
+    return pdPASS;
+}
+
+/** 当前协程从就绪队列移到延时队列，pxEventList 不为NULL时同时挂到等待链表上（按优先级排序）
+ *  @note 挂到等待链表时必须在临界区中调用
+ */
+void vCoRoutineAddToDelayedList(TickType_t xTicksToDelay, List_t *const pxEventList)
+{
+    const TickType_t xTimeToWake = xCoRoutineTickCount + xTicksToDelay;
+
+    (void)uxListRemove(&(pxCurrentCoRoutine->xGenericListItem));
+    listSET_LIST_ITEM_VALUE(&(pxCurrentCoRoutine->xGenericListItem), xTimeToWake);
+    if (xTimeToWake < xCoRoutineTickCount)
+    {   // 唤醒时间溢出了
+        vListInsertBidirectional(pxOverflowDelayedCoRoutineList, &(pxCurrentCoRoutine->xGenericListItem));
+    }
+    else
+    {
+        vListInsertBidirectional(pxDelayedCoRoutineList, &(pxCurrentCoRoutine->xGenericListItem));
+    }
+
+    if (pxEventList != NULL)
+    {   // 同优先级先等待的排在前面
+        vListInsertBidirectional(pxEventList, &(pxCurrentCoRoutine->xEventListItem));
+    }
+}
+
+/** 唤醒等待链表中优先级最高的协程，挂到 xPendingReadyCoRoutineList，等下次调度移到就绪队列
+ *  @return 被唤醒的协程优先级不低于当前协程时返回 pdTRUE，当前协程应该让出
+ *  @note 必须在临界区中调用，等待链表不能为空
+ */
+BaseType_t xCoRoutineRemoveFromEventList(const List_t *const pxEventList)
+{
+    CRCB_t *const pxUnblockedCRCB = (CRCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxEventList);
+
+    (void)uxListRemove(&(pxUnblockedCRCB->xEventListItem));
+    vListInsertEnd(&xPendingReadyCoRoutineList, &(pxUnblockedCRCB->xEventListItem));
+    return (pxUnblockedCRCB->uxPriority >= pxCurrentCoRoutine->uxPriority) ? pdTRUE : pdFALSE;
+}
+
+/* 把中断与其他协程唤醒的协程从延时队列移到就绪队列 */
+static void prvCheckPendingReadyList(void)
+{
+    while (listLIST_IS_EMPTY(&xPendingReadyCoRoutineList) == pdFALSE)
+    {
+        CRCB_t *pxUnblockedCRCB;
+
+        taskENTER_CRITICAL();
+        {
+            pxUnblockedCRCB = (CRCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&xPendingReadyCoRoutineList);
+            (void)uxListRemove(&(pxUnblockedCRCB->xEventListItem));
+        }
+        taskEXIT_CRITICAL();
+
+        (void)uxListRemove(&(pxUnblockedCRCB->xGenericListItem));
+        prvAddCoRoutineToReadyQueue(pxUnblockedCRCB);
+    }
+}
+
+/* 追上任务的tick，逐个tick处理延时到期的协程，tick溢出时交换两个延时队列 */
+static void prvCheckDelayedList(void)
+{
+    const TickType_t xNow = xTaskGetTickCount();
+    TickType_t xPassedTicks = xNow - xCoRoutineTickCount;
+
+    if ((listLIST_IS_EMPTY(pxDelayedCoRoutineList) != pdFALSE) && (listLIST_IS_EMPTY(pxOverflowDelayedCoRoutineList) != pdFALSE))
+    {   // 没有延时的协程，直接跳到现在，比如调度器运行很久以后才创建协程
+        xCoRoutineTickCount = xNow;
+        return;
+    }
+    while (xPassedTicks != (TickType_t)0)
+    {
+        xCoRoutineTickCount++;
+        xPassedTicks--;
+        if (xCoRoutineTickCount == (TickType_t)0)
+        {
+            List_t *const pxTemp = pxDelayedCoRoutineList;
+            pxDelayedCoRoutineList = pxOverflowDelayedCoRoutineList;
+            pxOverflowDelayedCoRoutineList = pxTemp;
+        }
+
+        while (listLIST_IS_EMPTY(pxDelayedCoRoutineList) == pdFALSE)
+        {
+            CRCB_t *const pxCRCB = (CRCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedCoRoutineList);
+            if (xCoRoutineTickCount < listGET_LIST_ITEM_VALUE(&(pxCRCB->xGenericListItem)))
+            {
+                break;
+            }
+
+            // 等待队列超时：中断可能同时在操作它的等待链表节点
+            taskENTER_CRITICAL();
+            {
+                (void)uxListRemove(&(pxCRCB->xGenericListItem));
+                if (listIS_IN_ANY_LIST(&(pxCRCB->xEventListItem)) != pdFALSE)
+                {
+                    (void)uxListRemove(&(pxCRCB->xEventListItem));
+                }
+            }
+            taskEXIT_CRITICAL();
+            prvAddCoRoutineToReadyQueue(pxCRCB);
+        }
+    }
+}
+
+BaseType_t xCoRoutineSchedule(void)
+{
+    if (pxDelayedCoRoutineList == NULL)
+    {   // 还没有创建协程
+        return pdFALSE;
+    }
+
+    prvCheckPendingReadyList();
+    prvCheckDelayedList();
+
+    while (listLIST_IS_EMPTY(&(pxReadyCoRoutineLists[uxTopCoRoutineReadyPriority])) != pdFALSE)
+    {
+        if (uxTopCoRoutineReadyPriority == 0U)
+        {
+            return pdFALSE;
+        }
+        --uxTopCoRoutineReadyPriority;
+    }
+
+    // 同优先级的协程轮流运行，每次调度只运行一个，运行到下一个让出点返回
+    listGET_OWNER_OF_NEXT_ENTRY(pxCurrentCoRoutine, &(pxReadyCoRoutineLists[uxTopCoRoutineReadyPriority]));
+    (pxCurrentCoRoutine->pxCoRoutineFunction)(pxCurrentCoRoutine, pxCurrentCoRoutine->uxIndex);
+    return pdTRUE;
+}
+
+void vCoRoutineQueueInitialise(CoRoutineQueue_t *const pxQueue,
+                               const UBaseType_t uxLength,
+                               const UBaseType_t uxItemSize,
+                               uint8_t *const pucStorage)
+{
+    configASSERT((uxLength > 0U) && (pucStorage != NULL));
+    pxQueue->pucStorage = pucStorage;
+    pxQueue->uxLength = uxLength;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->uxMessagesWaiting = 0U;
+    pxQueue->uxReadIndex = 0U;
+    vListInitialise(&(pxQueue->xWaitingToSend));
+    vListInitialise(&(pxQueue->xWaitingToReceive));
+}
+
+/* 写到队尾，调用者保证队列没满 */
+static void prvCopyToQueue(CoRoutineQueue_t *const pxQueue, const void *const pvItemToQueue)
+{
+    const UBaseType_t uxWriteIndex = (pxQueue->uxReadIndex + pxQueue->uxMessagesWaiting) % pxQueue->uxLength;
+
+    (void)memcpy(&(pxQueue->pucStorage[uxWriteIndex * pxQueue->uxItemSize]), pvItemToQueue, (size_t)pxQueue->uxItemSize);
+    pxQueue->uxMessagesWaiting++;
+}
+
+/** 协程发送，crQUEUE_SEND 调用
+ *  @return pdPASS；errQUEUE_YIELD 表示发送成功且唤醒了不低于当前优先级的接收协程；
+ *          errQUEUE_BLOCKED 表示队列满，已经进入等待；errQUEUE_FULL 表示队列满且不等待
+ */
+BaseType_t xCoRoutineQueueSend(CoRoutineQueue_t *const pxQueue, const void *const pvItemToQueue, TickType_t xTicksToWait)
+{
+    BaseType_t xReturn;
+
+    taskENTER_CRITICAL();
+    {
+        if (pxQueue->uxMessagesWaiting == pxQueue->uxLength)
+        {
+            if (xTicksToWait > (TickType_t)0)
+            {
+                vCoRoutineAddToDelayedList(xTicksToWait, &(pxQueue->xWaitingToSend));
+                xReturn = errQUEUE_BLOCKED;
+            }
+            else
+            {
+                xReturn = errQUEUE_FULL;
+            }
+        }
+        else
+        {
+            prvCopyToQueue(pxQueue, pvItemToQueue);
+            xReturn = pdPASS;
+            if ((listLIST_IS_EMPTY(&(pxQueue->xWaitingToReceive)) == pdFALSE) &&
+                (xCoRoutineRemoveFromEventList(&(pxQueue->xWaitingToReceive)) != pdFALSE))
+            {
+                xReturn = errQUEUE_YIELD;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+/* 协程接收，crQUEUE_RECEIVE 调用，返回值与 xCoRoutineQueueSend 对应，队列空且不等待时返回 errQUEUE_EMPTY */
+BaseType_t xCoRoutineQueueReceive(CoRoutineQueue_t *const pxQueue, void *const pvBuffer, TickType_t xTicksToWait)
+{
+    BaseType_t xReturn;
+
+    taskENTER_CRITICAL();
+    {
+        if (pxQueue->uxMessagesWaiting == 0U)
+        {
+            if (xTicksToWait > (TickType_t)0)
+            {
+                vCoRoutineAddToDelayedList(xTicksToWait, &(pxQueue->xWaitingToReceive));
+                xReturn = errQUEUE_BLOCKED;
+            }
+            else
+            {
+                xReturn = errQUEUE_EMPTY;
+            }
+        }
+        else
+        {
+            (void)memcpy(pvBuffer, &(pxQueue->pucStorage[pxQueue->uxReadIndex * pxQueue->uxItemSize]), (size_t)pxQueue->uxItemSize);
+            pxQueue->uxReadIndex = (pxQueue->uxReadIndex + 1U) % pxQueue->uxLength;
+            pxQueue->uxMessagesWaiting--;
+            xReturn = pdPASS;
+            if ((listLIST_IS_EMPTY(&(pxQueue->xWaitingToSend)) == pdFALSE) &&
+                (xCoRoutineRemoveFromEventList(&(pxQueue->xWaitingToSend)) != pdFALSE))
+            {
+                xReturn = errQUEUE_YIELD;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+/* 中断发送，队列满时丢弃；每次中断最多唤醒一个协程，已经唤醒过就只写数据 */
+BaseType_t xCoRoutineQueueSendFromISR(CoRoutineQueue_t *const pxQueue, const void *const pvItemToQueue, BaseType_t xCoRoutinePreviouslyWoken)
+{
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+    {
+        prvCopyToQueue(pxQueue, pvItemToQueue);
+        if ((xCoRoutinePreviouslyWoken == pdFALSE) && (listLIST_IS_EMPTY(&(pxQueue->xWaitingToReceive)) == pdFALSE))
+        {
+            (void)xCoRoutineRemoveFromEventList(&(pxQueue->xWaitingToReceive));
+            xCoRoutinePreviouslyWoken = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return xCoRoutinePreviouslyWoken;
+}
+
+#endif /* configUSE_CO_ROUTINES */
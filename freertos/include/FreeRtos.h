@@ -4,13 +4,301 @@
 #include <stddef.h>     // 获取标准库的 NULL 和 size_t
 
 #include "freertos_config.h"
+
+/* 用户没有在freertos_config.h中设定的可选功能，默认关闭 */
+#ifndef configUSE_HIGH_RES_TIMER
+#define configUSE_HIGH_RES_TIMER 0
+#endif
+
+#ifndef configUSE_64_BIT_TICKS
+#define configUSE_64_BIT_TICKS 0
+#endif
+
+#ifndef configUSE_PREEMPTION_THRESHOLD
+#define configUSE_PREEMPTION_THRESHOLD 0
+#endif
+
+#ifndef configUSE_TASK_SWITCH_COUNTERS
+#define configUSE_TASK_SWITCH_COUNTERS 0
+#endif
+
+#ifndef configUSE_WAKE_LATENCY
+#define configUSE_WAKE_LATENCY 0
+#endif
+
+#ifndef configWAKE_LATENCY_BUCKETS
+#define configWAKE_LATENCY_BUCKETS 20
+#endif
+
+#ifndef configUSE_DIRECTED_YIELD
+#define configUSE_DIRECTED_YIELD 0
+#endif
+
+#ifndef configUSE_RENDEZVOUS_IPC
+#define configUSE_RENDEZVOUS_IPC 0
+#endif
+
+#ifndef configUSE_TASK_BUDGETS
+#define configUSE_TASK_BUDGETS 0
+#endif
+
+#ifndef configTASK_BUDGET_DEMOTED_PRIORITY
+#define configTASK_BUDGET_DEMOTED_PRIORITY 0
+#endif
+
+#ifndef configUSE_PRIORITY_AGING
+#define configUSE_PRIORITY_AGING 0
+#endif
+
+#ifndef configAGING_THRESHOLD_TICKS
+#define configAGING_THRESHOLD_TICKS 100
+#endif
+
+#ifndef configAGING_MAX_PRIORITY
+#define configAGING_MAX_PRIORITY (configMAX_PRIORITIES - 1)
+#endif
+
+#ifndef configNUMBER_OF_CORES
+#define configNUMBER_OF_CORES 1
+#endif
+
+#ifndef configUSE_STATIC_TASK_TABLE
+#define configUSE_STATIC_TASK_TABLE 0
+#endif
+
+#ifndef configUSE_TASK_NAMES
+#define configUSE_TASK_NAMES 1
+#endif
+
+#ifndef configUSE_8_BIT_PRIORITIES
+#define configUSE_8_BIT_PRIORITIES 0
+#endif
+
+#ifndef configUSE_LIST_INDEX_LINKS
+#define configUSE_LIST_INDEX_LINKS 0
+#endif
+
+#ifndef configUSE_READY_QUEUE_RINGS
+#define configUSE_READY_QUEUE_RINGS 0
+#endif
+
+#ifndef configREADY_QUEUE_RING_LENGTH
+#define configREADY_QUEUE_RING_LENGTH 8
+#endif
+
+#ifndef configUSE_CO_ROUTINES
+#define configUSE_CO_ROUTINES 0
+#endif
+
+#ifndef configMAX_CO_ROUTINE_PRIORITIES
+#define configMAX_CO_ROUTINE_PRIORITIES 2
+#endif
+
+#ifndef configUSE_QUEUES
+#define configUSE_QUEUES 0
+#endif
+
+#ifndef configUSE_QUEUE_SETS
+#define configUSE_QUEUE_SETS 0
+#endif
+
+#ifndef configUSE_MSGBUS
+#define configUSE_MSGBUS 0
+#endif
+
+#ifndef configUSE_ACTIVE_OBJECTS
+#define configUSE_ACTIVE_OBJECTS 0
+#endif
+
+#ifndef configUSE_BASIC_TASKS
+#define configUSE_BASIC_TASKS 0
+#endif
+
+#ifndef configUSE_IDLE_WORK_QUEUE
+#define configUSE_IDLE_WORK_QUEUE 0
+#endif
+
+#ifndef configUSE_IDLE_WFI
+#define configUSE_IDLE_WFI 0
+#endif
+
+#ifndef configUSE_TASK_DELETE
+#define configUSE_TASK_DELETE 0
+#endif
+
+#ifndef configINITIAL_TICK_COUNT
+#define configINITIAL_TICK_COUNT 0
+#endif
+
+#ifndef configUSE_SAMPLING_PROFILER
+#define configUSE_SAMPLING_PROFILER 0
+#endif
+
+#ifndef configPROFILER_SAMPLE_COUNT
+#define configPROFILER_SAMPLE_COUNT 1024
+#endif
+
+#ifndef configPROFILER_SAMPLE_IN_SYSTICK
+#define configPROFILER_SAMPLE_IN_SYSTICK 1
+#endif
+
+#ifndef configUSE_CRITICAL_TIMING
+#define configUSE_CRITICAL_TIMING 0
+#endif
+
+#ifndef configCRITICAL_TIMING_SITES
+#define configCRITICAL_TIMING_SITES 16
+#endif
+
+#ifndef configCRITICAL_TIMING_BUCKETS
+#define configCRITICAL_TIMING_BUCKETS 16
+#endif
+
+#ifndef configUSE_POST_MORTEM
+#define configUSE_POST_MORTEM 0
+#endif
+
+#ifndef configPOST_MORTEM_SWITCHES
+#define configPOST_MORTEM_SWITCHES 32
+#endif
+
+#ifndef configPOST_MORTEM_TASKS
+#define configPOST_MORTEM_TASKS 8
+#endif
+
+#ifndef configPOST_MORTEM_RESET
+#define configPOST_MORTEM_RESET 1
+#endif
 #include "projdefs.h"   //  必须在引入portable.h之前
 #include "portable.h"
 
+#ifndef portPOINTER_SIZE_TYPE
+#define portPOINTER_SIZE_TYPE uint32_t   // 与指针一样宽的整数类型，对齐栈顶指针时用
+#endif
+
+#if ((configUSE_STATIC_TASK_TABLE == 1) && (!defined(portSTATIC_STACK_FRAME) || (configNUMBER_OF_CORES > 1)))
+#error "静态任务表需要port提供 portSTATIC_STACK_FRAME（ARM_CM3、ARM_CM4F），且只支持单核"
+#endif
+
+#if (configNUMBER_OF_CORES > 1)
+#if !defined(portGET_CORE_ID) || !defined(portYIELD_CORE)
+#error "configNUMBER_OF_CORES 大于1 需要port提供 portGET_CORE_ID 与 portYIELD_CORE，目前只有 Posix port 支持"
+#endif
+#if ((configUSE_PREEMPTION_THRESHOLD == 1) || (configUSE_TASK_BUDGETS == 1) || (configUSE_PRIORITY_AGING == 1) || (configUSE_HIGH_RES_TIMER == 1))
+#error "多核模式暂不支持抢占阈值、CPU预算、优先级老化与高精度定时"
+#endif
+#if (configUSE_PORT_OPTIMISED_TASK_SELECTION == 0)
+#error "多核模式需要 configUSE_PORT_OPTIMISED_TASK_SELECTION 为 1"
+#endif
+#endif
+
+#if ((configUSE_LIST_INDEX_LINKS == 1) && !defined(portLIST_LINK_BASE))
+#error "configUSE_LIST_INDEX_LINKS 需要port提供 portLIST_LINK_BASE（ARM_CM3、ARM_CM4F）"
+#endif
+
+#if ((configUSE_READY_QUEUE_RINGS == 1) && ((configREADY_QUEUE_RING_LENGTH < 2) || ((configREADY_QUEUE_RING_LENGTH & (configREADY_QUEUE_RING_LENGTH - 1)) != 0)))
+#error "configREADY_QUEUE_RING_LENGTH 必须是2的幂"
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+#if (configNUMBER_OF_CORES > 1)
+#error "故障现场记录只支持单核"
+#endif
+#if ((configPOST_MORTEM_SWITCHES & (configPOST_MORTEM_SWITCHES - 1)) != 0)
+#error "configPOST_MORTEM_SWITCHES 必须是2的幂"
+#endif
+#if (configUSE_STATIC_TASK_TABLE == 1)
+#error "故障现场记录的栈水位要在创建任务时填充栈，不支持静态任务表"
+#endif
+#endif
+
+#if ((configUSE_WAKE_LATENCY == 1) && ((configWAKE_LATENCY_BUCKETS < 1) || (configWAKE_LATENCY_BUCKETS > 32)))
+#error "configWAKE_LATENCY_BUCKETS 必须在 1 到 32 之间"
+#endif
+
+#if ((configUSE_8_BIT_PRIORITIES == 1) && (configMAX_PRIORITIES > 256))
+#error "configUSE_8_BIT_PRIORITIES 要求 configMAX_PRIORITIES 不超过256"
+#endif
+
+#if ((configUSE_64_BIT_TICKS == 1) && (configUSE_16_BIT_TICKS == 1))
+#error "configUSE_64_BIT_TICKS 与 configUSE_16_BIT_TICKS 只能选一个"
+#endif
+
+#if ((configUSE_HIGH_RES_TIMER == 1) && (configUSE_16_BIT_TICKS == 1))
+#error "configUSE_HIGH_RES_TIMER 需要把高精度唤醒时间存在 xItemValue 中，不能与16位tick同时使用"
+#endif
+
+#if ((configUSE_TASK_DELETE == 1) && (configSUPPORT_STATIC_ALLOCATION == 0))
+#error "configUSE_TASK_DELETE 的复用池放的是静态分配的TCB与栈，需要 configSUPPORT_STATIC_ALLOCATION"
+#endif
+
+// 任务被删除、内存回收之前由port清理，Posix port 要让任务的线程退出
+#ifndef portCLEAN_UP_TCB
+#define portCLEAN_UP_TCB(pxTCB) (void)(pxTCB)
+#endif
+
+#if ((configUSE_RENDEZVOUS_IPC == 1) && ((configUSE_TASK_BUDGETS == 1) || (configUSE_PRIORITY_AGING == 1)))
+#error "同步IPC的优先级继承直接修改 uxPriority，预算补充与老化恢复会把它改回基础优先级，暂不能同时使用"
+#endif
+
+#if ((configUSE_QUEUE_SETS == 1) && (configUSE_QUEUES == 0))
+#error "configUSE_QUEUE_SETS 需要 configUSE_QUEUES"
+#endif
+
+#if ((configUSE_MSGBUS == 1) && (configUSE_QUEUES == 0))
+#error "消息总线的阻塞等待用的是队列的内核事件链表与超时接口，configUSE_MSGBUS 需要 configUSE_QUEUES"
+#endif
+
+#if ((configUSE_ACTIVE_OBJECTS == 1) && (configUSE_MSGBUS == 0))
+#error "活动对象的事件从消息总线的缓冲池分配，configUSE_ACTIVE_OBJECTS 需要 configUSE_MSGBUS"
+#endif
+
+#if (configUSE_SAMPLING_PROFILER == 1)
+#if !defined(portPROFILER_STACKED_PC_INDEX) || (configNUMBER_OF_CORES > 1)
+#error "采样剖析需要port提供 portPROFILER_STACKED_PC_INDEX（ARM_CM3、ARM_CM4F），且只支持单核"
+#endif
+#if ((configPROFILER_SAMPLE_COUNT & (configPROFILER_SAMPLE_COUNT - 1)) != 0)
+#error "configPROFILER_SAMPLE_COUNT 必须是2的幂"
+#endif
+#if ((configUSE_HIGH_RES_TIMER == 1) && (configPROFILER_SAMPLE_IN_SYSTICK == 1))
+#error "高精度定时下SysTick是单次定时，间隔不均匀，采样会有偏差，请用专用定时器采样（configPROFILER_SAMPLE_IN_SYSTICK 为0）"
+#endif
+#endif
+
+#if (configUSE_CRITICAL_TIMING == 1)
+#if !defined(portPROFILER_STACKED_PC_INDEX) || (configNUMBER_OF_CORES > 1)
+#error "屏蔽中断时长统计需要 DWT CYCCNT（ARM_CM3、ARM_CM4F），且只支持单核"
+#endif
+#if ((configCRITICAL_TIMING_SITES & (configCRITICAL_TIMING_SITES - 1)) != 0)
+#error "configCRITICAL_TIMING_SITES 必须是2的幂"
+#endif
+#if ((configCRITICAL_TIMING_BUCKETS < 1) || (configCRITICAL_TIMING_BUCKETS > 32))
+#error "configCRITICAL_TIMING_BUCKETS 必须在 1 到 32 之间"
+#endif
+#endif
+
+#if ((configUSE_BASIC_TASKS == 1) && (configSUPPORT_STATIC_ALLOCATION == 0))
+#error "configUSE_BASIC_TASKS 的分发任务用 xTaskCreateStatic 创建，需要 configSUPPORT_STATIC_ALLOCATION"
+#endif
+
+/* TCB中的优先级类型，task.c 与 StaticTask_t 共用 */
+#if (configUSE_8_BIT_PRIORITIES == 1)
+typedef uint8_t TaskPriority_t;
+#else
+typedef UBaseType_t TaskPriority_t;
+#endif
+
+/** 以下结构体与 list.h 中的 ListItem_t、task.c 中的 TCB_t 成员类型与顺序一一对应，大小与对齐完全一样，
+ *  用户用它们静态分配内存而看不到内部成员，TCB_t 增减成员时要同步修改
+ */
 struct xSTATIC_LIST_ITEM
 {
     TickType_t xDummy2;
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    uint16_t usDummy3[4];
+    #else
     void * pvDummy3[4];
+    #endif
 };
 typedef struct xSTATIC_LIST_ITEM StaticListItem_t;
 
@@ -18,10 +306,40 @@ typedef struct xSTATIC_TCB
 {
     void * pxDummy1;
     StaticListItem_t xDummy3[2];
-    UBaseType_t uxDummy5;
     void * pxDummy6;
+    TaskPriority_t uxDummy5;
+    #if (configUSE_PREEMPTION_THRESHOLD == 1)
+    TaskPriority_t uxDummy9;
+    #endif
+    #if ((configUSE_TASK_BUDGETS == 1) || (configUSE_PRIORITY_AGING == 1))
+    TaskPriority_t uxDummy13;
+    #endif
+    #if (configUSE_TASK_NAMES == 1)
     uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
-    uint32_t uxDummy8;
+    #endif
+    #if (configUSE_TASK_BUDGETS == 1)
+    TickType_t xDummy10[4];
+    UBaseType_t uxDummy11;
+    void * pxDummy12;
+    #endif
+    #if (configUSE_PRIORITY_AGING == 1)
+    TickType_t xDummy14;
+    #endif
+    #if (configNUMBER_OF_CORES > 1)
+    BaseType_t xDummy15;
+    UBaseType_t uxDummy16;
+    #endif
+    #if (configUSE_TASK_DELETE == 1)
+    UBaseType_t uxDummy17;
+    #endif
+    #if (configUSE_RENDEZVOUS_IPC == 1)
+    void * pvDummy18[2];
+    #endif
+    #if (configUSE_WAKE_LATENCY == 1)
+    HighResTime_t xDummy19;
+    BaseType_t xDummy20;
+    uint32_t ulDummy21[3 + configWAKE_LATENCY_BUCKETS];
+    #endif
 } StaticTask_t;
 
 #endif
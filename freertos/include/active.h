@@ -0,0 +1,88 @@
+#ifndef ACTIVE_H
+#define ACTIVE_H
+
+#include "msgbus.h"
+
+/** 活动对象（active object）
+ *  每个活动对象有一个事件队列和一个分发函数，分发函数每次处理一个事件，运行到返回，中间不阻塞；
+ *  状态放在对象里，不再写 for(;;) 里轮询 flag 的事件循环。
+ *  活动对象挂在宿主任务上运行：一个宿主任务可以只有一个对象，也可以有多个对象共用一个宿主任务的栈，
+ *  宿主任务每次取出 uxPriority 最高、队列不空的对象的一个事件分发，同一宿主中对象之间的切换只是函数调用，
+ *  不经过任务切换；没有事件时宿主任务阻塞在内核事件链表上。
+ *  事件从消息总线的缓冲池（msgbus.h）中分配，发送后不能再修改；同一个事件可以发送给多个对象，
+ *  每个队列中的事件占一个引用，分发函数返回后释放，最后一个释放时回到缓冲池
+ */
+#if (configUSE_ACTIVE_OBJECTS == 1)
+
+/* 事件头，用户事件结构体的第一个成员 */
+typedef struct xACTIVE_EVENT
+{
+    UBaseType_t uxSignal;
+} ActiveEvent_t;
+
+struct xACTIVE_OBJECT;
+/* 分发函数，在宿主任务中调用，不能阻塞；pxEvent 只读，返回后由宿主释放 */
+typedef void (*ActiveDispatch_t)(struct xACTIVE_OBJECT *const pxObject, const ActiveEvent_t *const pxEvent);
+
+typedef struct xACTIVE_HOST
+{
+    struct xACTIVE_OBJECT *pxObjects;       // 按 uxPriority 从高到低排列
+    List_t xHostWaiting;                    // 没有事件时宿主任务在这里等待
+    volatile UBaseType_t uxDispatched;      // 已分发的事件数
+} ActiveHost_t;
+
+/* 活动对象，用户对象把它作为第一个成员，分发函数中转换回用户对象 */
+typedef struct xACTIVE_OBJECT
+{
+    struct xACTIVE_OBJECT *pxNext;
+    ActiveHost_t *pxHost;
+    ActiveDispatch_t pxDispatch;
+    UBaseType_t uxPriority;                 // 同一宿主中分发的先后，数值大的先分发
+    const ActiveEvent_t **ppxQueue;         // 事件队列
+    UBaseType_t uxLength;
+    volatile UBaseType_t uxWaiting;
+    UBaseType_t uxReadIndex;
+    UBaseType_t uxWriteIndex;
+    UBaseType_t uxMaxWaiting;               // 队列中事件数的最高值，用来确定队列长度
+} ActiveObject_t;
+
+/* 初始化宿主，之后用 vActiveHostTask 作为任务函数、宿主作为参数创建宿主任务 */
+void vActiveHostInitialise(ActiveHost_t *const pxHost);
+
+/* 宿主任务函数，pvParameters 是 ActiveHost_t * */
+void vActiveHostTask(void *pvParameters);
+
+/**
+ * @brief 创建活动对象，挂到宿主上，必须在宿主任务开始运行之前或者在同一宿主的分发函数中调用
+ *
+ * @param pxObject 活动对象
+ * @param pxHost 宿主
+ * @param pxDispatch 分发函数
+ * @param uxPriority 同一宿主中的优先级，与任务优先级无关
+ * @param ppxQueueStorage 事件队列，uxQueueLength 个 const ActiveEvent_t *
+ * @param uxQueueLength 队列长度
+ */
+void vActiveObjectCreate(ActiveObject_t *const pxObject,
+                         ActiveHost_t *const pxHost,
+                         ActiveDispatch_t pxDispatch,
+                         UBaseType_t uxPriority,
+                         const ActiveEvent_t **const ppxQueueStorage,
+                         const UBaseType_t uxQueueLength);
+
+/**
+ * @brief 从缓冲池分配事件，没有空闲时最多等待 xTicksToWait 个tick
+ * @return 事件，引用计数为1，属于调用者；超时返回NULL
+ */
+ActiveEvent_t *pxActiveEventAlloc(MsgPool_t *const pxPool, const UBaseType_t uxSignal, TickType_t xTicksToWait);
+
+/**
+ * @brief 发送事件，调用者的引用随之交给对象的队列，发送给多个对象时先 vMsgBusRetain
+ * @return pdPASS；队列满时返回 pdFAIL，事件的引用被释放
+ */
+BaseType_t xActivePost(ActiveObject_t *const pxObject, const ActiveEvent_t *const pxEvent);
+/* 中断中发送，唤醒了需要切换的任务时 *pxHigherPriorityTaskWoken 置为 pdTRUE */
+BaseType_t xActivePostFromISR(ActiveObject_t *const pxObject, const ActiveEvent_t *const pxEvent, BaseType_t *const pxHigherPriorityTaskWoken);
+
+#endif /* configUSE_ACTIVE_OBJECTS */
+
+#endif
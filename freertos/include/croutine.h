@@ -0,0 +1,159 @@
+#ifndef CROUTINE_H
+#define CROUTINE_H
+
+#include "list.h"
+
+/** 无栈协程
+ *  协程函数每次被调度都从头开始执行，crSTART 里的 switch 按上次记下的行号直接跳到上次让出的位置继续（Duff's device），
+ *  所以协程没有自己的栈：局部变量在让出后不保留，需要保留的状态放在 static 变量或 uxIndex 区分的数组里，
+ *  crDELAY、crQUEUE_SEND、crQUEUE_RECEIVE 只能直接写在协程函数中，不能写在它调用的函数里，也不能写在 switch 语句中。
+ *  所有协程在调用 xCoRoutineSchedule() 的那个任务中运行，共用这个任务的栈；就绪与延时队列和任务一样用 List_t，
+ *  每个协程只需要一个控制块（Cortex-M3 上52字节，16位下标链表时36字节），没有栈
+ */
+#if (configUSE_CO_ROUTINES == 1)
+
+typedef void *CoRoutineHandle_t;
+typedef void (*crCOROUTINE_CODE)(CoRoutineHandle_t xHandle, UBaseType_t uxIndex);
+
+/** 协程控制块，由用户静态分配
+ *  @param xGenericListItem 挂在就绪/延时队列上
+ *  @param xEventListItem 挂在队列的等待链表上
+ *  @param uxState 上次让出时记下的位置，0表示从头开始
+ */
+typedef struct corCoRoutineControlBlock
+{
+    crCOROUTINE_CODE pxCoRoutineFunction;
+    ListItem_t xGenericListItem;
+    ListItem_t xEventListItem;
+    uint16_t uxPriority;
+    uint16_t uxState;
+    UBaseType_t uxIndex;            // 传给协程函数，多个协程共用一个函数时区分自己
+} CRCB_t;
+
+/** 协程间的队列，数据按值拷贝，存储区由用户提供
+ *  也可以在中断中用 crQUEUE_SEND_FROM_ISR 向协程发送
+ */
+typedef struct corCoRoutineQueue
+{
+    uint8_t *pucStorage;            // uxLength * uxItemSize 字节
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    UBaseType_t uxMessagesWaiting;
+    UBaseType_t uxReadIndex;        // 下一个要读出的元素
+    List_t xWaitingToSend;          // 按优先级排序，等待队列有空位的协程
+    List_t xWaitingToReceive;       // 按优先级排序，等待队列有数据的协程
+} CoRoutineQueue_t;
+
+/**
+ * @brief 创建协程
+ *
+ * @param pxCoRoutineCode 协程函数
+ * @param uxPriority 优先级，大于等于 configMAX_CO_ROUTINE_PRIORITIES 时按最高优先级处理
+ * @param uxIndex 传给协程函数的参数
+ * @param pxCoRoutineBuffer 协程控制块
+ * @return pdPASS
+ */
+BaseType_t xCoRoutineCreateStatic(crCOROUTINE_CODE pxCoRoutineCode,
+                                  UBaseType_t uxPriority,
+                                  UBaseType_t uxIndex,
+                                  CRCB_t *const pxCoRoutineBuffer);
+
+/**
+ * @brief 运行一次协程调度：处理中断唤醒的协程与到期的延时，然后运行优先级最高的就绪协程一次
+ *
+ * @return 运行了协程返回 pdTRUE；没有就绪协程时返回 pdFALSE，调用它的任务可以 vTaskDelay(1)，下一个tick再来
+ * @note 只能在一个任务中调用，协程在这个任务里运行
+ */
+BaseType_t xCoRoutineSchedule(void);
+
+/* 初始化协程队列，pucStorage 至少 uxLength * uxItemSize 字节 */
+void vCoRoutineQueueInitialise(CoRoutineQueue_t *const pxQueue,
+                               const UBaseType_t uxLength,
+                               const UBaseType_t uxItemSize,
+                               uint8_t *const pucStorage);
+
+/* 以下函数供宏使用，不要直接调用 */
+void vCoRoutineAddToDelayedList(TickType_t xTicksToDelay, List_t *const pxEventList);
+BaseType_t xCoRoutineRemoveFromEventList(const List_t *const pxEventList);
+BaseType_t xCoRoutineQueueSend(CoRoutineQueue_t *const pxQueue, const void *const pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t xCoRoutineQueueReceive(CoRoutineQueue_t *const pxQueue, void *const pvBuffer, TickType_t xTicksToWait);
+BaseType_t xCoRoutineQueueSendFromISR(CoRoutineQueue_t *const pxQueue, const void *const pvItemToQueue, BaseType_t xCoRoutinePreviouslyWoken);
+
+/* 协程函数的开头与结尾，中间的代码放在 crSTART 与 crEND 之间 */
+#define crSTART(xHandle) \
+    switch (((CRCB_t *)(xHandle))->uxState) \
+    {                                       \
+    case 0:
+#define crEND() }
+
+/* 记下位置并返回，下次从 case 标号处继续；一行最多两个让出点，所以每行用行号的两倍和两倍加一 */
+#define crSET_STATE0(xHandle)                                   \
+    ((CRCB_t *)(xHandle))->uxState = (uint16_t)(__LINE__ * 2);  \
+    return;                                                     \
+    case (__LINE__ * 2):
+#define crSET_STATE1(xHandle)                                       \
+    ((CRCB_t *)(xHandle))->uxState = (uint16_t)((__LINE__ * 2) + 1); \
+    return;                                                         \
+    case ((__LINE__ * 2) + 1):
+
+/**
+ * @brief 协程延时
+ * @param xHandle 协程函数的第一个参数
+ * @param xTicksToDelay 延时tick数，0时只让出一次
+ */
+#define crDELAY(xHandle, xTicksToDelay)                           \
+    if ((xTicksToDelay) > 0)                                      \
+    {                                                             \
+        vCoRoutineAddToDelayedList((xTicksToDelay), NULL);        \
+    }                                                             \
+    crSET_STATE0((xHandle));
+
+/**
+ * @brief 向协程队列发送，队列满时最多等待 xTicksToWait 个tick
+ * @param pxResult 结果：pdPASS，或等待超时的 errQUEUE_FULL
+ */
+#define crQUEUE_SEND(xHandle, pxQueue, pvItemToQueue, xTicksToWait, pxResult)           \
+    {                                                                                   \
+        *(pxResult) = xCoRoutineQueueSend((pxQueue), (pvItemToQueue), (xTicksToWait));  \
+        if (*(pxResult) == errQUEUE_BLOCKED)                                            \
+        {                                                                               \
+            crSET_STATE0((xHandle));                                                    \
+            *(pxResult) = xCoRoutineQueueSend((pxQueue), (pvItemToQueue), 0);           \
+        }                                                                               \
+        if (*(pxResult) == errQUEUE_YIELD)                                              \
+        {                                                                               \
+            crSET_STATE1((xHandle));                                                    \
+            *(pxResult) = pdPASS;                                                       \
+        }                                                                               \
+    }
+
+/**
+ * @brief 从协程队列接收，队列空时最多等待 xTicksToWait 个tick
+ * @param pxResult 结果：pdPASS，或等待超时的 errQUEUE_EMPTY
+ */
+#define crQUEUE_RECEIVE(xHandle, pxQueue, pvBuffer, xTicksToWait, pxResult)             \
+    {                                                                                   \
+        *(pxResult) = xCoRoutineQueueReceive((pxQueue), (pvBuffer), (xTicksToWait));    \
+        if (*(pxResult) == errQUEUE_BLOCKED)                                            \
+        {                                                                               \
+            crSET_STATE0((xHandle));                                                    \
+            *(pxResult) = xCoRoutineQueueReceive((pxQueue), (pvBuffer), 0);             \
+        }                                                                               \
+        if (*(pxResult) == errQUEUE_YIELD)                                              \
+        {                                                                               \
+            crSET_STATE1((xHandle));                                                    \
+            *(pxResult) = pdPASS;                                                       \
+        }                                                                               \
+    }
+
+/**
+ * @brief 在中断中向协程队列发送，队列满时直接丢弃
+ * @param xCoRoutinePreviouslyWoken 同一次中断中第一次调用传 pdFALSE，之后传上一次的返回值，每次中断最多唤醒一个协程
+ * @return 唤醒了协程返回 pdTRUE
+ */
+#define crQUEUE_SEND_FROM_ISR(pxQueue, pvItemToQueue, xCoRoutinePreviouslyWoken) \
+    xCoRoutineQueueSendFromISR((pxQueue), (pvItemToQueue), (xCoRoutinePreviouslyWoken))
+
+#endif /* configUSE_CO_ROUTINES */
+
+#endif
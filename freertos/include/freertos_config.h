@@ -9,19 +9,71 @@
 // 任务栈最小长度
 #define configMINIMAL_STACK_SIZE 128             
 #define configMAX_TASK_NAME_LEN (16)             // 任务名称最长长度
+#define configUSE_TASK_NAMES 1                   // TCB中保存任务名，为0时不保存，每个任务省下 configMAX_TASK_NAME_LEN 字节
+#define configUSE_8_BIT_PRIORITIES 0             // TCB中的优先级（含阈值、基础优先级）用uint8_t保存，与任务名挨在一起不留空隙
+#define configUSE_LIST_INDEX_LINKS 0             // 链表节点中的指针换成16位下标，需要port提供 portLIST_LINK_BASE
 #define configMAX_PRIORITIES 5                   // 任务队列允许的优先级数量
+#define configUSE_READY_QUEUE_RINGS 0            // 每个优先级的就绪队列用TCB指针环形数组代替链表，选择与轮转只是下标运算
+#define configREADY_QUEUE_RING_LENGTH 8          // 就绪环的长度，即每个优先级最多的就绪任务数，必须是2的幂
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY 191 // 临界区时，允许中断优先级数>=11被屏蔽 191=0b10111111，高四位为11
 
 
 #define configUSE_PREEMPTION 1
+#define configNUMBER_OF_CORES 1             // 核数，大于1时每个核有自己的就绪队列，需要port支持（目前是Posix port）
 #define configUSE_TIME_SLICING 1
+#define configUSE_PREEMPTION_THRESHOLD 0    // 任务抢占阈值，只有优先级高于运行任务阈值的任务才能抢占它
+#define configUSE_TASK_SWITCH_COUNTERS 0    // 统计任务切换请求与实际切换次数
+#define configUSE_WAKE_LATENCY 0            // 统计每个任务从被唤醒（加入就绪队列）到切入运行的延迟，用高精度时间计
+#define configWAKE_LATENCY_BUCKETS 20       // 每个任务的延迟直方图桶数，按2的幂分桶，最后一个桶包括更长的
+#define configUSE_DIRECTED_YIELD 0          // 定向让出 vTaskYieldTo：直接切到指定的同优先级或低优先级就绪任务，不再选择
+#define configUSE_RENDEZVOUS_IPC 0          // 同步IPC：调用/接收/回复，消息直接拷到对方缓冲区，接收者服务期间继承调用者优先级
+#define configUSE_TASK_BUDGETS 0            // 任务CPU预算，每个补充周期内最多运行若干tick，用完后阻塞或降级
+#define configTASK_BUDGET_DEMOTED_PRIORITY 0 // 预算用完选择降级时，降到的优先级
+#define configUSE_PRIORITY_AGING 0          // 优先级老化，就绪却长时间得不到运行的任务临时提升优先级
+#define configAGING_THRESHOLD_TICKS 100     // 就绪后多少个tick没有运行就提升
+#define configAGING_MAX_PRIORITY (configMAX_PRIORITIES - 1) // 老化提升的最高优先级
+#define configUSE_CO_ROUTINES 0              // 无栈协程，很多个协程在一个任务中轮流运行，共用这个任务的栈
+#define configMAX_CO_ROUTINE_PRIORITIES 2    // 协程优先级数量
+#define configUSE_QUEUES 0                   // 任务间的队列与信号量（queue.h、semphr.h），可以阻塞等待，带超时
+#define configUSE_QUEUE_SETS 0               // 队列集合：一个任务同时等待多个队列与信号量，返回有数据的那个
+#define configUSE_MSGBUS 0                   // 零拷贝发布/订阅消息总线（msgbus.h），消息在引用计数的缓冲池中，订阅者只收指针
+#define configUSE_ACTIVE_OBJECTS 0           // 活动对象（active.h）：事件队列加运行到结束的分发函数，多个对象可以共用一个宿主任务
+#define configUSE_BASIC_TASKS 0              // 基本任务：运行到结束、不会阻塞的函数，同优先级的基本任务共用一个分发任务的栈
+#define configUSE_IDLE_WORK_QUEUE 0          // 空闲工作队列：低优先级的后台工作由空闲任务分片执行，不用为它们单独创建任务
+#define configUSE_IDLE_WFI 0                 // 空闲任务没有后台工作时执行WFI休眠，直到下一个中断
 #define configUSE_16_BIT_TICKS 0          // 允许使用32位时间片
+#define configUSE_64_BIT_TICKS 0          // 使用64位tick，永不溢出，只需要一个延时队列
+#define configINITIAL_TICK_COUNT 0        // 调度器启动时xTickCount的初值，调成接近溢出的值可以测试溢出处理
 #define configSUPPORT_STATIC_ALLOCATION 1 // 允许使用静态内存分配
+#define configUSE_TASK_DELETE 0           // 任务删除，删除后TCB与栈放入复用池，xTaskCreate 从池中取，自删除的任务由空闲任务回收
+#define configUSE_STATIC_TASK_TABLE 0     // 静态任务表，TCB与初始栈帧在编译时生成，启动时不再调用 xTaskCreateStatic
+// 静态任务表，每一项 X(名字, 任务函数, 参数, 栈深度(字), 优先级)，参数只能是常量，句柄为 xStaticTaskHandle_名字
+#define configSTATIC_TASK_TABLE(X)
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 1 // 允许使用cortex-m3相关寄存器优化的任务选择
 #define xPortPendSVHandler PendSV_Handler // 同中断向量表一样的名字
 #define xPortSysTickHandler SysTick_Handler
 #define vPortSVCHandler SVC_Handler
 
+// 高精度定时：用DWT周期计数器作时间基准，SysTick改为单次定时，支持微秒级唤醒，tick只作为粗粒度时间基准
+#define configUSE_HIGH_RES_TIMER 0
+
+// 采样剖析：周期中断中记录被打断任务的PC与TCB，tools/profile_flamegraph.py 生成火焰图，只支持 ARM_CM3、ARM_CM4F
+#define configUSE_SAMPLING_PROFILER 0
+#define configPROFILER_SAMPLE_COUNT 1024  // 环形缓冲区的样本数，必须是2的幂，每个样本8字节
+#define configPROFILER_SAMPLE_IN_SYSTICK 1 // 在SysTick中采样；为0时由用户的专用定时器中断调用 vPortProfilerSample()
+
+// 屏蔽中断时长统计：临界区、SysTick、PendSV 屏蔽中断的最长时间与直方图，按调用点区分，只支持 ARM_CM3、ARM_CM4F
+#define configUSE_CRITICAL_TIMING 0
+#define configCRITICAL_TIMING_SITES 16     // 调用点表的大小，必须是2的幂
+#define configCRITICAL_TIMING_BUCKETS 16   // 每个调用点的直方图桶数，按2的幂分桶，16个桶到 32768 个周期以上
+
+// 故障现场记录：.bss.noinit 中的切换环、HardFault 时的寄存器与栈水位，复位后解码，只支持 ARM_CM3、ARM_CM4F
+#define configUSE_POST_MORTEM 0
+#define configPOST_MORTEM_SWITCHES 32      // 切换环的项数，必须是2的幂，每项8字节
+#define configPOST_MORTEM_TASKS 8          // 记录栈水位的任务数，创建的任务更多时后面的不记
+#define configPOST_MORTEM_RESET 1          // 记录后复位；为0时停在 HardFault 中等调试器
+#define xPortHardFaultHandler HardFault_Handler
+
 // 确认x是否为真。当x为假时，会调用configASSERT()，会调用taskDISABLE_INTERRUPTS()，然后进入死循环，不会返回
 #define configASSERT(x)           \
     if ((x) == 0)                 \
@@ -3,6 +3,29 @@
 #include "FreeRtos.h"
 #include "portmacro.h"
 
+#if (configUSE_LIST_INDEX_LINKS == 1)
+/** 压缩链接：节点中的指针换成16位下标，下标 = (地址 - portLIST_LINK_BASE) >> listLINK_SHIFT
+ *  链表、节点与节点的所属者都必须在 portLIST_LINK_BASE 之后 0xffff << listLINK_SHIFT 字节之内（一般就是整个SRAM），
+ *  下标0表示NULL，所以 portLIST_LINK_BASE 比SRAM起始地址小一个对齐单位；
+ *  每次访问多一次移位加法，换来一个节点从5个字变成3个字
+ */
+typedef uint16_t ListLink_t;
+#if (configUSE_16_BIT_TICKS == 1)
+#define listLINK_SHIFT 1U   // 16位tick时节点只按2字节对齐
+#else
+#define listLINK_SHIFT 2U
+#endif
+#define listLINK_NULL ((ListLink_t)0U)
+#define listLINK_FROM_PTR(pv) \
+    ((ListLink_t)(((portPOINTER_SIZE_TYPE)(pv) - (portPOINTER_SIZE_TYPE)portLIST_LINK_BASE) >> listLINK_SHIFT))
+#define listPTR_FROM_LINK(xLink) \
+    ((void *)((portPOINTER_SIZE_TYPE)portLIST_LINK_BASE + ((portPOINTER_SIZE_TYPE)(xLink) << listLINK_SHIFT)))
+// 地址能否用下标表示，初始化链表与节点时检查
+#define listLINK_IN_RANGE(pv)                                                           \
+    (((portPOINTER_SIZE_TYPE)(pv) > (portPOINTER_SIZE_TYPE)portLIST_LINK_BASE) &&       \
+     ((((portPOINTER_SIZE_TYPE)(pv) - (portPOINTER_SIZE_TYPE)portLIST_LINK_BASE) >> listLINK_SHIFT) <= 0xffffU))
+#endif
+
 /*
  * @brief 双向链表节点
  * 描述:
@@ -10,14 +33,22 @@
  * v：void
  * p：指针
  * pv： void*
+ * us：uint16_t，压缩链接时的下标
  */
 typedef struct xLIST_ITEM
 {
     TickType_t xItemValue;         // 辅助值，用于排序
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    ListLink_t usNext;
+    ListLink_t usPrevious;
+    ListLink_t usOwner;
+    ListLink_t usContainer;
+    #else
     struct xLIST_ITEM *pxNext;     // 指向下一个节点
     struct xLIST_ITEM *pxPrevious; // 指向前一个节点
     void *pvOwner;                 // 节点所属者
     void *pvContainer;             // 节点所属的链表
+    #endif
 } ListItem_t;
 
 /*
@@ -27,8 +58,13 @@ typedef struct xLIST_ITEM
 typedef struct xMINI_LIST_ITEM
 {
     TickType_t xItemValue;
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    ListLink_t usNext;
+    ListLink_t usPrevious;
+    #else
     struct xLIST_ITEM *pxNext;
     struct xLIST_ITEM *pxPrevious;
+    #endif
 } MiniListItem_t;
 
 /*
@@ -42,24 +78,63 @@ typedef struct xMINI_LIST_ITEM
 typedef struct xLIST
 {
     UBaseType_t uxNumberOfItems;
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    ListLink_t usIndex;
+    #else
     ListItem_t *pxIndex;     // 遍历链表的“游标”，初始指向 xListEnd，但可以在遍历时移动。
+    #endif
     MiniListItem_t xListEnd; // 哨兵节点，作为链表的边界标记，保证链表始终有头有尾，便于操作。
 } List_t;
 
+/** 节点与链表中链接的读写，压缩链接时在下标与指针之间转换，链表代码只通过它们访问链接
+ *  xListEnd 是 MiniListItem_t，前三个成员与 ListItem_t 一样，也可以用 NEXT/PREVIOUS
+ */
+#if (configUSE_LIST_INDEX_LINKS == 1)
+#define listGET_PREVIOUS(pxListItem) ((ListItem_t *)listPTR_FROM_LINK((pxListItem)->usPrevious))
+#define listSET_NEXT(pxListItem, pxNextItem) ((pxListItem)->usNext = listLINK_FROM_PTR(pxNextItem))
+#define listSET_PREVIOUS(pxListItem, pxPreviousItem) ((pxListItem)->usPrevious = listLINK_FROM_PTR(pxPreviousItem))
+#define listGET_CONTAINER(pxListItem) ((List_t *)listPTR_FROM_LINK((pxListItem)->usContainer))
+#define listSET_CONTAINER(pxListItem, pxList) ((pxListItem)->usContainer = listLINK_FROM_PTR(pxList))
+#define listCLEAR_CONTAINER(pxListItem) ((pxListItem)->usContainer = listLINK_NULL)
+#define listIS_IN_ANY_LIST(pxListItem) ((BaseType_t)((pxListItem)->usContainer != listLINK_NULL))   // 空下标解码后不是NULL，不能用 listGET_CONTAINER 判断
+#define listGET_INDEX(pxList) ((ListItem_t *)listPTR_FROM_LINK((pxList)->usIndex))
+#define listSET_INDEX(pxList, pxListItem) ((pxList)->usIndex = listLINK_FROM_PTR(pxListItem))
+#else
+#define listGET_PREVIOUS(pxListItem) ((pxListItem)->pxPrevious)
+#define listSET_NEXT(pxListItem, pxNextItem) ((pxListItem)->pxNext = (ListItem_t *)(pxNextItem))
+#define listSET_PREVIOUS(pxListItem, pxPreviousItem) ((pxListItem)->pxPrevious = (ListItem_t *)(pxPreviousItem))
+#define listGET_CONTAINER(pxListItem) ((List_t *)(pxListItem)->pvContainer)
+#define listSET_CONTAINER(pxListItem, pxList) ((pxListItem)->pvContainer = (void *)(pxList))
+#define listCLEAR_CONTAINER(pxListItem) ((pxListItem)->pvContainer = NULL)
+#define listIS_IN_ANY_LIST(pxListItem) ((BaseType_t)((pxListItem)->pvContainer != NULL))
+#define listGET_INDEX(pxList) ((pxList)->pxIndex)
+#define listSET_INDEX(pxList, pxListItem) ((pxList)->pxIndex = (ListItem_t *)(pxListItem))
+#endif
+
 /*
  * @brief 初始化节点的拥有者
  * @param ListItem_t*与Owner(TCB_t)类型指针
  */
+#if (configUSE_LIST_INDEX_LINKS == 1)
+#define listSE_LIST_ITEM_OWNER(pxListItem, pxOwner) \
+    ((pxListItem)->usOwner = listLINK_FROM_PTR(pxOwner))
+#else
 #define listSE_LIST_ITEM_OWNER(pxListItem, pxOwner) \
     ((pxListItem)->pvOwner = (void *)pxOwner)
+#endif
 
 /*
  * @brief 获取节点的拥有者
  * @param ListItem_t*
  * @return Owner(TCB_t)类型指针
  */
+#if (configUSE_LIST_INDEX_LINKS == 1)
+#define listGET_LIST_ITEM_OWNER(pxListItem) \
+    listPTR_FROM_LINK((pxListItem)->usOwner)
+#else
 #define listGET_LIST_ITEM_OWNER(pxListItem) \
     ((pxListItem)->pvOwner)
+#endif
 
 /*
  * @brief 初始化节点排序辅助值
@@ -82,7 +157,7 @@ typedef struct xLIST
  * @return TickType_t
  */
 #define listGET_ITEM_VALUE_OF_HEAD_ENTRY(pxList) \
-    ((((pxList)->xListEnd).pxNext)->xItemValue)
+    (listGET_HEAD_ENTRY(pxList)->xItemValue)
 
 /*
  * @brief 获取链表头节点的指针
@@ -90,7 +165,7 @@ typedef struct xLIST
  * @return ListItem_t*
  */
 #define listGET_HEAD_ENTRY(pxList) \
-    (((pxList)->xListEnd).pxNext)
+    listGET_NEXT(&((pxList)->xListEnd))
 
 /**
  *  @brief 获取链表头节点的TCB指针
@@ -98,15 +173,20 @@ typedef struct xLIST
  *  @return TCB_t*
  */
 #define listGET_OWNER_OF_HEAD_ENTRY(pxList) \
-    (((&((pxList)->xListEnd))->pxNext)->pvOwner)
+    listGET_LIST_ITEM_OWNER(listGET_HEAD_ENTRY(pxList))
 
 /*
  * @brief 获取节点的下一个节点
  * @param ListItem_t*
  * @return ListItem_t*
  */
+#if (configUSE_LIST_INDEX_LINKS == 1)
+#define listGET_NEXT(pxListItem) \
+    ((ListItem_t *)listPTR_FROM_LINK((pxListItem)->usNext))
+#else
 #define listGET_NEXT(pxListItem) \
     ((pxListItem)->pxNext)
+#endif
 
 /*
  * @brief 获取链表的根节点（末尾节点）
@@ -117,6 +197,14 @@ typedef struct xLIST
 #define listGET_END_MARKER(pxList) \
     ((ListItem_t const *)(&((pxList)->xListEnd)))
 
+/*
+ * @brief 判断节点是否属于某个链表
+ * @param pxList*，ListItem_t*
+ * @return BaseType_t
+ */
+#define listIS_CONTAINED_WITHIN(pxList, pxListItem) \
+    ((BaseType_t)(listGET_CONTAINER(pxListItem) == (pxList)))
+
 /*
  * @brief 判断链表是否为空
  * @param pxList*
@@ -140,16 +228,17 @@ typedef struct xLIST
  * @note do { ... } while (0) 的作用: 1.  宏内定义的变量不影响外层 2. 可以用分号结尾，模拟函数调用 3. 形成整体，直接用于if下
  * @warning 对于空链表调用这个函数会导致访问未定义指针的问题
  */
-#define listGET_OWNER_OF_NEXT_ENTRY(pxTCB, pxList)                                    \
-    do                                                                                \
-    {                                                                                 \
-        List_t* const pxConstList = (pxList);                                         \
-        pxConstList->pxIndex = (pxConstList)->pxIndex->pxNext;                        \
-        if ((void *)((pxConstList)->pxIndex) == (void *)(&((pxConstList)->xListEnd))) \
-        {                                                                             \
-            (pxConstList)->pxIndex = (pxConstList)->pxIndex->pxNext;                  \
-        }                                                                             \
-        (pxTCB) = (pxConstList)->pxIndex->pvOwner;                                    \
+#define listGET_OWNER_OF_NEXT_ENTRY(pxTCB, pxList)                                           \
+    do                                                                                       \
+    {                                                                                        \
+        List_t* const pxConstList = (pxList);                                                \
+        ListItem_t *pxNextIndex = listGET_NEXT(listGET_INDEX(pxConstList));                  \
+        if ((void *)pxNextIndex == (void *)(&((pxConstList)->xListEnd)))                     \
+        {                                                                                    \
+            pxNextIndex = listGET_NEXT(pxNextIndex);                                         \
+        }                                                                                    \
+        listSET_INDEX(pxConstList, pxNextIndex);                                             \
+        (pxTCB) = listGET_LIST_ITEM_OWNER(pxNextIndex);                                      \
     } while (0)
 
 /*
@@ -189,6 +278,37 @@ void vListInsertEnd(List_t *const pxList, ListItem_t *const pxNewListItem);
  */
 void vListInsert(List_t *const pxList, ListItem_t *const pxNewListItem);
 
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxNewListItem 节点指针
+ * @discription 与 vListInsert 的结果相同，根据头尾节点的辅助值选择从头往后还是从尾往前查找，
+ *              延时一般插在尾部附近，这时只需要比较一两次
+ * @warning 链表必须先初始化，防止访问未初始化指针
+ */
+void vListInsertBidirectional(List_t *const pxList, ListItem_t *const pxNewListItem);
+
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxHint 开始查找的节点，必须属于 pxList，为NULL时等同于 vListInsertBidirectional
+ * @param pxNewListItem 节点指针
+ * @discription 与 vListInsert 的结果相同，从调用者给出的节点开始往前或往后查找，
+ *              调用者通常用上一次插入的节点作提示
+ * @warning 提示节点可能已经被删除时，调用前用 listIS_CONTAINED_WITHIN 检查
+ */
+void vListInsertHinted(List_t *const pxList, ListItem_t *const pxHint, ListItem_t *const pxNewListItem);
+
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxPosition 插入位置，新节点插在它前面，可以是 listGET_END_MARKER(pxList)（即插在末尾）
+ * @param pxNewListItem 节点指针
+ * @discription 由调用者自己决定排序位置，用于不能直接比较 xItemValue 大小的链表，如按回绕时间排序的高精度延时链表
+ * @warning pxPosition 必须属于 pxList
+ */
+void vListInsertBefore(List_t *const pxList, ListItem_t *const pxPosition, ListItem_t *const pxNewListItem);
+
 /*
  * @brief 删除节点
  * @param pxItemToRemove 节点指针
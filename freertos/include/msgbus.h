@@ -0,0 +1,120 @@
+#ifndef MSGBUS_H
+#define MSGBUS_H
+
+#include "task.h"
+
+/** 零拷贝发布/订阅消息总线
+ *  发布者从缓冲池取一块缓冲区，填好后把指针发布到主题；主题上的每个订阅者收到的都是同一块缓冲区的指针，
+ *  缓冲区带引用计数，每个订阅者用完后释放，最后一个释放时回到缓冲池。数据只写一次，不论有多少订阅者都不拷贝。
+ *  订阅者有自己的指针环，放满时这个订阅者丢弃新消息（uxDropped 计数），不会阻塞发布者；
+ *  环的长度不小于缓冲池的块数时不会丢弃，因为环中的每个指针都占着一块缓冲区。
+ *  订阅者与等待缓冲区的发布者阻塞在内核的事件链表上，按优先级唤醒，带超时。
+ *  缓冲区由接收者只读使用，内容在发布后不能再修改
+ */
+#if (configUSE_MSGBUS == 1)
+
+/* 每块缓冲区的头部，紧挨在数据之前，数据指针减去头部就是它 */
+typedef struct xMSG_BUFFER_HEADER
+{
+    struct xMSG_BUFFER_HEADER *pxNextFree;  // 空闲链
+    struct xMSG_POOL *pxPool;               // 释放时回到的缓冲池
+    volatile UBaseType_t uxRefCount;
+    size_t xLength;                         // 发布时的有效字节数
+} MsgBufferHeader_t;
+
+typedef struct xMSG_POOL
+{
+    MsgBufferHeader_t *pxFreeList;
+    size_t xBlockSize;                      // 头部加数据，8字节对齐
+    size_t xPayloadSize;
+    volatile UBaseType_t uxFree;
+    UBaseType_t uxMinFree;                  // 空闲块数的最低值，用来确定池的大小
+    List_t xTasksWaitingForBuffer;          // 按优先级排序，等待空闲缓冲区的任务
+} MsgPool_t;
+
+typedef struct xMSG_TOPIC
+{
+    struct xMSG_SUBSCRIBER *pxSubscribers;  // 订阅者单链表
+    UBaseType_t uxSubscriberCount;
+} MsgTopic_t;
+
+typedef struct xMSG_SUBSCRIBER
+{
+    struct xMSG_SUBSCRIBER *pxNext;
+    MsgTopic_t *pxTopic;
+    void **ppvRing;                         // 收到但还没取走的消息
+    UBaseType_t uxLength;
+    volatile UBaseType_t uxWaiting;
+    UBaseType_t uxReadIndex;
+    UBaseType_t uxWriteIndex;
+    volatile UBaseType_t uxDropped;         // 环满丢弃的消息数
+    List_t xTasksWaitingToReceive;
+} MsgSubscriber_t;
+
+// 每块的字节数：头部加数据，数据向上对齐到8字节
+#define msgbusBLOCK_SIZE(xPayloadSize) (sizeof(MsgBufferHeader_t) + (((xPayloadSize) + 7U) & ~(size_t)7U))
+// 缓冲池存储区的 uint64_t 个数，用 uint64_t 数组保证8字节对齐
+#define msgbusPOOL_STORAGE_WORDS(uxBlockCount, xPayloadSize) (((uxBlockCount) * msgbusBLOCK_SIZE(xPayloadSize) + 7U) / 8U)
+
+/**
+ * @brief 初始化缓冲池
+ *
+ * @param pxPool 缓冲池
+ * @param pullStorage 存储区，至少 msgbusPOOL_STORAGE_WORDS(uxBlockCount, xPayloadSize) 个 uint64_t
+ * @param uxBlockCount 缓冲区块数
+ * @param xPayloadSize 每块的数据字节数
+ */
+void vMsgPoolInitialise(MsgPool_t *const pxPool, uint64_t *const pullStorage, const UBaseType_t uxBlockCount, const size_t xPayloadSize);
+
+/**
+ * @brief 取一块缓冲区，没有空闲时最多等待 xTicksToWait 个tick
+ * @return 数据指针，引用计数为1，属于调用者；超时返回NULL
+ */
+void *pvMsgBusAlloc(MsgPool_t *const pxPool, TickType_t xTicksToWait);
+/* 中断中取缓冲区，没有空闲时返回NULL */
+void *pvMsgBusAllocFromISR(MsgPool_t *const pxPool);
+
+/* 增加一个引用，例如订阅者要把消息转交给别的任务 */
+void vMsgBusRetain(void *const pvMessage);
+/* 释放一个引用，最后一个释放时缓冲区回到缓冲池，唤醒等待缓冲区的任务 */
+void vMsgBusRelease(void *const pvMessage);
+/* 中断中释放 */
+void vMsgBusReleaseFromISR(void *const pvMessage, BaseType_t *const pxHigherPriorityTaskWoken);
+/* 消息的有效字节数 */
+size_t xMsgBusGetLength(const void *const pvMessage);
+
+void vMsgTopicInitialise(MsgTopic_t *const pxTopic);
+
+/**
+ * @brief 订阅主题
+ *
+ * @param pxTopic 主题
+ * @param pxSubscriber 订阅者
+ * @param ppvRing 指针环，uxLength 个 void *
+ * @param uxLength 环的长度，不小于缓冲池的块数时不会丢消息
+ */
+void vMsgBusSubscribe(MsgTopic_t *const pxTopic, MsgSubscriber_t *const pxSubscriber, void **const ppvRing, const UBaseType_t uxLength);
+/* 取消订阅，还没取走的消息被释放；不能有任务正阻塞在这个订阅者上 */
+void vMsgBusUnsubscribe(MsgSubscriber_t *const pxSubscriber);
+
+/**
+ * @brief 发布消息，消息指针交给主题上的每个订阅者，调用者的引用随之交出，发布后不能再访问
+ *
+ * @param pxTopic 主题
+ * @param pvMessage pvMsgBusAlloc 得到的数据指针
+ * @param xLength 有效字节数
+ * @return 收到消息的订阅者个数，没有订阅者时缓冲区直接回到缓冲池
+ */
+UBaseType_t uxMsgBusPublish(MsgTopic_t *const pxTopic, void *const pvMessage, const size_t xLength);
+/* 中断中发布，唤醒了需要切换的任务时 *pxHigherPriorityTaskWoken 置为 pdTRUE */
+UBaseType_t uxMsgBusPublishFromISR(MsgTopic_t *const pxTopic, void *const pvMessage, const size_t xLength, BaseType_t *const pxHigherPriorityTaskWoken);
+
+/**
+ * @brief 接收消息，没有消息时最多等待 xTicksToWait 个tick
+ * @return 数据指针，用完后调用 vMsgBusRelease；超时返回NULL
+ */
+void *pvMsgBusReceive(MsgSubscriber_t *const pxSubscriber, TickType_t xTicksToWait);
+
+#endif /* configUSE_MSGBUS */
+
+#endif
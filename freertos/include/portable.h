@@ -21,4 +21,124 @@ StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
  */
 BaseType_t xPortStartScheduler(void);
 
+/**
+ * @brief 启动高精度时间基准（如DWT周期计数器），重复调用无副作用，不会清零计数
+ */
+void vPortHighResTimeInit(void);
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+/**
+ * @brief 把硬件定时器设置为单次定时，在 xDeadline 时刻(高精度时间)触发一次tick中断
+ *
+ * @param xDeadline 下一次需要内核处理的时刻，已过期时尽快触发，太远时截断到硬件允许的最长定时
+ */
+void vPortHighResTimerSetDeadline(HighResTime_t xDeadline);
+#endif
+
+#if (configUSE_SAMPLING_PROFILER == 1)
+/** 采样剖析：周期中断中记录被打断任务的PC与TCB，放进环形缓冲区，新样本覆盖最旧的；
+ *  停下调试器后把 xProfilerRing 导出成二进制文件，用 tools/profile_flamegraph.py 对照ELF生成火焰图。
+ *  PC是中断发生时的位置：临界区中挂起的tick在退出临界区时才采样，临界区内的时间会算到退出临界区的地方
+ *  在SysTick中采样时，每个tick都被唤醒的任务总在采样之后才运行，看不到；这种情况用频率与tick不成倍数的专用定时器采样
+ */
+typedef struct xPROFILER_SAMPLE
+{
+    uint32_t ulPC;
+    uint32_t ulTask;        // 被打断任务的TCB地址，工具按ELF符号表换成任务名
+} ProfilerSample_t;
+
+typedef struct xPROFILER_RING
+{
+    volatile uint32_t ulCount;                                  // 采样总数，写位置是 ulCount % configPROFILER_SAMPLE_COUNT
+    ProfilerSample_t xSamples[configPROFILER_SAMPLE_COUNT];
+} ProfilerRing_t;
+
+extern ProfilerRing_t xProfilerRing;
+
+/**
+ * @brief 采样一次，configPROFILER_SAMPLE_IN_SYSTICK 为1时由SysTick调用；
+ *        为0时由用户的专用定时器中断调用，可以比tick采得更密，中断优先级必须是最低（与PendSV相同）
+ */
+void vPortProfilerSample(void);
+#endif
+
+#if (configUSE_CRITICAL_TIMING == 1)
+/** 屏蔽中断时长统计：最外层临界区（嵌套 0->1 到 1->0）、SysTick 与 PendSV 中屏蔽的时间，用CYCCNT计周期。
+ *  临界区按 vPortEnterCritical 的返回地址区分调用点（Thumb地址，最低位为1），SysTick、PendSV 的调用点是处理函数本身的地址；
+ *  停下调试器后导出 xCriticalTiming，用 tools/critical_report.py 对照ELF列出每个调用点。
+ *  退出时的记录本身（几十个周期）也在屏蔽中，不计入；中断中的 FROM_ISR 屏蔽不统计
+ */
+typedef struct xCRITICAL_SITE
+{
+    uint32_t ulSite;
+    uint32_t ulCount;
+    uint32_t ulMaxCycles;
+    uint32_t ulHistogram[configCRITICAL_TIMING_BUCKETS];    // 第i个桶是 [2^i, 2^(i+1)) 个周期，最后一个桶包括更长的
+} CriticalSite_t;
+
+typedef struct xCRITICAL_TIMING
+{
+    uint32_t ulMaxCycles;           // 所有调用点中最长的一次
+    uint32_t ulMaxSite;             // 最长的一次的调用点
+    uint32_t ulOverflows;           // 调用点表满，没有记录的次数
+    CriticalSite_t xSites[configCRITICAL_TIMING_SITES];
+} CriticalTiming_t;
+
+extern CriticalTiming_t xCriticalTiming;
+
+/* 清空统计，例如跳过启动阶段，只看稳定运行时 */
+void vPortCriticalTimingReset(void);
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+/** 故障现场记录：xPostMortem 放在 .bss.noinit 中，复位后内容还在
+ *  1. 平时只在每次任务切换时写一项切换环（tick与切入的TCB），几条指令
+ *  2. HardFault 中冻结：记下tick、当前任务、EXC_RETURN、故障前的栈指针与异常帧、故障状态寄存器、每个任务的栈水位，然后复位
+ *  3. 下次启动时在 vTaskStartScheduler 之前看 ulMagic：
+ *     postmortemMAGIC_FAULT 表示上次因故障复位，整个记录有效；
+ *     postmortemMAGIC_RUNNING 表示上次运行中复位（看门狗、死锁后手动复位），只有切换环有效，最后一项就是停住前的任务；
+ *     其他值是上电后的随机内容。调度器启动时重新开始记录，之前要先把需要的内容取走
+ *  调试器或启动代码把 xPostMortem 导出成二进制文件，用 tools/post_mortem.py 对照ELF解码
+ */
+#define postmortemMAGIC_RUNNING 0x504d5255UL    // "PMRU"
+#define postmortemMAGIC_FAULT 0x504d4654UL      // "PMFT"
+
+typedef struct xPOST_MORTEM_SWITCH
+{
+    uint32_t ulTick;
+    uint32_t ulTask;        // 切入任务的TCB地址
+} PostMortemSwitch_t;
+
+typedef struct xPOST_MORTEM_STACK
+{
+    uint32_t ulTask;        // TCB地址
+    uint32_t ulStack;       // 栈的低地址端
+    uint32_t ulDepth;       // 栈深度（字）
+    uint32_t ulFree;        // 从没用到过的字数，0表示栈已经用满，很可能溢出
+} PostMortemStack_t;
+
+typedef struct xPOST_MORTEM
+{
+    uint32_t ulMagic;
+    uint32_t ulSwitchSlots;                         // configPOST_MORTEM_SWITCHES，工具按它解析
+    uint32_t ulStackSlots;                          // configPOST_MORTEM_TASKS
+    volatile uint32_t ulSwitchCount;                // 切换总数，写位置是 ulSwitchCount % ulSwitchSlots
+    PostMortemSwitch_t xSwitches[configPOST_MORTEM_SWITCHES];
+    // 以下只在故障时写入
+    uint32_t ulTickCount;
+    uint32_t ulCurrentTask;
+    uint32_t ulExcReturn;
+    uint32_t ulStackPointer;                        // 故障前使用的栈（PSP或MSP），异常帧就在这里
+    uint32_t ulFrame[8];                            // 异常帧：r0 r1 r2 r3 r12 lr pc xpsr
+    uint32_t ulCFSR;
+    uint32_t ulHFSR;
+    uint32_t ulMMFAR;
+    uint32_t ulBFAR;
+    uint32_t ulStackCount;                          // xStacks 中有效的项数
+    PostMortemStack_t xStacks[configPOST_MORTEM_TASKS];
+} PostMortem_t;
+
+extern PostMortem_t xPostMortem;
+#endif
+
 #endif
@@ -10,4 +10,13 @@ typedef void (*TaskFunction_t)(void *arg); // 定义函数指针的别名，void
 #define pdFAIL pdFALSE
 #define pdPASS pdTRUE
 
+// 创建任务时没有可用的内存（复用池中没有足够大的TCB与栈）
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY ((BaseType_t)-1)
+
+// 队列操作的返回值，负数只在协程中使用：BLOCKED 表示已经进入等待，YIELD 表示唤醒了更高或同优先级的协程
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL ((BaseType_t)0)
+#define errQUEUE_BLOCKED ((BaseType_t)-4)
+#define errQUEUE_YIELD ((BaseType_t)-5)
+
 #endif
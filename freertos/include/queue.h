@@ -0,0 +1,106 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "task.h"
+
+/** 任务间的队列
+ *  数据按值拷贝进环形存储区，存储区与队列结构由用户静态分配；队列满时发送者、空时接收者可以阻塞等待，带超时，
+ *  等待的任务按优先级排在 xTasksWaitingToSend / xTasksWaitingToReceive 上，每次唤醒优先级最高的一个。
+ *  元素大小为0的队列只计数，就是信号量（semphr.h）
+ */
+#if (configUSE_QUEUES == 1)
+
+typedef struct QueueDefinition
+{
+    uint8_t *pucStorage;                        // uxLength * uxItemSize 字节，信号量为NULL
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    volatile UBaseType_t uxMessagesWaiting;
+    UBaseType_t uxReadIndex;                    // 下一个要读出的元素
+    UBaseType_t uxWriteIndex;                   // 下一个要写入的位置
+    List_t xTasksWaitingToSend;                 // 按优先级排序，等待队列有空位的任务
+    List_t xTasksWaitingToReceive;              // 按优先级排序，等待队列有数据的任务
+    #if (configUSE_QUEUE_SETS == 1)
+    struct QueueDefinition *pxQueueSetContainer;// 所在的队列集合，NULL表示不在集合中
+    #endif
+} StaticQueue_t;
+
+typedef StaticQueue_t *QueueHandle_t;
+
+/**
+ * @brief 创建队列
+ *
+ * @param uxQueueLength 最多容纳的元素个数
+ * @param uxItemSize 每个元素的字节数
+ * @param pucQueueStorage 存储区，至少 uxQueueLength * uxItemSize 字节
+ * @param pxStaticQueue 队列结构
+ * @return 队列句柄
+ */
+QueueHandle_t xQueueCreateStatic(const UBaseType_t uxQueueLength,
+                                 const UBaseType_t uxItemSize,
+                                 uint8_t *const pucQueueStorage,
+                                 StaticQueue_t *const pxStaticQueue);
+
+/* 创建计数信号量，一般用 semphr.h 中的宏 */
+QueueHandle_t xQueueCreateCountingSemaphoreStatic(const UBaseType_t uxMaxCount,
+                                                  const UBaseType_t uxInitialCount,
+                                                  StaticQueue_t *const pxStaticQueue);
+
+/**
+ * @brief 发送到队尾，队列满时最多等待 xTicksToWait 个tick
+ * @return pdPASS，或等待超时的 errQUEUE_FULL
+ */
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *const pvItemToQueue, TickType_t xTicksToWait);
+
+/**
+ * @brief 接收队头，队列空时最多等待 xTicksToWait 个tick
+ * @return pdPASS，或等待超时的 errQUEUE_EMPTY
+ */
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *const pvBuffer, TickType_t xTicksToWait);
+
+/* 中断中发送，队列满时直接返回 errQUEUE_FULL；唤醒了需要切换的任务时 *pxHigherPriorityTaskWoken 置为 pdTRUE */
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *const pvItemToQueue, BaseType_t *const pxHigherPriorityTaskWoken);
+/* 中断中接收，队列空时直接返回 errQUEUE_EMPTY */
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *const pvBuffer, BaseType_t *const pxHigherPriorityTaskWoken);
+
+/* 队列中的元素个数（信号量的计数） */
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue);
+
+#if (configUSE_QUEUE_SETS == 1)
+/** 队列集合
+ *  集合本身是一个元素为成员句柄的队列：成员每收到一个数据（信号量每给出一次），就把成员句柄发送到集合，
+ *  等待集合的任务被唤醒，拿到的就是有数据的成员，唤醒的代价与成员个数无关，不需要轮询每个成员。
+ *  集合的长度不能小于所有成员长度之和，否则集合会放不下。
+ *  成员只能通过集合等待：xQueueSelectFromSet 返回成员后，再用 xQueueReceive/xSemaphoreTake 以0等待时间取出数据，
+ *  每次选择只取一个
+ */
+typedef QueueHandle_t QueueSetHandle_t;
+typedef QueueHandle_t QueueSetMemberHandle_t;
+
+// 集合存储区的字节数
+#define queueSET_STORAGE_SIZE(uxEventQueueLength) ((uxEventQueueLength) * sizeof(QueueSetMemberHandle_t))
+
+/* 创建集合，pucQueueStorage 至少 queueSET_STORAGE_SIZE(uxEventQueueLength) 字节 */
+QueueSetHandle_t xQueueCreateSetStatic(const UBaseType_t uxEventQueueLength,
+                                       uint8_t *const pucQueueStorage,
+                                       StaticQueue_t *const pxStaticQueue);
+
+/**
+ * @brief 把队列或信号量加入集合
+ * @return pdPASS；成员已经在某个集合中，或者里面已经有数据时返回 pdFAIL
+ */
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet);
+
+/* 从集合中移出，成员不在这个集合中或者里面还有数据时返回 pdFAIL */
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet);
+
+/**
+ * @brief 等待集合中任意一个成员有数据，最多等待 xTicksToWait 个tick
+ * @return 有数据的成员，超时返回NULL
+ */
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet, const TickType_t xTicksToWait);
+#endif /* configUSE_QUEUE_SETS */
+
+#endif /* configUSE_QUEUES */
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+/** 信号量
+ *  元素大小为0的队列，uxMessagesWaiting 就是计数：给出是发送，获取是接收，不拷贝数据。
+ *  二值信号量是最大计数为1、初始为0的计数信号量
+ */
+#if (configUSE_QUEUES == 1)
+
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+#define xSemaphoreCreateBinaryStatic(pxSemaphoreBuffer) \
+    xQueueCreateCountingSemaphoreStatic((UBaseType_t)1, (UBaseType_t)0, (pxSemaphoreBuffer))
+#define xSemaphoreCreateCountingStatic(uxMaxCount, uxInitialCount, pxSemaphoreBuffer) \
+    xQueueCreateCountingSemaphoreStatic((uxMaxCount), (uxInitialCount), (pxSemaphoreBuffer))
+
+// 获取，计数为0时最多等待 xBlockTime 个tick，超时返回 pdFAIL
+#define xSemaphoreTake(xSemaphore, xBlockTime) xQueueReceive((xSemaphore), NULL, (xBlockTime))
+// 给出，已经是最大计数时返回 pdFAIL，不等待
+#define xSemaphoreGive(xSemaphore) xQueueSend((xSemaphore), NULL, (TickType_t)0)
+#define xSemaphoreGiveFromISR(xSemaphore, pxHigherPriorityTaskWoken) \
+    xQueueSendFromISR((xSemaphore), NULL, (pxHigherPriorityTaskWoken))
+#define xSemaphoreTakeFromISR(xSemaphore, pxHigherPriorityTaskWoken) \
+    xQueueReceiveFromISR((xSemaphore), NULL, (pxHigherPriorityTaskWoken))
+#define uxSemaphoreGetCount(xSemaphore) uxQueueMessagesWaiting((xSemaphore))
+
+#endif /* configUSE_QUEUES */
+
+#endif
@@ -30,13 +30,139 @@ typedef struct tskTaskControlBlock *TaskHandle_t; // 指向任务控制块的指
 /* 阻塞延时 */
 void vTaskDelay(const TickType_t xTicksToDelay);
 
+/**
+ * @brief 修改任务优先级
+ *
+ * @param xTask 任务句柄，NULL表示当前任务
+ * @param uxNewPriority 新优先级，大于最大优先级时按最大优先级处理
+ * @note 就绪任务在就绪队列之间移动，uxTopReadyPriority 同步更新，都是O(1)；
+ *       任务因预算降级或因老化临时提升时，只修改基础优先级，恢复时生效
+ */
+void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority);
+
+/* 获取任务当前（可能是临时的）优先级，NULL表示当前任务 */
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask);
+
 /* 启动任务调度 */
 void vTaskStartScheduler(void);
 /* 任务切换 */
 void vTaskSwitchContext(void);
+
+#if (configUSE_DIRECTED_YIELD == 1)
+/**
+ * @brief 定向让出：让出CPU，并指定下一个运行的任务
+ *
+ * @param xTask 下一个运行的任务，必须是就绪任务，优先级不高于当前任务（多核时还要在本核的就绪队列上）
+ * @note 切换时只检查 xTask 还在就绪、没有比当前任务优先级更高的任务就绪，然后直接切到它，不再选择最高优先级任务；
+ *       条件不满足时与 taskYIELD 相同。当前任务保持就绪，优先级比 xTask 高时，
+ *       xTask 一直运行到它阻塞或让出（或被更高优先级的任务抢占），之后照常调度，当前任务会重新被选中。
+ *       流水线中每一级唤醒下一级后调用它，省掉一次选择，也不会先轮转到同优先级的其他任务
+ */
+void vTaskYieldTo(TaskHandle_t xTask);
+#endif
+
+#if (configUSE_RENDEZVOUS_IPC == 1)
+/** 同步IPC端点
+ *  客户任务用 xTaskIpcCall 发请求并阻塞到回复，服务任务用 xTaskIpcReceive 取请求、vTaskIpcReply 回复；
+ *  不经过中间缓冲区，请求从调用者的缓冲区直接拷到接收者的缓冲区，回复直接拷回调用者，每个方向只拷一次；
+ *  一方在等另一方时直接切到对方。服务任务收到请求后继承调用者的优先级，有更高优先级的调用者排队时继续提升，
+ *  回复时如果还有调用者在排队，保持它们中最高的优先级，没有时恢复原来的优先级。
+ *  提升期间用 vTaskPrioritySet 修改服务任务的优先级，恢复时会被覆盖。
+ *  删除等待回复的调用者后，服务任务对它的回复被丢弃；服务任务在回复之前不能被删除，它收下的调用者会一直阻塞。
+ *  拷贝在临界区中进行，适合几十字节以内的小消息
+ */
+typedef struct xIPC_ENDPOINT
+{
+    List_t xCallers;                // 按优先级排序，等待接收者的调用者
+    void *pvReceiver;               // 阻塞在 xTaskIpcReceive 上的接收者，一个端点同时只能有一个
+    void *pvServer;                 // 最近一次收到请求的服务任务，回到 xTaskIpcReceive 阻塞或被删除时清为NULL
+    UBaseType_t uxServerPriority;   // 服务任务被提升前的优先级
+    BaseType_t xServerBoosted;      // 服务任务正被提升
+} IpcEndpoint_t;
+
+/* 初始化端点 */
+void vTaskIpcEndpointInitialise(IpcEndpoint_t *const pxEndpoint);
+
+/**
+ * @brief 发送请求并阻塞，直到接收者回复
+ *
+ * @param pvRequest 请求，xRequestLength 超过接收缓冲区时截断
+ * @param pvReply 回复缓冲区，回复超过 xReplyLength 时截断
+ * @return 实际收到的回复长度
+ */
+size_t xTaskIpcCall(IpcEndpoint_t *const pxEndpoint,
+                    const void *const pvRequest,
+                    const size_t xRequestLength,
+                    void *const pvReply,
+                    const size_t xReplyLength);
+
+/**
+ * @brief 接收请求，没有调用者时阻塞；有多个调用者时先接收优先级最高的
+ *
+ * @param pxReceivedLength 实际收到的请求长度，可以为NULL
+ * @return 调用者，回复时传给 vTaskIpcReply，回复之前调用者一直阻塞
+ */
+TaskHandle_t xTaskIpcReceive(IpcEndpoint_t *const pxEndpoint,
+                             void *const pvBuffer,
+                             const size_t xBufferLength,
+                             size_t *const pxReceivedLength);
+
+/* 回复调用者，唤醒它并恢复本任务继承前的优先级 */
+void vTaskIpcReply(TaskHandle_t xCaller, const void *const pvReply, const size_t xLength);
+#endif
 /* 延时计时*/
 BaseType_t xTaskIncrementTick(void);
 
+/* 获取当前任务的句柄，多核时是调用者所在核正在运行的任务 */
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#if (configUSE_QUEUES == 1)
+/* 阻塞超时的起点，被唤醒后条件仍不满足、需要再次阻塞时，用它算出剩余的等待时间 */
+typedef struct xTIME_OUT
+{
+    TickType_t xTimeOnEntering;
+} TimeOut_t;
+
+/* 以下函数供队列使用，必须在临界区中调用 */
+/* 当前任务按优先级挂到事件链表上并阻塞，xTicksToWait 为 portMAX_DELAY 时只能被事件唤醒，调用后需要 taskYIELD() */
+void vTaskPlaceOnEventList(List_t *const pxEventList, const TickType_t xTicksToWait);
+/* 唤醒事件链表上优先级最高的任务，返回本核是否需要切换，中断中也可以调用 */
+BaseType_t xTaskRemoveFromEventList(const List_t *const pxEventList);
+/* 记下超时起点 */
+void vTaskSetTimeOutState(TimeOut_t *const pxTimeOut);
+/* 已经超时返回 pdTRUE；否则从 *pxTicksToWait 中减去经过的时间并把起点改为现在，返回 pdFALSE */
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *const pxTimeOut, TickType_t *const pxTicksToWait);
+#endif
+
+/* 获取当前tick，任务中使用 */
+TickType_t xTaskGetTickCount(void);
+/* 获取当前tick，中断中使用 */
+TickType_t xTaskGetTickCountFromISR(void);
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+/* 获取高精度时间，单位见 portHIGH_RES_COUNTS_PER_US */
+HighResTime_t xTaskGetHighResTime(void);
+
+/**
+ * @brief 高精度阻塞延时，不受tick周期限制
+ *
+ * @param ulMicroseconds 延时微秒数，换算后的计数不能超过高精度时间回绕周期的一半
+ */
+void vTaskDelayUs(const uint32_t ulMicroseconds);
+
+/**
+ * @brief 高精度周期延时，唤醒时刻为上次唤醒时刻加上周期，不会累计误差
+ *
+ * @param pxPreviousWakeTime 上次唤醒时刻，第一次调用前用 xTaskGetHighResTime() 初始化，函数内更新
+ * @param ulIncrementUs 周期微秒数
+ * @note 如果新的唤醒时刻已经过去，不会阻塞，直接返回
+ */
+void vTaskDelayUntilUs(HighResTime_t *const pxPreviousWakeTime, const uint32_t ulIncrementUs);
+
+/* 单次定时中断处理，补齐到期的tick，唤醒到期的高精度延时任务，并设置下一次定时，由port的tick中断调用 */
+BaseType_t xTaskHighResTimerHandler(void);
+#endif
+
 #if (configSUPPORT_STATIC_ALLOCATION == 1)
 /**
  * @brief 创建静态任务
@@ -59,4 +185,267 @@ TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,
                                StaticTask_t *const pxTaskBuffer);
 #endif
 
+/* 现存任务数，包括空闲任务 */
+UBaseType_t uxTaskGetNumberOfTasks(void);
+
+#if (configUSE_TASK_DELETE == 1)
+/**
+ * @brief 删除任务
+ *
+ * @param xTaskToDelete 任务句柄，NULL表示删除当前任务（不会返回）
+ * @note 任务从就绪/延时/事件队列中移除，TCB与栈放入复用池，供 xTaskCreate 再用；
+ *       正在运行的任务（自删除，或多核时在其他核上运行）等它切出后由空闲任务回收，所以空闲任务要有机会运行；
+ *       空闲任务与基本任务的分发任务不能删除
+ */
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+
+/**
+ * @brief 从复用池中取TCB与栈创建任务，复用池中选栈深度够用的最小的一对，不会把大栈切碎
+ *
+ * @param uxStackDepth 至少需要的栈深度（字），实际用取到的栈的全部深度
+ * @param pxCreatedTask 创建的任务句柄，可以为NULL
+ * @return pdPASS；复用池中没有足够大的栈时返回 errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY
+ * @note 其余参数与 xTaskCreateStatic 一样；本内核没有堆，复用池中的内存来自 vTaskPoolAdd 与被删除的任务
+ */
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode,
+                       const char *const pcName,
+                       const StackType_t uxStackDepth,
+                       void *const pvParameters,
+                       UBaseType_t uxPriority,
+                       TaskHandle_t *const pxCreatedTask);
+
+/* 把一对静态分配的TCB与栈放入复用池，供 xTaskCreate 使用 */
+void vTaskPoolAdd(StaticTask_t *const pxTaskBuffer, StackType_t *const pxStackBuffer, const StackType_t uxStackDepth);
+
+/* 复用池中空闲的TCB与栈的对数 */
+UBaseType_t uxTaskPoolGetCount(void);
+#endif
+
+#if (configUSE_STATIC_TASK_TABLE == 1)
+/* 静态任务表中每个任务的句柄：xStaticTaskHandle_名字 */
+#define tskSTATIC_TASK_HANDLE_DECLARE(xName, pxCode, pvParameters, uxDepth, uxPriority) \
+    extern TaskHandle_t const xStaticTaskHandle_##xName;
+configSTATIC_TASK_TABLE(tskSTATIC_TASK_HANDLE_DECLARE)
+#endif
+
+#if (configUSE_PREEMPTION_THRESHOLD == 1)
+/**
+ * @brief 设置任务的抢占阈值
+ *
+ * @param xTask 任务句柄，NULL表示当前任务
+ * @param uxNewThreshold 新阈值，小于任务优先级时按任务优先级处理，大于最大优先级时按最大优先级处理；
+ *                       任务优先级被临时提升到阈值之上时，按提升后的优先级处理
+ * @note 任务运行时，只有优先级高于阈值的任务才能抢占它，优先级在(优先级, 阈值]之间的一组任务彼此之间不会抢占，
+ *       可以像非抢占调度一样共用数据、减少切换与栈用量；阈值高于优先级时，同优先级任务之间也不再进行时间片轮转，
+ *       但当前任务主动 taskYIELD() 时仍会让给同优先级的任务
+ */
+void vTaskPreemptionThresholdSet(TaskHandle_t xTask, UBaseType_t uxNewThreshold);
+
+/* 获取任务的抢占阈值，NULL表示当前任务 */
+UBaseType_t uxTaskPreemptionThresholdGet(TaskHandle_t xTask);
+#endif
+
+#if (configUSE_TASK_BUDGETS == 1)
+#define tskBUDGET_BLOCK ((UBaseType_t)0)    // 预算用完后阻塞，直到补充时刻
+#define tskBUDGET_DEMOTE ((UBaseType_t)1)   // 预算用完后降到 configTASK_BUDGET_DEMOTED_PRIORITY 继续运行，补充后恢复原优先级
+
+/**
+ * @brief 设置任务的CPU预算（类似sporadic server）
+ *
+ * @param xTask 任务句柄，NULL表示当前任务
+ * @param xBudget 每个补充周期内允许运行的tick数，0表示不限制
+ * @param xPeriod 补充周期，从任务在满预算状态下开始运行时算起，到期后预算补满，必须大于xBudget
+ * @param uxAction 预算用完后的处理，tskBUDGET_BLOCK 或 tskBUDGET_DEMOTE
+ * @note 预算在tick中按采样计费，在任务切入时检查补充；降级期间抢占阈值不起作用，恢复原优先级后照旧生效
+ */
+void vTaskBudgetSet(TaskHandle_t xTask, TickType_t xBudget, TickType_t xPeriod, UBaseType_t uxAction);
+
+/* 获取任务在本补充周期内剩余的预算，NULL表示当前任务 */
+TickType_t xTaskBudgetRemainingGet(TaskHandle_t xTask);
+#endif
+
+#if (configNUMBER_OF_CORES > 1)
+#define tskNO_AFFINITY ((UBaseType_t)-1)   // 可以在任何核上运行
+
+/**
+ * @brief 设置任务的核亲和性
+ *
+ * @param xTask 任务句柄，NULL表示当前任务
+ * @param uxCoreAffinityMask 允许运行的核，第n位对应核n，tskNO_AFFINITY 表示任何核
+ * @note 任务正在不允许的核上运行时，那个核马上重新调度，任务切出时搬到允许的核上；
+ *       任务创建与解阻塞时在允许的核中选当前任务优先级最低的核，空闲的核还会从其他核窃取允许它运行的就绪任务
+ */
+void vTaskCoreAffinitySet(TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask);
+
+/* 获取任务的核亲和性，NULL表示当前任务 */
+UBaseType_t uxTaskCoreAffinityGet(TaskHandle_t xTask);
+
+/* 获取某个核正在运行的任务 */
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t xCoreID);
+#endif
+
+#if (configUSE_BASIC_TASKS == 1)
+/** 基本任务（OSEK basic task）：运行到结束，不会阻塞
+ *  基本任务只是一个函数，被事件或定时激活后，由它所在优先级的分发任务调用，函数返回就算运行结束，下次激活再从头开始；
+ *  每个用到的优先级只有一个分发任务，这个优先级的所有基本任务共用它的栈，同优先级的基本任务之间切换只是函数返回再调用，
+ *  不经过PendSV，也不保存恢复r4-r11；更高优先级的基本任务被激活时切换到那个优先级的分发任务，和普通任务抢占一样。
+ *  基本任务中不能调用 vTaskDelay 等会阻塞的函数，否则同优先级的其他基本任务一起被阻塞
+ *  @param xActivationListItem 挂在所在优先级的激活队列上
+ *  @param xAlarmListItem 挂在定时激活链表上，节点值是与前一个节点的tick差
+ *  @param uxPendingActivations 已激活还没有运行的次数，激活多次就运行多次
+ */
+typedef struct xBASIC_TASK
+{
+    TaskFunction_t pxTaskCode;
+    void *pvParameters;
+    ListItem_t xActivationListItem;
+    ListItem_t xAlarmListItem;
+    TickType_t xAlarmPeriod;        // 定时激活周期，0表示单次
+    UBaseType_t uxPriority;
+    UBaseType_t uxPendingActivations;
+} BasicTask_t;
+
+/**
+ * @brief 创建某个优先级的基本任务分发任务，这个优先级的基本任务都在它的栈上运行
+ *
+ * @param uxPriority 优先级，每个优先级只能创建一个，必须在创建这个优先级的基本任务之前创建
+ * @param uxStackDepth 栈大小（字），按这个优先级中用栈最多的基本任务来定
+ * @param pxStackBuffer 栈缓冲区
+ * @param pxTaskBuffer 任务控制块缓冲区
+ * @return TaskHandle_t 分发任务的句柄
+ */
+TaskHandle_t xTaskBasicDispatcherCreateStatic(UBaseType_t uxPriority,
+                                              const StackType_t uxStackDepth,
+                                              StackType_t *const pxStackBuffer,
+                                              StaticTask_t *const pxTaskBuffer);
+
+/**
+ * @brief 创建基本任务，创建后处于未激活状态
+ *
+ * @param pxTaskCode 基本任务函数，每次激活从头运行到返回
+ * @param pvParameters 基本任务函数的参数
+ * @param uxPriority 优先级，这个优先级必须已经有分发任务
+ * @param pxBasicTaskBuffer 基本任务控制块
+ */
+void vTaskBasicCreateStatic(TaskFunction_t pxTaskCode,
+                            void *const pvParameters,
+                            UBaseType_t uxPriority,
+                            BasicTask_t *const pxBasicTaskBuffer);
+
+/* 激活基本任务，同优先级的基本任务按激活顺序运行，优先级高于当前任务时马上运行 */
+void vTaskBasicActivate(BasicTask_t *const pxBasicTask);
+
+/**
+ * @brief 在中断中激活基本任务
+ * @param pxHigherPriorityTaskWoken 需要任务切换时置为pdTRUE，中断退出前调用 portYIELD()；可以为NULL
+ */
+void vTaskBasicActivateFromISR(BasicTask_t *const pxBasicTask, BaseType_t *const pxHigherPriorityTaskWoken);
+
+/**
+ * @brief 定时激活基本任务，已经设置过时重新设置
+ *
+ * @param xDelay 距第一次激活的tick数，至少为1
+ * @param xPeriod 之后的激活周期，0表示只激活一次
+ * @note 定时激活按tick处理，每个tick只递减链表头的节点，与定时的个数无关
+ */
+void vTaskBasicAlarmSet(BasicTask_t *const pxBasicTask, TickType_t xDelay, TickType_t xPeriod);
+
+/* 取消基本任务的定时激活，已经激活还没运行的不受影响 */
+void vTaskBasicAlarmCancel(BasicTask_t *const pxBasicTask);
+#endif
+
+#if (configUSE_IDLE_WORK_QUEUE == 1)
+/**
+ * @brief 空闲工作函数，每次调用只做一片（有界的一小段）工作
+ * @return 还没做完返回 pdTRUE，排到队尾等下一次空闲继续；做完返回 pdFALSE
+ */
+typedef BaseType_t (*IdleWorkFunction_t)(void *pvParameters);
+
+/** 空闲工作，由用户静态分配
+ *  提交后挂在空闲工作队列上，空闲任务每次取出队头的工作运行一片，多个工作轮流进行；
+ *  空闲任务随时会被就绪的任务抢占，工作函数中不能阻塞，每片越短，多核时空闲的核越快回去窃取任务
+ */
+typedef struct xIDLE_WORK
+{
+    IdleWorkFunction_t pxWorkFunction;
+    void *pvParameters;
+    struct xIDLE_WORK *pxNext;      // 队列中的下一个工作
+    volatile UBaseType_t uxState;   // 不在队列中、在队列中或正在运行
+} IdleWork_t;
+
+/* 初始化空闲工作，初始化后不在队列中 */
+void vTaskIdleWorkInitialise(IdleWork_t *const pxWork, IdleWorkFunction_t pxWorkFunction, void *const pvParameters);
+
+/**
+ * @brief 提交空闲工作，任何任务都可以提交
+ * @return pdPASS；已经在队列中时不重复加入，返回 pdFAIL
+ * @note 正在运行的工作再次提交时，这一片结束后再从头排队
+ */
+BaseType_t xTaskIdleWorkSubmit(IdleWork_t *const pxWork);
+
+/* 在中断中提交空闲工作，返回值同 xTaskIdleWorkSubmit */
+BaseType_t xTaskIdleWorkSubmitFromISR(IdleWork_t *const pxWork);
+
+/**
+ * @brief 取消空闲工作
+ * @return 工作在队列中或正在运行时返回 pdPASS，之后不会再运行；正在运行的这一片不会被打断
+ */
+BaseType_t xTaskIdleWorkCancel(IdleWork_t *const pxWork);
+#endif
+
+#if (configUSE_TASK_SWITCH_COUNTERS == 1)
+/**
+ * @brief 任务切换统计
+ * @param ulSwitchRequests 进入 vTaskSwitchContext 的次数，即PendSV次数
+ * @param ulContextSwitches pxCurrentTCB 实际改变的次数
+ * @param ulPreemptionsDeferred 因抢占阈值而保持当前任务运行的次数
+ * @param ulDirectedYields 按 vTaskYieldTo 或同步IPC的指定直接切换的次数
+ */
+typedef struct xTASK_SWITCH_COUNTERS
+{
+    uint32_t ulSwitchRequests;
+    uint32_t ulContextSwitches;
+    uint32_t ulPreemptionsDeferred;
+    uint32_t ulDirectedYields;
+} TaskSwitchCounters_t;
+
+/* 读取任务切换统计 */
+void vTaskGetSwitchCounters(TaskSwitchCounters_t *const pxCounters);
+/* 清零任务切换统计 */
+void vTaskResetSwitchCounters(void);
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+#define tskSTACK_FILL_WORD ((StackType_t)0xa5a5a5a5UL)  // 创建任务时填满栈的值
+
+/**
+ * @brief 计算每个任务的栈水位，由 HardFault 冻结故障现场时调用，也可以在运行中调用
+ * @param pxStacks 输出，最多 uxMaxStacks 项
+ * @return 写入的项数，即创建过的任务数（不超过 configPOST_MORTEM_TASKS）
+ * @note 任务的栈在创建时填满 tskSTACK_FILL_WORD，从低地址端数还是它的字就是从没用到过的
+ */
+UBaseType_t uxTaskPostMortemStacks(PostMortemStack_t *const pxStacks, const UBaseType_t uxMaxStacks);
+#endif
+
+#if (configUSE_WAKE_LATENCY == 1)
+/**
+ * @brief 任务的唤醒延迟：从被唤醒（延时到期、等到事件、IPC对方唤醒等，加入就绪队列）到 vTaskSwitchContext 选中它的时间，
+ *        单位是高精度时间（见 portHIGH_RES_COUNTS_PER_US）；优先级改变、换核等其他进出就绪队列不算唤醒
+ * @param ulCount 统计的唤醒次数，为0时 ulMin、ulMax 没有意义
+ * @param ulHistogram 第i个桶是 [2^i, 2^(i+1)) 个单位，第0个桶包括0，最后一个桶包括所有更长的
+ */
+typedef struct xTASK_WAKE_LATENCY
+{
+    uint32_t ulCount;
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint32_t ulHistogram[configWAKE_LATENCY_BUCKETS];
+} TaskWakeLatency_t;
+
+/* 读取任务的唤醒延迟统计，NULL表示当前任务 */
+void vTaskGetWakeLatency(TaskHandle_t xTask, TaskWakeLatency_t *const pxLatency);
+/* 清零任务的唤醒延迟统计，NULL表示当前任务；已唤醒还没运行的这一次仍会计入 */
+void vTaskResetWakeLatency(TaskHandle_t xTask);
+#endif
+
 #endif
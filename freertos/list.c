@@ -1,4 +1,5 @@
 #include "list.h"
+#include "task.h"   // configASSERT 用到 taskDISABLE_INTERRUPTS
 
 /*
  * @brief 初始化节点
@@ -7,7 +8,10 @@
  */
 void vListInitialiseItem(ListItem_t *const pxItem)
 {
-    pxItem->pvContainer = NULL;
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    configASSERT(listLINK_IN_RANGE(pxItem));
+    #endif
+    listCLEAR_CONTAINER(pxItem);
 };
 
 /*
@@ -17,13 +21,16 @@ void vListInitialiseItem(ListItem_t *const pxItem)
  */
 void vListInitialise(List_t *const pxList)
 {
-    pxList->pxIndex = (ListItem_t *)&(pxList->xListEnd); // 赋值item指针索引前三个变量，后面的pvOwner，pvContainer未定义
+    #if (configUSE_LIST_INDEX_LINKS == 1)
+    configASSERT(listLINK_IN_RANGE(pxList));
+    #endif
+    listSET_INDEX(pxList, &(pxList->xListEnd)); // 赋值item指针索引前三个变量，后面的pvOwner，pvContainer未定义
 
     pxList->uxNumberOfItems = (UBaseType_t)0U; // 0U中U表示无符号数，而不是0一样的默认为int的数值
 
     pxList->xListEnd.xItemValue = portMAX_DELAY;                 // 将链表最后一个节点的辅助排序的值设置为最大，确保该节点就是链表的最后节点
-    pxList->xListEnd.pxNext = (ListItem_t *)&(pxList->xListEnd); // 让末尾节点前后指向自身
-    pxList->xListEnd.pxPrevious = (ListItem_t *)&(pxList->xListEnd);
+    listSET_NEXT(&(pxList->xListEnd), &(pxList->xListEnd)); // 让末尾节点前后指向自身
+    listSET_PREVIOUS(&(pxList->xListEnd), &(pxList->xListEnd));
     // 只是指针赋值，后面可以强制转化，变成对应类型的数据，如MiniListItem_t ListItem_t，
     // MiniListItem_t指针赋值ListItem_t指针时，ListItem_t给只有在访问共享前缀变量时才是安全的
 }
@@ -36,14 +43,15 @@ void vListInitialise(List_t *const pxList)
  */
 void vListInsertEnd(List_t *const pxList, ListItem_t *const pxNewListItem)
 {
-    ListItem_t *const pxIndex = pxList->pxIndex;
+    ListItem_t *const pxIndex = listGET_INDEX(pxList);
+    ListItem_t *const pxPrevious = listGET_PREVIOUS(pxIndex);
 
-    pxNewListItem->pvContainer = (void *)pxList; // 根节点地址赋值新节点的容器指针，表示新节点是属于链表
+    listSET_CONTAINER(pxNewListItem, pxList); // 根节点地址赋值新节点的容器指针，表示新节点是属于链表
 
-    pxNewListItem->pxNext = pxIndex; // 节点插入
-    pxNewListItem->pxPrevious = pxIndex->pxPrevious;
-    pxIndex->pxPrevious->pxNext = pxNewListItem;
-    pxIndex->pxPrevious = pxNewListItem;
+    listSET_NEXT(pxNewListItem, pxIndex); // 节点插入
+    listSET_PREVIOUS(pxNewListItem, pxPrevious);
+    listSET_NEXT(pxPrevious, pxNewListItem);
+    listSET_PREVIOUS(pxIndex, pxNewListItem);
 
     (pxList->uxNumberOfItems)++;
 }
@@ -57,13 +65,14 @@ void vListInsertEnd(List_t *const pxList, ListItem_t *const pxNewListItem)
 void vListInsert(List_t *const pxList, ListItem_t *const pxNewListItem)
 {
     ListItem_t *pxIterator;
+    ListItem_t *pxNext;
     if (pxNewListItem->xItemValue == portMAX_DELAY)
     { // 如果辅助值极大，那插入根节点之前，可视作加在链表末尾。
-        pxIterator = (ListItem_t *)pxList->xListEnd.pxPrevious;
+        pxIterator = listGET_PREVIOUS(&(pxList->xListEnd));
     }
     else
     {
-        for (pxIterator = (ListItem_t *)&pxList->xListEnd; pxIterator->pxNext->xItemValue <= pxNewListItem->xItemValue; pxIterator = pxIterator->pxNext)
+        for (pxIterator = (ListItem_t *)&pxList->xListEnd; listGET_NEXT(pxIterator)->xItemValue <= pxNewListItem->xItemValue; pxIterator = listGET_NEXT(pxIterator))
         {
             /*
              * for(a;b;c){}: a->[b->{}->c]->[b->{}->c]->[b->{}->c]->......->b!->跳出
@@ -73,12 +82,114 @@ void vListInsert(List_t *const pxList, ListItem_t *const pxNewListItem)
         }
     }
 
-    pxNewListItem->pxNext = pxIterator->pxNext;
-    pxNewListItem->pxPrevious = pxIterator;
-    pxIterator->pxNext->pxPrevious = pxNewListItem;
-    pxIterator->pxNext = pxNewListItem;
+    pxNext = listGET_NEXT(pxIterator);
+    listSET_NEXT(pxNewListItem, pxNext);
+    listSET_PREVIOUS(pxNewListItem, pxIterator);
+    listSET_PREVIOUS(pxNext, pxNewListItem);
+    listSET_NEXT(pxIterator, pxNewListItem);
 
-    pxNewListItem->pvContainer = (void *)pxList;
+    listSET_CONTAINER(pxNewListItem, pxList);
+
+    (pxList->uxNumberOfItems)++;
+}
+
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxNewListItem 节点指针
+ * @discription 结果与 vListInsert 完全一样，只是查找方向由头尾节点的辅助值决定：
+ *              不小于尾节点的直接插在末尾，小于头节点的直接插在最前面，其余离头部近的从头往后找，离尾部近的从尾往前找
+ */
+void vListInsertBidirectional(List_t *const pxList, ListItem_t *const pxNewListItem)
+{
+    const TickType_t xValue = pxNewListItem->xItemValue;
+    ListItem_t *const pxEnd = (ListItem_t *)&(pxList->xListEnd);
+    ListItem_t *pxIterator = listGET_PREVIOUS(pxEnd);
+
+    if ((pxIterator == pxEnd) || (xValue >= pxIterator->xItemValue))
+    {   // 空链表或不小于尾节点，插在末尾
+    }
+    else if (xValue < listGET_HEAD_ENTRY(pxList)->xItemValue)
+    {   // 比头节点还小，插在最前面
+        pxIterator = pxEnd;
+    }
+    else
+    {
+        if ((TickType_t)(xValue - listGET_HEAD_ENTRY(pxList)->xItemValue) <= (TickType_t)(pxIterator->xItemValue - xValue))
+        {   // 从头往后找，与 vListInsert 一样停在最后一个不大于新值的节点上
+            for (pxIterator = pxEnd; listGET_NEXT(pxIterator)->xItemValue <= xValue; pxIterator = listGET_NEXT(pxIterator))
+            {
+            }
+        }
+        else
+        {   // 从尾往前找第一个不大于新值的节点，相等时新节点排在后面
+            do
+            {
+                pxIterator = listGET_PREVIOUS(pxIterator);
+            } while ((pxIterator != pxEnd) && (pxIterator->xItemValue > xValue));
+        }
+    }
+    vListInsertBefore(pxList, listGET_NEXT(pxIterator), pxNewListItem);
+}
+
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxHint 提示节点，从它开始查找，必须属于 pxList，为NULL时等同于 vListInsertBidirectional
+ * @param pxNewListItem 节点指针
+ * @discription 结果与 vListInsert 完全一样，新值不小于尾节点时直接插在末尾，否则不小于提示节点时往后找，小于时往前找，
+ *              新值与提示节点接近时（如连续插入相近的唤醒时间）只需要比较几次
+ */
+void vListInsertHinted(List_t *const pxList, ListItem_t *const pxHint, ListItem_t *const pxNewListItem)
+{
+    const TickType_t xValue = pxNewListItem->xItemValue;
+    ListItem_t *const pxEnd = (ListItem_t *)&(pxList->xListEnd);
+    ListItem_t *pxIterator = pxHint;
+
+    if (pxHint == NULL)
+    {
+        vListInsertBidirectional(pxList, pxNewListItem);
+        return;
+    }
+    configASSERT(listIS_CONTAINED_WITHIN(pxList, pxHint));
+    if (xValue >= listGET_PREVIOUS(pxEnd)->xItemValue)
+    {   // 不小于尾节点，不管提示在哪里都直接插在末尾
+        pxIterator = listGET_PREVIOUS(pxEnd);
+    }
+    else if (pxIterator->xItemValue <= xValue)
+    {   // 往后找，前面已经排除了插在末尾的情况，一定会停在末尾节点之前
+        while (listGET_NEXT(pxIterator)->xItemValue <= xValue)
+        {
+            pxIterator = listGET_NEXT(pxIterator);
+        }
+    }
+    else
+    {   // 往前找第一个不大于新值的节点
+        do
+        {
+            pxIterator = listGET_PREVIOUS(pxIterator);
+        } while ((pxIterator != pxEnd) && (pxIterator->xItemValue > xValue));
+    }
+    vListInsertBefore(pxList, listGET_NEXT(pxIterator), pxNewListItem);
+}
+
+/*
+ * @brief 插入节点
+ * @param pxList 链表指针
+ * @param pxPosition 插入位置，新节点插在它前面
+ * @param pxNewListItem 节点指针
+ * @discription 由调用者决定排序位置，插入本身和 vListInsert 找到位置后的操作一样
+ */
+void vListInsertBefore(List_t *const pxList, ListItem_t *const pxPosition, ListItem_t *const pxNewListItem)
+{
+    ListItem_t *const pxPrevious = listGET_PREVIOUS(pxPosition);
+
+    listSET_NEXT(pxNewListItem, pxPosition);
+    listSET_PREVIOUS(pxNewListItem, pxPrevious);
+    listSET_NEXT(pxPrevious, pxNewListItem);
+    listSET_PREVIOUS(pxPosition, pxNewListItem);
+
+    listSET_CONTAINER(pxNewListItem, pxList);
 
     (pxList->uxNumberOfItems)++;
 }
@@ -91,17 +202,19 @@ void vListInsert(List_t *const pxList, ListItem_t *const pxNewListItem)
  */
 UBaseType_t uxListRemove(ListItem_t *const pxItemToRemove)
 {
-    List_t *const pxList = (List_t *)pxItemToRemove->pvContainer; // 获取节点所属的链表
+    List_t *const pxList = listGET_CONTAINER(pxItemToRemove); // 获取节点所属的链表
+    ListItem_t *const pxNext = listGET_NEXT(pxItemToRemove);
+    ListItem_t *const pxPrevious = listGET_PREVIOUS(pxItemToRemove);
 
-    pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;     // 删除节点
-    pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious; // 删除节点
+    listSET_NEXT(pxPrevious, pxNext);     // 删除节点
+    listSET_PREVIOUS(pxNext, pxPrevious); // 删除节点
 
-    if (pxList->pxIndex == pxItemToRemove) // 如果删除的节点是索引节点，将索引节点指向前一个节点
+    if (listGET_INDEX(pxList) == pxItemToRemove) // 如果删除的节点是索引节点，将索引节点指向前一个节点
     {
-        pxList->pxIndex = pxItemToRemove->pxPrevious;
+        listSET_INDEX(pxList, pxPrevious);
     }
 
-    pxItemToRemove->pvContainer = NULL; // 删除节点
+    listCLEAR_CONTAINER(pxItemToRemove); // 删除节点
 
     (pxList->uxNumberOfItems)--; // 列表项数量减一
 
@@ -0,0 +1,350 @@
+#include "msgbus.h"
+
+#if (configUSE_MSGBUS == 1)
+
+/** 引用计数、空闲链与订阅者环都在临界区中修改，发布时对每个订阅者只是存一个指针、加一次引用，
+ *  临界区长度与订阅者个数成正比，与消息大小无关
+ */
+
+#define msgbusHEADER(pvMessage) ((MsgBufferHeader_t *)((uint8_t *)(pvMessage) - sizeof(MsgBufferHeader_t)))
+#define msgbusPAYLOAD(pxHeader) ((void *)((uint8_t *)(pxHeader) + sizeof(MsgBufferHeader_t)))
+
+/* 从空闲链取一块，必须在临界区中调用 */
+static void *prvTakeFreeBuffer(MsgPool_t *const pxPool)
+{
+    MsgBufferHeader_t *const pxHeader = pxPool->pxFreeList;
+
+    if (pxHeader == NULL)
+    {
+        return NULL;
+    }
+    pxPool->pxFreeList = pxHeader->pxNextFree;
+    if (--(pxPool->uxFree) < pxPool->uxMinFree)
+    {
+        pxPool->uxMinFree = pxPool->uxFree;
+    }
+    pxHeader->uxRefCount = (UBaseType_t)1;
+    pxHeader->xLength = (size_t)0;
+    return msgbusPAYLOAD(pxHeader);
+}
+
+/* 释放一个引用，最后一个释放时回到空闲链并唤醒等待缓冲区的任务，返回本核是否需要切换，必须在临界区中调用 */
+static BaseType_t prvReleaseBuffer(MsgBufferHeader_t *const pxHeader)
+{
+    MsgPool_t *const pxPool = pxHeader->pxPool;
+
+    configASSERT(pxHeader->uxRefCount > (UBaseType_t)0);
+    if (--(pxHeader->uxRefCount) != (UBaseType_t)0)
+    {
+        return pdFALSE;
+    }
+    pxHeader->pxNextFree = pxPool->pxFreeList;
+    pxPool->pxFreeList = pxHeader;
+    pxPool->uxFree++;
+    if (listLIST_IS_EMPTY(&(pxPool->xTasksWaitingForBuffer)) == pdFALSE)
+    {
+        return xTaskRemoveFromEventList(&(pxPool->xTasksWaitingForBuffer));
+    }
+    return pdFALSE;
+}
+
+/* 把消息交给每个订阅者并交出发布者的引用，返回收到的订阅者个数，必须在临界区中调用 */
+static UBaseType_t prvPublish(MsgTopic_t *const pxTopic, void *const pvMessage, const size_t xLength, BaseType_t *const pxYieldRequired)
+{
+    MsgBufferHeader_t *const pxHeader = msgbusHEADER(pvMessage);
+    MsgSubscriber_t *pxSubscriber;
+    UBaseType_t uxDelivered = (UBaseType_t)0;
+
+    configASSERT(xLength <= pxHeader->pxPool->xPayloadSize);
+    pxHeader->xLength = xLength;
+    for (pxSubscriber = pxTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext)
+    {
+        if (pxSubscriber->uxWaiting >= pxSubscriber->uxLength)
+        {
+            pxSubscriber->uxDropped++;
+            continue;
+        }
+        pxSubscriber->ppvRing[pxSubscriber->uxWriteIndex] = pvMessage;
+        if (++(pxSubscriber->uxWriteIndex) == pxSubscriber->uxLength)
+        {
+            pxSubscriber->uxWriteIndex = (UBaseType_t)0;
+        }
+        pxSubscriber->uxWaiting++;
+        pxHeader->uxRefCount++;
+        uxDelivered++;
+        if (listLIST_IS_EMPTY(&(pxSubscriber->xTasksWaitingToReceive)) == pdFALSE)
+        {
+            if (xTaskRemoveFromEventList(&(pxSubscriber->xTasksWaitingToReceive)) != pdFALSE)
+            {
+                *pxYieldRequired = pdTRUE;
+            }
+        }
+    }
+    // 交出发布者的引用，没有订阅者时缓冲区在这里回到缓冲池
+    if (prvReleaseBuffer(pxHeader) != pdFALSE)
+    {
+        *pxYieldRequired = pdTRUE;
+    }
+    return uxDelivered;
+}
+
+void vMsgPoolInitialise(MsgPool_t *const pxPool, uint64_t *const pullStorage, const UBaseType_t uxBlockCount, const size_t xPayloadSize)
+{
+    uint8_t *pucBlock = (uint8_t *)pullStorage;
+
+    configASSERT((pxPool != NULL) && (pullStorage != NULL) && (uxBlockCount > (UBaseType_t)0));
+    pxPool->pxFreeList = NULL;
+    pxPool->xBlockSize = msgbusBLOCK_SIZE(xPayloadSize);
+    pxPool->xPayloadSize = xPayloadSize;
+    pxPool->uxFree = uxBlockCount;
+    pxPool->uxMinFree = uxBlockCount;
+    vListInitialise(&(pxPool->xTasksWaitingForBuffer));
+    // 倒着串起来，第一次取到的是存储区开头的一块
+    pucBlock += (uxBlockCount - (UBaseType_t)1) * pxPool->xBlockSize;
+    for (UBaseType_t i = 0; i < uxBlockCount; i++)
+    {
+        MsgBufferHeader_t *const pxHeader = (MsgBufferHeader_t *)pucBlock;
+        pxHeader->pxPool = pxPool;
+        pxHeader->uxRefCount = (UBaseType_t)0;
+        pxHeader->pxNextFree = pxPool->pxFreeList;
+        pxPool->pxFreeList = pxHeader;
+        pucBlock -= pxPool->xBlockSize;
+    }
+}
+
+void *pvMsgBusAlloc(MsgPool_t *const pxPool, TickType_t xTicksToWait)
+{
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    void *pvMessage;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            pvMessage = prvTakeFreeBuffer(pxPool);
+            if (pvMessage != NULL)
+            {
+                taskEXIT_CRITICAL();
+                return pvMessage;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return NULL;
+            }
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return NULL;
+            }
+            vTaskPlaceOnEventList(&(pxPool->xTasksWaitingForBuffer), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+void *pvMsgBusAllocFromISR(MsgPool_t *const pxPool)
+{
+    void *pvMessage;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pvMessage = prvTakeFreeBuffer(pxPool);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return pvMessage;
+}
+
+void vMsgBusRetain(void *const pvMessage)
+{
+    MsgBufferHeader_t *const pxHeader = msgbusHEADER(pvMessage);
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT(pxHeader->uxRefCount > (UBaseType_t)0);
+        pxHeader->uxRefCount++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vMsgBusRelease(void *const pvMessage)
+{
+    taskENTER_CRITICAL();
+    {
+        if (prvReleaseBuffer(msgbusHEADER(pvMessage)) != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vMsgBusReleaseFromISR(void *const pvMessage, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if ((prvReleaseBuffer(msgbusHEADER(pvMessage)) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+}
+
+size_t xMsgBusGetLength(const void *const pvMessage)
+{
+    return msgbusHEADER(pvMessage)->xLength;
+}
+
+void vMsgTopicInitialise(MsgTopic_t *const pxTopic)
+{
+    pxTopic->pxSubscribers = NULL;
+    pxTopic->uxSubscriberCount = (UBaseType_t)0;
+}
+
+void vMsgBusSubscribe(MsgTopic_t *const pxTopic, MsgSubscriber_t *const pxSubscriber, void **const ppvRing, const UBaseType_t uxLength)
+{
+    configASSERT((ppvRing != NULL) && (uxLength > (UBaseType_t)0));
+    pxSubscriber->pxTopic = pxTopic;
+    pxSubscriber->ppvRing = ppvRing;
+    pxSubscriber->uxLength = uxLength;
+    pxSubscriber->uxWaiting = (UBaseType_t)0;
+    pxSubscriber->uxReadIndex = (UBaseType_t)0;
+    pxSubscriber->uxWriteIndex = (UBaseType_t)0;
+    pxSubscriber->uxDropped = (UBaseType_t)0;
+    vListInitialise(&(pxSubscriber->xTasksWaitingToReceive));
+
+    taskENTER_CRITICAL();
+    {
+        pxSubscriber->pxNext = pxTopic->pxSubscribers;
+        pxTopic->pxSubscribers = pxSubscriber;
+        pxTopic->uxSubscriberCount++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vMsgBusUnsubscribe(MsgSubscriber_t *const pxSubscriber)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        MsgSubscriber_t **ppxLink = &(pxSubscriber->pxTopic->pxSubscribers);
+
+        configASSERT(listLIST_IS_EMPTY(&(pxSubscriber->xTasksWaitingToReceive)) != pdFALSE);
+        while ((*ppxLink != NULL) && (*ppxLink != pxSubscriber))
+        {
+            ppxLink = &((*ppxLink)->pxNext);
+        }
+        if (*ppxLink != NULL)
+        {
+            *ppxLink = pxSubscriber->pxNext;
+            pxSubscriber->pxTopic->uxSubscriberCount--;
+        }
+        // 还没取走的消息占着引用
+        while (pxSubscriber->uxWaiting > (UBaseType_t)0)
+        {
+            if (prvReleaseBuffer(msgbusHEADER(pxSubscriber->ppvRing[pxSubscriber->uxReadIndex])) != pdFALSE)
+            {
+                xYieldRequired = pdTRUE;
+            }
+            if (++(pxSubscriber->uxReadIndex) == pxSubscriber->uxLength)
+            {
+                pxSubscriber->uxReadIndex = (UBaseType_t)0;
+            }
+            pxSubscriber->uxWaiting--;
+        }
+        pxSubscriber->pxNext = NULL;
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+UBaseType_t uxMsgBusPublish(MsgTopic_t *const pxTopic, void *const pvMessage, const size_t xLength)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxDelivered;
+
+    taskENTER_CRITICAL();
+    {
+        uxDelivered = prvPublish(pxTopic, pvMessage, xLength, &xYieldRequired);
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+    return uxDelivered;
+}
+
+UBaseType_t uxMsgBusPublishFromISR(MsgTopic_t *const pxTopic, void *const pvMessage, const size_t xLength, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxDelivered;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxDelivered = prvPublish(pxTopic, pvMessage, xLength, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return uxDelivered;
+}
+
+void *pvMsgBusReceive(MsgSubscriber_t *const pxSubscriber, TickType_t xTicksToWait)
+{
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    void *pvMessage;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxSubscriber->uxWaiting > (UBaseType_t)0)
+            {
+                pvMessage = pxSubscriber->ppvRing[pxSubscriber->uxReadIndex];
+                if (++(pxSubscriber->uxReadIndex) == pxSubscriber->uxLength)
+                {
+                    pxSubscriber->uxReadIndex = (UBaseType_t)0;
+                }
+                pxSubscriber->uxWaiting--;
+                taskEXIT_CRITICAL();
+                return pvMessage;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return NULL;
+            }
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return NULL;
+            }
+            vTaskPlaceOnEventList(&(pxSubscriber->xTasksWaitingToReceive), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+#endif /* configUSE_MSGBUS */
@@ -72,7 +72,7 @@
  *              当函数执行结束时(执行 BX LR):
  *                  就能跳回到调用者的位置继续执行，也就是说 LR = 返回地址
  *              如果用户任务不是无限循环的，那他执行完任务：
- *                  就会跳到任务退出错误函数prvTaskExitError里执行循环
+ *                  就会跳到任务退出错误函数vPortTaskExitError里执行循环
  *       4.r15（PC）用于控制程序流；
  */
 
@@ -121,7 +121,7 @@
 */
 #define portINITIAL_XPSR (0x01000000)
 
-static void prvTaskExitError(void)
+void vPortTaskExitError(void)
 {
     for (;;)
     {
@@ -130,6 +130,81 @@ static void prvTaskExitError(void)
 
 static UBaseType_t uxCriticalNesting = 0xaaaaaaaa; // 表示临界区嵌套了多少层
 
+#if (configUSE_CRITICAL_TIMING == 1)
+CriticalTiming_t xCriticalTiming;
+static uint32_t ulCriticalStart;    // 最外层临界区开始的时刻（CYCCNT）
+static uint32_t ulCriticalSite;     // 最外层 vPortEnterCritical 的返回地址
+
+/** 记录一次屏蔽中断的时长，调用时中断仍然屏蔽
+ *  调用点按返回地址开放寻址散列，空位的 ulSite 为0；表满后新的调用点只计入 ulOverflows 与全局最大值
+ */
+static void prvCriticalTimingRecord(const uint32_t ulSite, const uint32_t ulCycles)
+{
+    uint32_t ulIndex = (ulSite >> 1) & (configCRITICAL_TIMING_SITES - 1UL);
+    CriticalSite_t *pxSite = NULL;
+    uint32_t ulBucket;
+
+    if (ulCycles > xCriticalTiming.ulMaxCycles)
+    {
+        xCriticalTiming.ulMaxCycles = ulCycles;
+        xCriticalTiming.ulMaxSite = ulSite;
+    }
+    for (uint32_t ulProbes = 0; ulProbes < configCRITICAL_TIMING_SITES; ulProbes++)
+    {
+        if ((xCriticalTiming.xSites[ulIndex].ulSite == ulSite) || (xCriticalTiming.xSites[ulIndex].ulSite == 0UL))
+        {
+            pxSite = &(xCriticalTiming.xSites[ulIndex]);
+            break;
+        }
+        ulIndex = (ulIndex + 1UL) & (configCRITICAL_TIMING_SITES - 1UL);
+    }
+    if (pxSite == NULL)
+    {
+        xCriticalTiming.ulOverflows++;
+        return;
+    }
+    pxSite->ulSite = ulSite;
+    pxSite->ulCount++;
+    if (ulCycles > pxSite->ulMaxCycles)
+    {
+        pxSite->ulMaxCycles = ulCycles;
+    }
+    // 第i个桶是 [2^i, 2^(i+1)) 个周期，clz 是一条指令，最后一个桶包括所有更长的
+    ulBucket = 31UL - (uint32_t)__builtin_clz(ulCycles | 1UL);
+    if (ulBucket >= configCRITICAL_TIMING_BUCKETS)
+    {
+        ulBucket = configCRITICAL_TIMING_BUCKETS - 1UL;
+    }
+    pxSite->ulHistogram[ulBucket]++;
+}
+
+void vPortCriticalTimingReset(void)
+{
+    vPortEnterCritical();
+    {
+        uint32_t *pulWord = (uint32_t *)&xCriticalTiming;
+        for (uint32_t i = 0; i < sizeof(xCriticalTiming) / sizeof(uint32_t); i++)
+        {
+            pulWord[i] = 0UL;
+        }
+    }
+    vPortExitCritical();
+}
+
+void xPortPendSVHandler(void);
+
+/* PendSV 中 basepri 屏蔽期间只调用 vTaskSwitchContext，汇编改为调用这个函数，给它计时 */
+void vPortTimedSwitchContext(void)
+{
+    const uint32_t ulStart = portGET_HIGH_RES_TIME();
+    vTaskSwitchContext();
+    prvCriticalTimingRecord((uint32_t)xPortPendSVHandler, portGET_HIGH_RES_TIME() - ulStart);
+}
+#define portSWITCH_CONTEXT_FUNCTION "vPortTimedSwitchContext"
+#else
+#define portSWITCH_CONTEXT_FUNCTION "vTaskSwitchContext"
+#endif
+
 /* 初始化任务栈顶指针，添加任务函数的基础信息到栈上，以方便上下文转换 */
 StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,   // 函数栈顶指针
                                    TaskFunction_t pxCode,       // 任务函数指针    
@@ -140,23 +215,121 @@ StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,   // 函数栈顶
     pxTopOfStack--;                     
     *pxTopOfStack = (StackType_t)pxCode;    // R15 PC：任务函数指针，即函数entry入口
     pxTopOfStack--;     
-    *pxTopOfStack = (StackType_t)prvTaskExitError;  // R14 LR：不是无限循环的任务结束后，调转到这个函数继续运行
+    *pxTopOfStack = (StackType_t)vPortTaskExitError;  // R14 LR：不是无限循环的任务结束后，调转到这个函数继续运行
     pxTopOfStack -= 5;                              // R1 ~ R3 默认为零
     *pxTopOfStack = (StackType_t)pvParameters;
     pxTopOfStack -= 8;                              // R4 ~ R11 默认为零
     return pxTopOfStack;
 }
 
+#if (configUSE_SAMPLING_PROFILER == 1)
+ProfilerRing_t xProfilerRing;
+extern TaskHandle_t volatile pxCurrentTCB;
+
+/** 采样一次被打断的位置
+ *  调用者是最低优先级（与PendSV相同）的中断，打断的一定是Thread模式的任务，异常帧在PSP上；
+ *  不判断EXC_RETURN、不回溯栈，只有 mrs、两次读、两次写和下标运算，十来个周期
+ */
+void vPortProfilerSample(void)
+{
+    const uint32_t *pulFrame;
+    uint32_t ulIndex;
+
+    __asm volatile("mrs %0, psp" : "=r"(pulFrame));
+    ulIndex = xProfilerRing.ulCount & (configPROFILER_SAMPLE_COUNT - 1UL);
+    xProfilerRing.xSamples[ulIndex].ulPC = pulFrame[portPROFILER_STACKED_PC_INDEX];
+    xProfilerRing.xSamples[ulIndex].ulTask = (uint32_t)pxCurrentTCB;
+    xProfilerRing.ulCount++;
+}
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+#define portSCB_CFSR_REG (*((volatile uint32_t *)0xe000ed28))
+#define portSCB_HFSR_REG (*((volatile uint32_t *)0xe000ed2c))
+#define portSCB_MMFAR_REG (*((volatile uint32_t *)0xe000ed34))
+#define portSCB_BFAR_REG (*((volatile uint32_t *)0xe000ed38))
+#define portSCB_AIRCR_REG (*((volatile uint32_t *)0xe000ed0c))
+#define portSCB_AIRCR_SYSRESETREQ ((0x05faUL << 16UL) | (1UL << 2UL))
+
+__attribute__((section(".bss.noinit"))) PostMortem_t xPostMortem;
+#if (configUSE_SAMPLING_PROFILER == 0)
+extern TaskHandle_t volatile pxCurrentTCB;
+#endif
+
+/** 冻结故障现场，由 xPortHardFaultHandler 跳转过来，不返回
+ *  先写不需要访问故障栈的内容与 ulMagic，再读异常帧：栈指针已经坏了时读它会再次出错、锁死，
+ *  等看门狗复位后前面的内容还在
+ */
+void vPortPostMortemFault(const uint32_t *const pulFrame, const uint32_t ulExcReturn)
+{
+    portDISABLE_INTERRUPTS();
+    xPostMortem.ulTickCount = (uint32_t)xTaskGetTickCountFromISR();
+    xPostMortem.ulCurrentTask = (uint32_t)pxCurrentTCB;
+    xPostMortem.ulExcReturn = ulExcReturn;
+    xPostMortem.ulStackPointer = (uint32_t)pulFrame;
+    xPostMortem.ulCFSR = portSCB_CFSR_REG;
+    xPostMortem.ulHFSR = portSCB_HFSR_REG;
+    xPostMortem.ulMMFAR = portSCB_MMFAR_REG;
+    xPostMortem.ulBFAR = portSCB_BFAR_REG;
+    xPostMortem.ulStackCount = 0UL;
+    xPostMortem.ulMagic = postmortemMAGIC_FAULT;
+    __asm volatile("dsb" ::: "memory");
+
+    for (uint32_t i = 0; i < 8UL; i++)
+    {
+        xPostMortem.ulFrame[i] = pulFrame[i];
+    }
+    xPostMortem.ulStackCount = (uint32_t)uxTaskPostMortemStacks(xPostMortem.xStacks, (UBaseType_t)configPOST_MORTEM_TASKS);
+    __asm volatile("dsb" ::: "memory");
+
+    #if (configPOST_MORTEM_RESET == 1)
+    portSCB_AIRCR_REG = portSCB_AIRCR_SYSRESETREQ;
+    __asm volatile("dsb" ::: "memory");
+    #endif
+    for (;;)
+    {
+    }
+}
+
+/* HardFault：EXC_RETURN 第2位为1表示故障前用的是PSP（任务），否则是MSP（中断或启动代码），异常帧在那个栈上 */
+__attribute__((naked)) void xPortHardFaultHandler(void)
+{
+    __asm volatile
+    (
+        "tst lr, #4                             \n"
+        "ite eq                                 \n"
+        "mrseq r0, msp                          \n"
+        "mrsne r0, psp                          \n"
+        "mov r1, lr                             \n"
+        "b vPortPostMortemFault                 \n"
+    );
+}
+#endif
+
 /* systick中断处理函数，用去系统计时与触发任务切换也就是PenSV中断 */
 void xPortSysTickHandler()
 {
+    #if ((configUSE_SAMPLING_PROFILER == 1) && (configPROFILER_SAMPLE_IN_SYSTICK == 1))
+    vPortProfilerSample();
+    #endif
     portDISABLE_INTERRUPTS();
     {
+        #if (configUSE_CRITICAL_TIMING == 1)
+        const uint32_t ulStart = portGET_HIGH_RES_TIME();
+        #endif
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        // 单次定时模式下，一次中断可能对应多个tick，也可能只是一个高精度唤醒时刻，交给内核统一处理
+        if(xTaskHighResTimerHandler() != pdFALSE)
+        #else
         if(xTaskIncrementTick() != pdFALSE)
+        #endif
         {
             // 触发pendsv中断，尝试切换任务
             portYIELD();
         }
+        #if (configUSE_CRITICAL_TIMING == 1)
+        prvCriticalTimingRecord((uint32_t)xPortSysTickHandler, portGET_HIGH_RES_TIME() - ulStart);
+        #endif
     }
     portENABLE_INTERRUPTS();
 }
@@ -260,11 +433,51 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
     portNVIC_SYSTICK_CTRL_REG = 0UL;            // 清空系统时钟控制与状态寄存器
     portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;   // 清空当前计数器的值
     
+    #if (configUSE_HIGH_RES_TIMER == 1)
+    // 单次定时模式：先定一个tick之后的时刻，之后每次中断由内核根据最近的截止时间重新设置
+    vPortHighResTimerSetDeadline(portGET_HIGH_RES_TIME() + portHIGH_RES_COUNTS_PER_TICK);
+    #else
     // 我这里默认选这里系统时钟为cpu core时钟，cpu时钟频率为12MHz，要设置systick中断频率configTICK_RATE_HZ为100Hz，也就是10ms触发一次。
     portNVIC_SYSTICK_LOAD_REG = (configCPU_CLOCK_HZ / configTICK_RATE_HZ) - 1UL;
     // 设置systick时钟源为cpu core时钟，使能中断，使能systick开始计时
     portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
+    #endif
+}
+
+/** 启动DWT周期计数器
+ * @note 不清零CYCCNT，用户可以在main开头先调用一次来测量启动耗时，调度器启动时再调用也不影响计数
+ */
+void vPortHighResTimeInit(void)
+{
+    portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+    portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT;
+}
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+/** 把SysTick设置为单次定时
+ * @brief SysTick和CYCCNT都用cpu core时钟计数，所以截止时间与当前时间的差值就是LOAD值
+ * @note 重新写LOAD后必须写VAL清零，计数器才会从新的LOAD开始倒计时；
+ *       中断返回前内核总会重新设置，所以SysTick自动重装载并不会造成多余的周期中断
+ */
+void vPortHighResTimerSetDeadline(HighResTime_t xDeadline)
+{
+    HighResTime_t xCounts = xDeadline - portGET_HIGH_RES_TIME();
+
+    if ((int32_t)xCounts < (int32_t)portHIGH_RES_MIN_ONE_SHOT)
+    {   // 已经过期或太近，尽快触发
+        xCounts = portHIGH_RES_MIN_ONE_SHOT;
+    }
+    else if (xCounts > portHIGH_RES_MAX_ONE_SHOT)
+    {   // 24位LOAD放不下，先定最长时间，到时再由内核补算
+        xCounts = portHIGH_RES_MAX_ONE_SHOT;
+    }
+
+    portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT;   // 先停止计数
+    portNVIC_SYSTICK_LOAD_REG = xCounts - 1UL;
+    portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+    portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
 }
+#endif
 
 /** 启动调度器
  * @brief 启动调度器
@@ -308,6 +521,15 @@ BaseType_t xPortStartScheduler(void)
     portNVIC_SHPR2_REG = 0;                     // SVC 首任务初始化中断优先级设为最高
 
     vPortSetupTimerInterrupt();                 // 设置好systick 系统滴答计时中断
+    #if (configUSE_CRITICAL_TIMING == 1)
+    vPortHighResTimeInit();                     // 临界区计时用CYCCNT，嵌套为0之后才开始记录
+    #endif
+    #if (configUSE_POST_MORTEM == 1)
+    xPostMortem.ulSwitchSlots = configPOST_MORTEM_SWITCHES;     // 开始新的记录，上次的内容要在这之前取走
+    xPostMortem.ulStackSlots = configPOST_MORTEM_TASKS;
+    xPostMortem.ulSwitchCount = 0UL;
+    xPostMortem.ulMagic = postmortemMAGIC_RUNNING;
+    #endif
     uxCriticalNesting = 0;                      // 临界区嵌套初始化为0，没有嵌套
     prvPortStartFirstTask();                    // 启动调度器第一个任务，之后触发SVC中断
     return pdFALSE;                             // 若运行到这里代表出错了
@@ -328,6 +550,10 @@ void vPortEnterCritical(void)
         //       如果在<11的优先级中断中进入临界区，则不会出现问题
         //       但是11是用户定义的，操作系统只能完全禁止在中断中首次进入临界区
         configASSERT((portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK) == 0);
+        #if (configUSE_CRITICAL_TIMING == 1)
+        ulCriticalSite = (uint32_t)__builtin_return_address(0);
+        ulCriticalStart = portGET_HIGH_RES_TIME();
+        #endif
     }
 }
 
@@ -343,6 +569,9 @@ void vPortExitCritical(void)
     uxCriticalNesting--;
     if(uxCriticalNesting == 0)
     {
+        #if (configUSE_CRITICAL_TIMING == 1)
+        prvCriticalTimingRecord(ulCriticalSite, portGET_HIGH_RES_TIME() - ulCriticalStart);
+        #endif
         portENABLE_INTERRUPTS();
     }
 }
@@ -384,7 +613,7 @@ void xPortPendSVHandler()
         "stmdb sp!, {r3, r14}                   \n" // 根据MSP(目前是Handler模式)压栈
         "mov r0, %0                             \n" // 屏蔽低优先级中断，%0是占位符(如printf)，由::"i"后面的常量替换
         "msr basepri, r0                        \n" // 关中断，进入临界区，\muOs与rtthread是全部关掉
-        "bl vTaskSwitchContext                  \n" // 执行CurrentTCB的切换 
+        "bl " portSWITCH_CONTEXT_FUNCTION "       \n" // 执行CurrentTCB的切换 
         "mov r0, #0                             \n" // 所有中断不屏蔽
         "msr basepri, r0                        \n" // 开中断，出临界区
         "ldmia sp!, {r3, r14}                   \n"
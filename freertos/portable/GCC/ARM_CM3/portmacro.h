@@ -36,6 +36,10 @@ typedef unsigned long UBaseType_t;
 #if (configUSE_16_BIT_TICKS == 1)
 typedef uint16_t TickType_t;
 #define portMAX_DELAY (TickType_t)0xffff
+#elif (configUSE_64_BIT_TICKS == 1)
+/* cortex-m3 是32位的，64位读写要两条指令，中断可能在两条指令之间修改，任务中读取必须用 xTaskGetTickCount() */
+typedef uint64_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffffffffffULL
 #else
 typedef uint32_t TickType_t;
 #define portMAX_DELAY (TickType_t)0xffffffffUL
@@ -51,6 +55,22 @@ typedef uint32_t TickType_t;
         __asm volatile("isb");                          \
     }
 
+/** 条件成立时休眠到下一个中断，空闲任务使用
+ *  先用PRIMASK关中断再检查条件，检查之后来的中断只是挂起，照样能唤醒WFI，开中断后马上执行，不会睡过头；
+ *  dsb保证休眠前的写操作都已完成，isb保证开中断后挂起的中断先执行
+ */
+#define portWAIT_FOR_INTERRUPT_IF(xCondition)           \
+    {                                                   \
+        __asm volatile("cpsid i" ::: "memory");         \
+        if (xCondition)                                 \
+        {                                               \
+            __asm volatile("dsb" ::: "memory");         \
+            __asm volatile("wfi");                      \
+        }                                               \
+        __asm volatile("cpsie i" ::: "memory");         \
+        __asm volatile("isb");                          \
+    }
+
 /** SCB->ICSR(Interrupt control and state register) 寄存器，
  * 28位PENDSVSET写1表示，将PendSV异常状态更改为“待处理(挂起)”
  * 前8位置VECTACTIVE，有任何非零值时表示当前正在执行的中断服务程序；
@@ -59,9 +79,53 @@ typedef uint32_t TickType_t;
 #define portNVIC_PENDSVSET_BIT (1UL << 28UL)
 #define portVECTACTIVE_MASK (0xFFUL)
 
+/** DWT(Data Watchpoint and Trace) 周期计数器，作为高精度时间基准
+ * DEMCR 的 TRCENA 位使能 DWT/ITM 等调试跟踪模块，DWT_CTRL 的 CYCCNTENA 位使能周期计数器
+ * CYCCNT 每个cpu时钟加一，32位自由运行，12MHz时约357秒回绕一次，比较先后时必须用有符号差值
+ */
+#define portDEMCR_REG (*((volatile uint32_t *)0xe000edfc))
+#define portDEMCR_TRCENA_BIT (1UL << 24UL)
+#define portDWT_CTRL_REG (*((volatile uint32_t *)0xe0001000))
+#define portDWT_CYCCNTENA_BIT (1UL << 0UL)
+#define portDWT_CYCCNT_REG (*((volatile uint32_t *)0xe0001004))
+
+typedef uint32_t HighResTime_t;                                 // 高精度时间，单位是一个cpu时钟周期
+#define portGET_HIGH_RES_TIME() ((HighResTime_t)portDWT_CYCCNT_REG)
+#define portHIGH_RES_COUNTS_PER_US (configCPU_CLOCK_HZ / 1000000UL)
+#define portHIGH_RES_COUNTS_PER_TICK (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+#define portHIGH_RES_TIME_FROM_US(ulUs) ((HighResTime_t)(ulUs) * (HighResTime_t)portHIGH_RES_COUNTS_PER_US)
+#define portHIGH_RES_TIME_TO_US(xTime) ((uint32_t)(xTime) / (uint32_t)portHIGH_RES_COUNTS_PER_US)
+// SysTick 作单次定时器时的最长/最短定时，最长受24位LOAD寄存器限制，最短保证退出中断前不会再次触发
+#define portHIGH_RES_MAX_ONE_SHOT ((HighResTime_t)0x00ffffffUL)
+#define portHIGH_RES_MIN_ONE_SHOT ((HighResTime_t)64UL)
+
+/** 静态任务表用的初始栈帧，与 pxPortInitialiseStack 构造的完全一样，在编译时放进栈数组的初值里
+ *  uxTop 是8字节对齐后的栈顶下标，栈数组必须8字节对齐；xPSR、PC、LR、R0 之外的寄存器都为0，
+ *  LR 同样是 vPortTaskExitError：任务函数返回时停在那里的死循环中
+ *  pxTopOfStack = &栈数组[uxTop - portSTATIC_STACK_FRAME_WORDS]
+ */
+#define portSTATIC_STACK_TOP_INDEX(uxDepth) (((uxDepth) - 1U) & ~1U)
+#define portSTATIC_STACK_FRAME(uxTop, pxCode, pvParameters) \
+    [(uxTop) - 1U] = (StackType_t)0x01000000UL,             \
+    [(uxTop) - 2U] = (StackType_t)(pxCode),                 \
+    [(uxTop) - 3U] = (StackType_t)vPortTaskExitError,       \
+    [(uxTop) - 8U] = (StackType_t)(pvParameters)
+#define portSTATIC_STACK_FRAME_WORDS 16U
+
+/** 压缩链表链接的基地址，SRAM起始地址 0x20000000 再减一个对齐单位（下标0留给NULL），
+ *  32位tick时下标覆盖SRAM开头的256KB，16位tick时覆盖128KB
+ */
+#define portLIST_LINK_BASE (0x20000000UL - 4UL)
+
+/** 异常帧中被打断处PC的下标：硬件按 r0-r3、r12、lr、pc、xPSR 的顺序压栈，
+ *  采样剖析从PSP读出帧基址，取这一个字
+ */
+#define portPROFILER_STACKED_PC_INDEX 6U
+
 // port.c 定义
 extern void vPortEnterCritical(void);
 extern void vPortExitCritical(void);
+extern void vPortTaskExitError(void);
 
 // 临界区宏
 #define portSET_INTERRUPT_MASK_FROM_ISR() ulPortRaiseBASEPRI()
@@ -0,0 +1,204 @@
+#ifndef PORTMARCO_H
+#define PORTMARCO_H
+/*
+ *   FreeRTOS 都会将标准的 C 数据类型用 typedef 重新取一个类型名
+ */
+#include <stdint.h> // 获取标准库的 int32_t 和 uint32_t
+#include <stddef.h> // 获取标准库的 NULL 和 size_t
+
+/*
+ *  栈类型，栈单元的大小为 32 位，4字节
+ */
+#define portSTACK_TYPE uint32_t
+
+/*
+ * 表示这是一个无符号基础类型，常用于表示任务优先级、队列长度、信号量计数值等系统内核相关的无符号整数。
+ *   U	    Unsigned（无符号）
+ *   Base	基础类型（basic type），不依赖具体结构或平台
+ *   Type_t	类型后缀，表明这是一个通过 typedef 定义的标准类型
+ *   long    long的大小取决与平台，通常是32位或64位
+ */
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+/*
+ * 使用 #define（非类型安全）
+ *   #define TickType_t uint32_t
+ *   实际只是文本替换，编译器并不认为 TickType_t 是一个独立的类型。
+ *   你可以把它和 uint32_t 互换使用，即使逻辑上它们代表不同含义。
+ *   缺乏语义约束，容易造成类型混用。
+ * 使用 typedef（具备类型安全）
+ *   typedef uint32_t TickType_t;
+ *   TickType_t 被编译器视为 uint32_t 的别名，但它的出现增强了语义表达（例如表示系统节拍计数值）。
+ *   在一些编译器或静态分析工具中，可以基于该类型进行更精确的检查。
+ *   更利于后期重构和平台移植。
+ */
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#elif (configUSE_64_BIT_TICKS == 1)
+/* cortex-m4 是32位的，64位读写要两条指令，中断可能在两条指令之间修改，任务中读取必须用 xTaskGetTickCount() */
+typedef uint64_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffffffffffULL
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#endif
+
+// 触发 PendSV 中断
+// ❌ __asm volatile("dsb");	仅防止 CPU 流水线乱序，但编译器可能仍然优化重排内存访问
+// ✅ __asm volatile("dsb" ::: "memory");	同时防止编译器优化和 CPU 执行乱序，确保内存访问顺序不变
+#define portYIELD()                                     \
+    {                                                   \
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT; \
+        __asm volatile("dsb" ::: "memory");             \
+        __asm volatile("isb");                          \
+    }
+
+/** 条件成立时休眠到下一个中断，空闲任务使用
+ *  先用PRIMASK关中断再检查条件，检查之后来的中断只是挂起，照样能唤醒WFI，开中断后马上执行，不会睡过头；
+ *  dsb保证休眠前的写操作都已完成，isb保证开中断后挂起的中断先执行
+ */
+#define portWAIT_FOR_INTERRUPT_IF(xCondition)           \
+    {                                                   \
+        __asm volatile("cpsid i" ::: "memory");         \
+        if (xCondition)                                 \
+        {                                               \
+            __asm volatile("dsb" ::: "memory");         \
+            __asm volatile("wfi");                      \
+        }                                               \
+        __asm volatile("cpsie i" ::: "memory");         \
+        __asm volatile("isb");                          \
+    }
+
+/** SCB->ICSR(Interrupt control and state register) 寄存器，
+ * 28位PENDSVSET写1表示，将PendSV异常状态更改为“待处理(挂起)”
+ * 前8位置VECTACTIVE，有任何非零值时表示当前正在执行的中断服务程序；
+ */
+#define portNVIC_INT_CTRL_REG (*((volatile uint32_t *)0xe000ed04))
+#define portNVIC_PENDSVSET_BIT (1UL << 28UL)
+#define portVECTACTIVE_MASK (0xFFUL)
+
+/** DWT(Data Watchpoint and Trace) 周期计数器，作为高精度时间基准
+ * DEMCR 的 TRCENA 位使能 DWT/ITM 等调试跟踪模块，DWT_CTRL 的 CYCCNTENA 位使能周期计数器
+ * CYCCNT 每个cpu时钟加一，32位自由运行，12MHz时约357秒回绕一次，比较先后时必须用有符号差值
+ */
+#define portDEMCR_REG (*((volatile uint32_t *)0xe000edfc))
+#define portDEMCR_TRCENA_BIT (1UL << 24UL)
+#define portDWT_CTRL_REG (*((volatile uint32_t *)0xe0001000))
+#define portDWT_CYCCNTENA_BIT (1UL << 0UL)
+#define portDWT_CYCCNT_REG (*((volatile uint32_t *)0xe0001004))
+
+typedef uint32_t HighResTime_t;                                 // 高精度时间，单位是一个cpu时钟周期
+#define portGET_HIGH_RES_TIME() ((HighResTime_t)portDWT_CYCCNT_REG)
+#define portHIGH_RES_COUNTS_PER_US (configCPU_CLOCK_HZ / 1000000UL)
+#define portHIGH_RES_COUNTS_PER_TICK (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+#define portHIGH_RES_TIME_FROM_US(ulUs) ((HighResTime_t)(ulUs) * (HighResTime_t)portHIGH_RES_COUNTS_PER_US)
+#define portHIGH_RES_TIME_TO_US(xTime) ((uint32_t)(xTime) / (uint32_t)portHIGH_RES_COUNTS_PER_US)
+// SysTick 作单次定时器时的最长/最短定时，最长受24位LOAD寄存器限制，最短保证退出中断前不会再次触发
+#define portHIGH_RES_MAX_ONE_SHOT ((HighResTime_t)0x00ffffffUL)
+#define portHIGH_RES_MIN_ONE_SHOT ((HighResTime_t)64UL)
+
+/** 静态任务表用的初始栈帧，与 pxPortInitialiseStack 构造的完全一样，在编译时放进栈数组的初值里
+ *  uxTop 是8字节对齐后的栈顶下标，栈数组必须8字节对齐；xPSR、PC、LR、R0、EXC_RETURN 之外的寄存器都为0，
+ *  LR 同样是 vPortTaskExitError：任务函数返回时停在那里的死循环中
+ *  pxTopOfStack = &栈数组[uxTop - portSTATIC_STACK_FRAME_WORDS]
+ */
+#define portSTATIC_STACK_TOP_INDEX(uxDepth) (((uxDepth) - 1U) & ~1U)
+#define portSTATIC_STACK_FRAME(uxTop, pxCode, pvParameters) \
+    [(uxTop) - 1U] = (StackType_t)0x01000000UL,             \
+    [(uxTop) - 2U] = (StackType_t)(pxCode),                 \
+    [(uxTop) - 3U] = (StackType_t)vPortTaskExitError,       \
+    [(uxTop) - 8U] = (StackType_t)(pvParameters),           \
+    [(uxTop) - 9U] = (StackType_t)0xfffffffdUL
+#define portSTATIC_STACK_FRAME_WORDS 17U
+
+/** 压缩链表链接的基地址，SRAM起始地址 0x20000000 再减一个对齐单位（下标0留给NULL），
+ *  32位tick时下标覆盖SRAM开头的256KB，16位tick时覆盖128KB
+ */
+#define portLIST_LINK_BASE (0x20000000UL - 4UL)
+
+/** 异常帧中被打断处PC的下标：硬件按 r0-r3、r12、lr、pc、xPSR 的顺序压栈，浮点扩展帧的 s0-s15、FPSCR 在 xPSR 之后，不影响PC的位置，
+ *  采样剖析从PSP读出帧基址，取这一个字
+ */
+#define portPROFILER_STACKED_PC_INDEX 6U
+
+// port.c 定义
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+extern void vPortTaskExitError(void);
+
+// 临界区宏
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortRaiseBASEPRI()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortSetBASEPRI(x)
+#define portDISABLE_INTERRUPTS() vPortRaiseBASEPRI()
+#define portENABLE_INTERRUPTS() vPortSetBASEPRI(0)
+#define portENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#define portEXIT_CRITICAL_FROM_ISR(x) portCLEAR_INTERRUPT_MASK_FROM_ISR(x)
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+__attribute__((always_inline)) static inline uint8_t ucPortCountLeadingZeros(uint32_t ulBitmap)
+{
+    uint8_t ucReturn;
+    __asm volatile("clz %0, %1" : "=r"(ucReturn) : "r"(ulBitmap) : "memory");
+    return ucReturn;
+}
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) |= (1UL << (uxPriority))
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) &= ~(1UL << (uxPriority))
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    uxTopPriority = (31UL - (uint32_t)ucPortCountLeadingZeros((uxReadyPriorities)))
+// 强制内联，也就是复制代码到调用处，为什么要加__attribute__
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+/** 开启临界区，设置BASEPRI
+ * @note 不能用于中断，如果中断中使用，那中断结束后，basepri不能返回原值变成0
+ *       1.进入临界区后发生中断，如果中断号低于basepri，即优先级更高
+ *          意味着如果代码进入了临界区，同时发生此中断
+ *          这个中断结束后，原临界区就失效了（basepri变了）
+ *       2.如果中断号高于basepri，即优先级较低
+ *          意味着现在中断应该被屏蔽，此时如果有高优先级中断过来，
+ *          那高优先级中断运行完就不会返回低优先级中断，被卡死了
+ */
+portFORCE_INLINE static void vPortRaiseBASEPRI(void)
+{
+    uint32_t ulNewBASEPRI;
+    __asm volatile(
+        "mov %0, %1         \n"
+        "msr basepri, %0    \n"
+        "dsb                \n"
+        "isb                \n"
+        : "=r"(ulNewBASEPRI)
+        : "i"(configMAX_SYSCALL_INTERRUPT_PRIORITY)
+        : "memory");
+}
+
+/** 开启临界区，设置BASEPRI，返回原来的BASEPRI
+ * @return 原来的BASEPRI
+ */
+portFORCE_INLINE static uint32_t ulPortRaiseBASEPRI(void)
+{
+    uint32_t ulOriginalBASEPRI, ulNewBASEPRI;
+    __asm volatile(
+        "mrs %0, basepri                \n"
+        "mov %1, %2                     \n"
+        "msr basepri, %1                \n"
+        "dsb                            \n"
+        "isb                            \n"
+        : "=r"(ulOriginalBASEPRI), "=r"(ulNewBASEPRI)
+        : "i"(configMAX_SYSCALL_INTERRUPT_PRIORITY)
+        : "memory");
+    return ulOriginalBASEPRI;
+}
+
+portFORCE_INLINE static void vPortSetBASEPRI(uint32_t ulNewMaskValue)
+{
+    // 为什么不需要dsb，isb，.word, volatile
+    __asm volatile("msr basepri, %0" ::"r"(ulNewMaskValue) : "memory");
+}
+
+#endif
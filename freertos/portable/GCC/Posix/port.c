@@ -0,0 +1,353 @@
+/*linux主机上的模拟port，每个任务一个pthread*/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include "FreeRtos.h"
+#include "task.h"
+
+/** 模拟方法
+ *  1. 每个任务是一个线程，线程在 prvWaitForResume 中等待，被"放行"后才运行任务函数；
+ *     每个核同一时刻只放行一个线程，pxCoreThreads[] 记录每个核正在运行的线程
+ *  2. 任务切换：切出的线程调用 vTaskSwitchContext 选出本核的新任务，放行新任务的线程，然后自己等待被再次放行，
+ *     再次放行它的可能是另一个核（工作窃取），线程醒来时把 xPortCoreID 改成放行它的核
+ *  3. 中断：tick线程周期性调用 xTaskIncrementTick，相当于核0上的SysTick；
+ *     要某个核重新调度时，给那个核正在运行的线程发 SIGUSR1，信号处理函数里完成切换，相当于PendSV
+ *  4. 关中断就是屏蔽本线程的 SIGUSR1，临界区在此基础上再获取内核自旋锁，多个核的线程不会同时修改内核数据
+ */
+#define portYIELD_SIGNAL SIGUSR1
+
+typedef struct THREAD
+{
+    pthread_t xThread;
+    TaskFunction_t pxCode;          // 任务函数
+    void *pvParameters;             // 任务函数的参数
+    pthread_mutex_t xMutex;         // 保护 xResumed 与 xCoreID
+    pthread_cond_t xCond;
+    BaseType_t xResumed;            // 被放行
+    BaseType_t xCoreID;             // 放行它的核
+    BaseType_t xDeleted;            // 任务被删除，线程醒来后退出
+    BaseType_t xExited;             // 线程已经退出等待，不再访问线程信息
+} Thread_t;
+
+__thread BaseType_t xPortCoreID = 0;                        // 本线程代表的核
+volatile int lPortKernelLock = 0;                           // 内核自旋锁
+static __thread UBaseType_t uxCriticalNesting = 0;          // 每个线程各自的临界区嵌套层数
+static __thread Thread_t *pxThisThread = NULL;              // 本线程对应的任务线程信息，非任务线程为NULL
+static Thread_t *volatile pxCoreThreads[configNUMBER_OF_CORES];
+static sigset_t xYieldSignalSet;
+static volatile BaseType_t xPortRunning = pdFALSE;
+
+#if (configNUMBER_OF_CORES > 1)
+#define prvCurrentTaskOfCore(xCoreID) xTaskGetCurrentTaskHandleForCore(xCoreID)
+#else
+#define prvCurrentTaskOfCore(xCoreID) xTaskGetCurrentTaskHandle()
+#endif
+
+/* 任务控制块的第一个成员 pxTopOfStack 保存的就是 pxPortInitialiseStack 返回的线程信息地址 */
+static Thread_t *prvGetThread(TaskHandle_t xTask)
+{
+    return (Thread_t *)(*(StackType_t *volatile *)xTask);
+}
+
+/* 等待被放行，醒来后切换到放行它的核；任务被删除时线程在这里退出 */
+static void prvWaitForResume(Thread_t *const pxThread)
+{
+    pthread_mutex_lock(&(pxThread->xMutex));
+    while ((pxThread->xResumed == pdFALSE) && (pxThread->xDeleted == pdFALSE))
+    {
+        pthread_cond_wait(&(pxThread->xCond), &(pxThread->xMutex));
+    }
+    if (pxThread->xDeleted != pdFALSE)
+    {
+        pxThread->xExited = pdTRUE;
+        pthread_cond_broadcast(&(pxThread->xCond));
+        pthread_mutex_unlock(&(pxThread->xMutex));
+        pthread_exit(NULL);
+    }
+    pxThread->xResumed = pdFALSE;
+    xPortCoreID = pxThread->xCoreID;
+    pthread_mutex_unlock(&(pxThread->xMutex));
+}
+
+/* 在 xCoreID 核上放行线程，线程可能还没来得及等待（刚在另一个核上被切出），那它等待时会直接通过 */
+static void prvResume(Thread_t *const pxThread, const BaseType_t xCoreID)
+{
+    pthread_mutex_lock(&(pxThread->xMutex));
+    pxThread->xCoreID = xCoreID;
+    pxThread->xResumed = pdTRUE;
+    pthread_cond_signal(&(pxThread->xCond));
+    pthread_mutex_unlock(&(pxThread->xMutex));
+}
+
+static void *prvThreadStart(void *pvParameters)
+{
+    Thread_t *const pxThread = (Thread_t *)pvParameters;
+
+    pxThisThread = pxThread;
+    prvWaitForResume(pxThread);
+    // 放行者持有内核锁，新任务从临界区外开始运行
+    uxCriticalNesting = 0;
+    vPortEnableInterrupts();
+    pxThread->pxCode(pxThread->pvParameters);
+
+    // 任务函数不应该返回
+    configASSERT(0);
+    return NULL;
+}
+
+/** 初始化任务"栈"
+ *  在栈缓冲区顶部放线程信息，并创建线程，线程创建后先等待被放行
+ *  @return 线程信息地址，保存在 pxTopOfStack 中
+ */
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFunction_t pxCode,
+                                   void *pvParameters)
+{
+    Thread_t *pxThread = (Thread_t *)((((portPOINTER_SIZE_TYPE)(pxTopOfStack + 1)) - sizeof(Thread_t)) &
+                                      ~((portPOINTER_SIZE_TYPE)0x000f));
+    pthread_attr_t xAttr;
+    sigset_t xAllSignals, xOldSignals;
+
+    pxThread->pxCode = pxCode;
+    pxThread->pvParameters = pvParameters;
+    pxThread->xResumed = pdFALSE;
+    pxThread->xCoreID = 0;
+    pxThread->xDeleted = pdFALSE;
+    pxThread->xExited = pdFALSE;
+    pthread_mutex_init(&(pxThread->xMutex), NULL);
+    pthread_cond_init(&(pxThread->xCond), NULL);
+
+    // 新线程继承创建者的信号屏蔽字，先屏蔽全部信号，第一次运行时再打开 SIGUSR1，其他信号留给主线程
+    sigfillset(&xAllSignals);
+    pthread_sigmask(SIG_SETMASK, &xAllSignals, &xOldSignals);
+    pthread_attr_init(&xAttr);
+    pthread_attr_setdetachstate(&xAttr, PTHREAD_CREATE_DETACHED);
+    configASSERT(pthread_create(&(pxThread->xThread), &xAttr, prvThreadStart, pxThread) == 0);
+    pthread_attr_destroy(&xAttr);
+    pthread_sigmask(SIG_SETMASK, &xOldSignals, NULL);
+
+    return (StackType_t *)pxThread;
+}
+
+/** 删除任务的线程，任务已经切出，线程正在（或马上会在）prvWaitForResume 中等待
+ *  等线程退出后才返回，之后线程信息所在的栈缓冲区可以交给新任务
+ */
+void vPortDeleteThread(void *pvTaskHandle)
+{
+    Thread_t *const pxThread = prvGetThread((TaskHandle_t)pvTaskHandle);
+    sigset_t xOldSignals;
+
+    // 等待期间不响应切换信号，相当于关中断
+    pthread_sigmask(SIG_BLOCK, &xYieldSignalSet, &xOldSignals);
+    pthread_mutex_lock(&(pxThread->xMutex));
+    pxThread->xDeleted = pdTRUE;
+    pthread_cond_broadcast(&(pxThread->xCond));
+    while (pxThread->xExited == pdFALSE)
+    {
+        pthread_cond_wait(&(pxThread->xCond), &(pxThread->xMutex));
+    }
+    pthread_mutex_unlock(&(pxThread->xMutex));
+    pthread_mutex_destroy(&(pxThread->xMutex));
+    pthread_cond_destroy(&(pxThread->xCond));
+    pthread_sigmask(SIG_SETMASK, &xOldSignals, NULL);
+}
+
+/** 切换上下文，必须在临界区中调用
+ *  选出本核的新任务，放行它的线程，再让自己等待，等待前释放内核锁，醒来后重新获取
+ */
+static void prvSwitchContext(void)
+{
+    TaskHandle_t xOldTask = xTaskGetCurrentTaskHandle();
+    TaskHandle_t xNewTask;
+
+    vTaskSwitchContext();
+    xNewTask = xTaskGetCurrentTaskHandle();
+    if (xNewTask != xOldTask)
+    {
+        Thread_t *const pxOldThread = prvGetThread(xOldTask);
+        const BaseType_t xCoreID = portGET_CORE_ID();
+        const UBaseType_t uxSavedNesting = uxCriticalNesting;
+
+        configASSERT(pxOldThread == pxThisThread);
+        pxCoreThreads[xCoreID] = prvGetThread(xNewTask);
+        prvResume(pxCoreThreads[xCoreID], xCoreID);
+
+        uxCriticalNesting = 0;
+        portRELEASE_KERNEL_LOCK();
+        prvWaitForResume(pxOldThread);
+        portGET_KERNEL_LOCK();
+        uxCriticalNesting = uxSavedNesting;
+    }
+}
+
+/* SIGUSR1 处理函数，相当于PendSV，处理期间 SIGUSR1 被自动屏蔽 */
+static void prvYieldSignalHandler(int lSignal)
+{
+    (void)lSignal;
+    if ((pxThisThread == NULL) || (uxCriticalNesting != 0))
+    {   // 非任务线程，或者临界区中（信号被屏蔽时不会发生），忽略
+        return;
+    }
+    uxCriticalNesting = 1;
+    portGET_KERNEL_LOCK();
+    prvSwitchContext();
+    uxCriticalNesting = 0;
+    portRELEASE_KERNEL_LOCK();
+}
+
+void vPortYield(void)
+{
+    vPortEnterCritical();
+    prvSwitchContext();
+    vPortExitCritical();
+}
+
+/* 睡一个tick周期，SIGUSR1 会打断 nanosleep，相当于被中断唤醒；多核时空闲的核醒来后还要检查能不能窃取任务 */
+void vPortWaitForInterrupt(void)
+{
+    const struct timespec xTickPeriod = {0, 1000000000L / configTICK_RATE_HZ};
+
+    (void)nanosleep(&xTickPeriod, NULL);
+}
+
+/* 通知 xCoreID 核重新调度，发给本核时信号被屏蔽，退出临界区后才会处理 */
+void vPortYieldCore(BaseType_t xCoreID)
+{
+    Thread_t *const pxThread = pxCoreThreads[xCoreID];
+    if ((xPortRunning != pdFALSE) && (pxThread != NULL))
+    {
+        pthread_kill(pxThread->xThread, portYIELD_SIGNAL);
+    }
+}
+
+void vPortDisableInterrupts(void)
+{
+    pthread_sigmask(SIG_BLOCK, &xYieldSignalSet, NULL);
+}
+
+void vPortEnableInterrupts(void)
+{
+    pthread_sigmask(SIG_UNBLOCK, &xYieldSignalSet, NULL);
+}
+
+/** 进入临界区
+ * @note 先关中断再加锁，持有锁的线程不会被信号打断去切换任务，否则别的核会一直自旋
+ */
+void vPortEnterCritical(void)
+{
+    vPortDisableInterrupts();
+    if (uxCriticalNesting == 0)
+    {
+        portGET_KERNEL_LOCK();
+    }
+    uxCriticalNesting++;
+}
+
+/* 退出临界区，回到第一层时释放内核锁并开中断，挂起的 SIGUSR1 在这里被处理 */
+void vPortExitCritical(void)
+{
+    configASSERT(uxCriticalNesting);
+    uxCriticalNesting--;
+    if (uxCriticalNesting == 0)
+    {
+        portRELEASE_KERNEL_LOCK();
+        vPortEnableInterrupts();
+    }
+}
+
+/* 模拟的中断里也要拿内核锁，直接用临界区 */
+UBaseType_t uxPortSetInterruptMaskFromISR(void)
+{
+    vPortEnterCritical();
+    return (UBaseType_t)0;
+}
+
+void vPortClearInterruptMaskFromISR(UBaseType_t uxSavedStatus)
+{
+    (void)uxSavedStatus;
+    vPortExitCritical();
+}
+
+/* 主机时钟一直在走，不需要启动 */
+void vPortHighResTimeInit(void)
+{
+}
+
+/* 高精度时间，纳秒，32位回绕 */
+HighResTime_t xPortGetHighResTime(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return (HighResTime_t)((uint64_t)xNow.tv_sec * 1000000000ULL + (uint64_t)xNow.tv_nsec);
+}
+
+/* tick线程，相当于核0上的SysTick中断，按绝对时间睡眠，不会累计误差 */
+static void *prvTickThread(void *pvParameters)
+{
+    struct timespec xNext;
+
+    (void)pvParameters;
+    xPortCoreID = 0;
+    clock_gettime(CLOCK_MONOTONIC, &xNext);
+    for (;;)
+    {
+        xNext.tv_nsec += 1000000000L / configTICK_RATE_HZ;
+        if (xNext.tv_nsec >= 1000000000L)
+        {
+            xNext.tv_nsec -= 1000000000L;
+            xNext.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL) != 0)
+        {
+        }
+
+        vPortEnterCritical();
+        if (xTaskIncrementTick() != pdFALSE)
+        {
+            vPortYieldCore(0);
+        }
+        vPortExitCritical();
+    }
+    return NULL;
+}
+
+/** 启动调度器
+ * @brief 安装信号处理函数，创建tick线程，放行每个核的第一个任务，主线程之后只等待
+ * @note 正常情况下不会返回
+ */
+BaseType_t xPortStartScheduler(void)
+{
+    struct sigaction xAction;
+    sigset_t xAllSignals;
+    pthread_t xTickThread;
+
+    sigemptyset(&xYieldSignalSet);
+    sigaddset(&xYieldSignalSet, portYIELD_SIGNAL);
+    xAction.sa_handler = prvYieldSignalHandler;
+    xAction.sa_flags = SA_RESTART;
+    sigfillset(&(xAction.sa_mask));
+    sigaction(portYIELD_SIGNAL, &xAction, NULL);
+
+    sigfillset(&xAllSignals);
+    pthread_sigmask(SIG_SETMASK, &xAllSignals, NULL);
+    if (pthread_create(&xTickThread, NULL, prvTickThread, NULL) != 0)
+    {
+        return pdFALSE;
+    }
+
+    vPortEnterCritical();
+    {
+        xPortRunning = pdTRUE;
+        for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
+        {
+            pxCoreThreads[xCoreID] = prvGetThread(prvCurrentTaskOfCore(xCoreID));
+            prvResume(pxCoreThreads[xCoreID], xCoreID);
+        }
+    }
+    vPortExitCritical();
+
+    pthread_join(xTickThread, NULL);
+    return pdFALSE;
+}
@@ -0,0 +1,125 @@
+#ifndef PORTMARCO_H
+#define PORTMARCO_H
+/*
+ *   linux 主机上的模拟port，每个任务是一个 pthread，每个"核"同一时刻只放行一个任务线程运行
+ *   用于在主机上开发与压力测试调度器，特别是 configNUMBER_OF_CORES > 1 的SMP模式
+ *   编译：gcc -pthread -Ifreertos/include -Ifreertos/portable/GCC/Posix freertos/list.c freertos/task.c freertos/portable/GCC/Posix/port.c user/xxx.c
+ */
+#include <stdint.h> // 获取标准库的 int32_t 和 uint32_t
+#include <stddef.h> // 获取标准库的 NULL 和 size_t
+#include <sched.h>  // sched_yield，自旋等待时让出主机cpu
+
+/*
+ *  栈类型，与指针一样宽。任务的"栈"只用来存放线程信息，真正的栈由pthread分配
+ */
+#define portSTACK_TYPE uintptr_t
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#elif (configUSE_64_BIT_TICKS == 1)
+typedef uint64_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffffffffffULL
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#endif
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+#error "Posix port 没有单次定时器，不支持 configUSE_HIGH_RES_TIMER"
+#endif
+
+#if (configUSE_CRITICAL_TIMING == 1)
+#error "Posix port 的临界区是屏蔽信号，不是屏蔽中断，不支持 configUSE_CRITICAL_TIMING"
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+#error "Posix port 没有 HardFault 与复位后保留的内存，不支持 configUSE_POST_MORTEM"
+#endif
+
+// 高精度时间基准用主机的 CLOCK_MONOTONIC，单位是纳秒，只用来测量耗时
+typedef uint32_t HighResTime_t;
+extern HighResTime_t xPortGetHighResTime(void);
+#define portGET_HIGH_RES_TIME() xPortGetHighResTime()
+#define portHIGH_RES_COUNTS_PER_US 1000UL
+#define portHIGH_RES_TIME_TO_US(xTime) ((uint32_t)(xTime) / (uint32_t)portHIGH_RES_COUNTS_PER_US)
+
+// 线程的任务切换，相当于触发 PendSV
+extern void vPortYield(void);
+#define portYIELD() vPortYield()
+
+// 删除任务时结束它的线程，等线程退出后栈缓冲区才能复用
+extern void vPortDeleteThread(void *pvTaskHandle);
+#define portCLEAN_UP_TCB(pxTCB) vPortDeleteThread((void *)(pxTCB))
+
+// 条件成立时休眠，最多一个tick周期，收到切换信号时提前醒来，相当于WFI
+extern void vPortWaitForInterrupt(void);
+#define portWAIT_FOR_INTERRUPT_IF(xCondition) \
+    {                                         \
+        if (xCondition)                       \
+        {                                     \
+            vPortWaitForInterrupt();          \
+        }                                     \
+    }
+
+/** "中断"就是发给任务线程的 SIGUSR1 信号，屏蔽信号就是关中断
+ *  临界区：屏蔽本线程的信号，第一层时再获取内核自旋锁，其他核的线程在锁上自旋等待
+ */
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+extern void vPortDisableInterrupts(void);
+extern void vPortEnableInterrupts(void);
+extern UBaseType_t uxPortSetInterruptMaskFromISR(void);
+extern void vPortClearInterruptMaskFromISR(UBaseType_t uxSavedStatus);
+
+#define portSET_INTERRUPT_MASK_FROM_ISR() uxPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortClearInterruptMaskFromISR(x)
+#define portDISABLE_INTERRUPTS() vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS() vPortEnableInterrupts()
+#define portENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#define portEXIT_CRITICAL_FROM_ISR(x) portCLEAR_INTERRUPT_MASK_FROM_ISR(x)
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+/** 多核支持
+ *  portGET_CORE_ID     当前线程代表的核，任务线程每次被放行时由放行它的核写入，tick线程代表核0
+ *  portYIELD_CORE      让某个核重新调度，相当于核间中断，本核调用时在退出临界区后生效
+ *  portGET/RELEASE_KERNEL_LOCK 内核自旋锁，只在 vPortEnter/ExitCritical 中使用，不能递归
+ */
+extern __thread BaseType_t xPortCoreID;
+#define portGET_CORE_ID() (xPortCoreID)
+extern void vPortYieldCore(BaseType_t xCoreID);
+#define portYIELD_CORE(xCoreID) vPortYieldCore(xCoreID)
+
+extern volatile int lPortKernelLock;
+#define portGET_KERNEL_LOCK()                                            \
+    do                                                                   \
+    {                                                                    \
+        while (__atomic_exchange_n(&lPortKernelLock, 1, __ATOMIC_ACQUIRE)) \
+        {                                                                \
+            while (__atomic_load_n(&lPortKernelLock, __ATOMIC_RELAXED))  \
+            {                                                            \
+                sched_yield();                                           \
+            }                                                            \
+        }                                                                \
+    } while (0)
+#define portRELEASE_KERNEL_LOCK() __atomic_store_n(&lPortKernelLock, 0, __ATOMIC_RELEASE)
+
+// 用gcc内建函数代替clz指令，UBaseType_t 在64位主机上是64位
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) |= (1UL << (uxPriority))
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) &= ~(1UL << (uxPriority))
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    uxTopPriority = ((sizeof(UBaseType_t) * 8UL - 1UL) - (UBaseType_t)__builtin_clzl((uxReadyPriorities)))
+
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#endif
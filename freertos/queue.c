@@ -0,0 +1,298 @@
+#include <string.h>
+#include "queue.h"
+
+#if (configUSE_QUEUES == 1)
+
+/** 队列操作都在临界区中完成：检查、拷贝、唤醒等待者；需要阻塞时在临界区中挂到等待链表并让出，
+ *  cortex-m3上PendSV在退出临界区后才发生。被唤醒后回到循环开头重新检查，
+ *  条件仍不满足（被别的任务抢先取走）时按剩余的等待时间再次阻塞
+ */
+
+static void prvCopyDataToQueue(StaticQueue_t *const pxQueue, const void *const pvItemToQueue)
+{
+    if (pxQueue->uxItemSize != (UBaseType_t)0)
+    {
+        (void)memcpy(&(pxQueue->pucStorage[pxQueue->uxWriteIndex * pxQueue->uxItemSize]), pvItemToQueue, (size_t)pxQueue->uxItemSize);
+        if (++(pxQueue->uxWriteIndex) == pxQueue->uxLength)
+        {
+            pxQueue->uxWriteIndex = (UBaseType_t)0;
+        }
+    }
+    pxQueue->uxMessagesWaiting++;
+}
+
+static void prvCopyDataFromQueue(StaticQueue_t *const pxQueue, void *const pvBuffer)
+{
+    if (pxQueue->uxItemSize != (UBaseType_t)0)
+    {
+        (void)memcpy(pvBuffer, &(pxQueue->pucStorage[pxQueue->uxReadIndex * pxQueue->uxItemSize]), (size_t)pxQueue->uxItemSize);
+        if (++(pxQueue->uxReadIndex) == pxQueue->uxLength)
+        {
+            pxQueue->uxReadIndex = (UBaseType_t)0;
+        }
+    }
+    pxQueue->uxMessagesWaiting--;
+}
+
+#if (configUSE_QUEUE_SETS == 1)
+/* 成员有了新数据，把成员句柄发送到集合，唤醒等待集合的任务，返回本核是否需要切换 */
+static BaseType_t prvNotifyQueueSetContainer(const StaticQueue_t *const pxQueue)
+{
+    StaticQueue_t *const pxQueueSet = pxQueue->pxQueueSetContainer;
+
+    // 集合长度不小于成员长度之和时不会满
+    configASSERT(pxQueueSet->uxMessagesWaiting < pxQueueSet->uxLength);
+    prvCopyDataToQueue(pxQueueSet, &pxQueue);
+    if (listLIST_IS_EMPTY(&(pxQueueSet->xTasksWaitingToReceive)) == pdFALSE)
+    {
+        return xTaskRemoveFromEventList(&(pxQueueSet->xTasksWaitingToReceive));
+    }
+    return pdFALSE;
+}
+#endif
+
+/* 写入数据后通知接收方：在集合中的成员通知集合，否则唤醒等待接收的任务，返回本核是否需要切换 */
+static BaseType_t prvNotifyReceiver(StaticQueue_t *const pxQueue)
+{
+    #if (configUSE_QUEUE_SETS == 1)
+    if (pxQueue->pxQueueSetContainer != NULL)
+    {
+        return prvNotifyQueueSetContainer(pxQueue);
+    }
+    #endif
+    if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) == pdFALSE)
+    {
+        return xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToReceive));
+    }
+    return pdFALSE;
+}
+
+/* 取出数据后唤醒等待发送的任务，返回本核是否需要切换 */
+static BaseType_t prvNotifySender(StaticQueue_t *const pxQueue)
+{
+    if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToSend)) == pdFALSE)
+    {
+        return xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend));
+    }
+    return pdFALSE;
+}
+
+QueueHandle_t xQueueCreateStatic(const UBaseType_t uxQueueLength,
+                                 const UBaseType_t uxItemSize,
+                                 uint8_t *const pucQueueStorage,
+                                 StaticQueue_t *const pxStaticQueue)
+{
+    StaticQueue_t *const pxQueue = pxStaticQueue;
+
+    configASSERT(pxQueue != NULL);
+    configASSERT(uxQueueLength > (UBaseType_t)0);
+    configASSERT((uxItemSize == (UBaseType_t)0) || (pucQueueStorage != NULL));
+    pxQueue->pucStorage = pucQueueStorage;
+    pxQueue->uxLength = uxQueueLength;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->uxMessagesWaiting = (UBaseType_t)0;
+    pxQueue->uxReadIndex = (UBaseType_t)0;
+    pxQueue->uxWriteIndex = (UBaseType_t)0;
+    vListInitialise(&(pxQueue->xTasksWaitingToSend));
+    vListInitialise(&(pxQueue->xTasksWaitingToReceive));
+    #if (configUSE_QUEUE_SETS == 1)
+    pxQueue->pxQueueSetContainer = NULL;
+    #endif
+    return pxQueue;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphoreStatic(const UBaseType_t uxMaxCount,
+                                                  const UBaseType_t uxInitialCount,
+                                                  StaticQueue_t *const pxStaticQueue)
+{
+    QueueHandle_t xQueue;
+
+    configASSERT(uxInitialCount <= uxMaxCount);
+    xQueue = xQueueCreateStatic(uxMaxCount, (UBaseType_t)0, NULL, pxStaticQueue);
+    xQueue->uxMessagesWaiting = uxInitialCount;
+    return xQueue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *const pvItemToQueue, TickType_t xTicksToWait)
+{
+    StaticQueue_t *const pxQueue = xQueue;
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+            {
+                prvCopyDataToQueue(pxQueue, pvItemToQueue);
+                if (prvNotifyReceiver(pxQueue) != pdFALSE)
+                {
+                    taskYIELD();
+                }
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToSend), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *const pvBuffer, TickType_t xTicksToWait)
+{
+    StaticQueue_t *const pxQueue = xQueue;
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxQueue->uxMessagesWaiting > (UBaseType_t)0)
+            {
+                prvCopyDataFromQueue(pxQueue, pvBuffer);
+                if (prvNotifySender(pxQueue) != pdFALSE)
+                {
+                    taskYIELD();
+                }
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *const pvItemToQueue, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    StaticQueue_t *const pxQueue = xQueue;
+    BaseType_t xReturn = errQUEUE_FULL;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+        {
+            prvCopyDataToQueue(pxQueue, pvItemToQueue);
+            if ((prvNotifyReceiver(pxQueue) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return xReturn;
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *const pvBuffer, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    StaticQueue_t *const pxQueue = xQueue;
+    BaseType_t xReturn = errQUEUE_EMPTY;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxQueue->uxMessagesWaiting > (UBaseType_t)0)
+        {
+            prvCopyDataFromQueue(pxQueue, pvBuffer);
+            if ((prvNotifySender(pxQueue) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return xReturn;
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    return xQueue->uxMessagesWaiting;
+}
+
+#if (configUSE_QUEUE_SETS == 1)
+QueueSetHandle_t xQueueCreateSetStatic(const UBaseType_t uxEventQueueLength,
+                                       uint8_t *const pucQueueStorage,
+                                       StaticQueue_t *const pxStaticQueue)
+{
+    return xQueueCreateStatic(uxEventQueueLength, (UBaseType_t)sizeof(QueueSetMemberHandle_t), pucQueueStorage, pxStaticQueue);
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet)
+{
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        // 加入前已有的数据不会通知集合，所以只能加入空的成员
+        if ((xQueueOrSemaphore->pxQueueSetContainer == NULL) && (xQueueOrSemaphore->uxMessagesWaiting == (UBaseType_t)0))
+        {
+            xQueueOrSemaphore->pxQueueSetContainer = xQueueSet;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet)
+{
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        // 还有数据时集合里还有它的句柄，移出后会被选中却取不到数据
+        if ((xQueueOrSemaphore->pxQueueSetContainer == xQueueSet) && (xQueueOrSemaphore->uxMessagesWaiting == (UBaseType_t)0))
+        {
+            xQueueOrSemaphore->pxQueueSetContainer = NULL;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet, const TickType_t xTicksToWait)
+{
+    QueueSetMemberHandle_t xMember = NULL;
+
+    (void)xQueueReceive(xQueueSet, &xMember, xTicksToWait);
+    return xMember;
+}
+#endif /* configUSE_QUEUE_SETS */
+
+#endif /* configUSE_QUEUES */
@@ -12,12 +12,12 @@
     do                                                                                  \
     {                                                                                   \
         UBaseType_t uxTopPriority = uxTopReadyPriority;                                 \
-        while (listLIST_IS_EMPTY(&(pxReadyTasksLists[uxTopPriority])))                  \
+        while (taskREADY_QUEUE_IS_EMPTY(&(pxReadyTasksLists[uxTopPriority])))           \
         {                                                                               \
             configASSERT(uxTopPriority);                                                \
             --uxTopPriority;                                                            \
         }                                                                               \
-        listGET_OWNER_OF_NEXT_ENTRY(pxCurrentTCB, &(pxReadyTasksLists[uxTopPriority])); \
+        taskREADY_QUEUE_GET_NEXT_OWNER(pxCurrentTCB, &(pxReadyTasksLists[uxTopPriority])); \
         uxTopReadyPriority = uxTopPriority;                                             \
     } while (0)
 #else  // 如果不是用硬件优化的方法确定目前最高优先级
@@ -37,19 +37,108 @@
     {                                                                                   \
         UBaseType_t uxTopPriority;                                                      \
         portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);                    \
-        configASSERT(listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[uxTopPriority])) > 0); \
-        listGET_OWNER_OF_NEXT_ENTRY(pxCurrentTCB, &(pxReadyTasksLists[uxTopPriority])); \
+        configASSERT(taskREADY_QUEUE_LENGTH(&(pxReadyTasksLists[uxTopPriority])) > 0);  \
+        taskREADY_QUEUE_GET_NEXT_OWNER(pxCurrentTCB, &(pxReadyTasksLists[uxTopPriority])); \
     } while (0)
 #define taskRESET_READY_PRIORITY(uxPriority)                                               \
     do                                                                                     \
     {                                                                                      \
-        if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[(uxPriority)])) == (UBaseType_t)0) \
+        if (taskREADY_QUEUE_LENGTH(&(pxReadyTasksLists[(uxPriority)])) == (UBaseType_t)0)  \
         {                                                                                  \
             portRESET_READY_PRIORITY((uxPriority), (uxTopReadyPriority));                  \
         }                                                                                  \
     } while (0)
 #endif  // 用硬件优化的方法确定目前的最高优先级，同时还有更多的功能，比如确定某一优先级就绪队列是否存在任务
 
+#if (configNUMBER_OF_CORES > 1)
+/** 多核时每个核有自己的就绪队列与就绪优先级位图，任务挂在 xCoreID 核的就绪队列上，只会被这个核选中；
+ *  正在运行的任务一定挂在本核的就绪队列上，所以下面这些名字在多核时都指本核的数据，单核代码不用修改
+ */
+#define pxCurrentTCB (pxCurrentTCBs[portGET_CORE_ID()])
+#define pxReadyTasksLists (pxReadyTasksListsByCore[portGET_CORE_ID()])
+#define uxTopReadyPriority (uxTopReadyPriorityByCore[portGET_CORE_ID()])
+// 任意任务（不一定在本核）所在核的就绪队列与位图
+#define taskREADY_LISTS_OF(pxTCB) (pxReadyTasksListsByCore[(pxTCB)->xCoreID])
+#define taskTOP_READY_PRIORITY_OF(pxTCB) (uxTopReadyPriorityByCore[(pxTCB)->xCoreID])
+#define taskRECORD_TASK_READY_PRIORITY(pxTCB) portRECORD_READY_PRIORITY((pxTCB)->uxPriority, taskTOP_READY_PRIORITY_OF(pxTCB))
+#define taskALL_CORES_MASK ((UBaseType_t)((1UL << configNUMBER_OF_CORES) - 1UL))
+// 任务创建或解阻塞时重新选核
+#define taskSELECT_CORE_FOR_TASK(pxTCB) ((pxTCB)->xCoreID = prvSelectCoreForTask(pxTCB))
+#else
+#define taskSELECT_CORE_FOR_TASK(pxTCB)
+#define taskREADY_LISTS_OF(pxTCB) (pxReadyTasksLists)
+#define taskTOP_READY_PRIORITY_OF(pxTCB) (uxTopReadyPriority)
+#define taskRECORD_TASK_READY_PRIORITY(pxTCB) taskRECORD_READY_PRIORITY((pxTCB)->uxPriority)
+#endif
+// 任务从就绪队列中移除后，如果它所在的就绪队列空了，清除位图中的对应位
+#define taskRESET_TASK_READY_PRIORITY(pxTCB)                                                              \
+    do                                                                                                    \
+    {                                                                                                     \
+        if (taskREADY_QUEUE_LENGTH(taskREADY_QUEUE_OF(pxTCB)) == (UBaseType_t)0)                          \
+        {                                                                                                 \
+            portRESET_READY_PRIORITY((pxTCB)->uxPriority, taskTOP_READY_PRIORITY_OF(pxTCB));              \
+        }                                                                                                 \
+    } while (0)
+
+/** 就绪队列的两种表示，都通过下面的 taskREADY_QUEUE_* 访问
+ *  默认每个优先级一个 List_t，轮转时顺着 pxIndex 在分散各处的TCB之间跳转；
+ *  configUSE_READY_QUEUE_RINGS 为1时换成TCB指针的环形数组，选择、轮转、删除队首队尾都只是下标运算，
+ *  就绪任务的 xStateListItem 不挂在任何链表上，只把所属容器指向所在的环，用来判断任务是否就绪
+ */
+#if (configUSE_READY_QUEUE_RINGS == 1)
+#define taskREADY_RING_MASK ((UBaseType_t)configREADY_QUEUE_RING_LENGTH - 1U)
+typedef struct tskREADY_RING
+{
+    UBaseType_t uxHead;                                                 // 下一个要选中的任务
+    UBaseType_t uxNumberOfItems;
+    BaseType_t xTailSelected;                                           // 队尾（uxHead + uxNumberOfItems - 1）是最近一次选中的任务，相当于 pxIndex 指向它
+    struct tskTaskControlBlock *pxTasks[configREADY_QUEUE_RING_LENGTH]; // 按轮转顺序排列
+} ReadyQueue_t;
+#define taskREADY_QUEUE_LENGTH(pxQueue) ((pxQueue)->uxNumberOfItems)
+#define taskREADY_QUEUE_IS_EMPTY(pxQueue) (((pxQueue)->uxNumberOfItems == (UBaseType_t)0U) ? pdTRUE : pdFALSE)
+// 轮转顺序中第 uxOffset 个任务，0是下一个要选中的任务
+#define taskREADY_QUEUE_OWNER_AT(pxQueue, uxOffset) ((pxQueue)->pxTasks[((pxQueue)->uxHead + (uxOffset)) & taskREADY_RING_MASK])
+#define taskREADY_QUEUE_PEEK_NEXT_OWNER(pxQueue) taskREADY_QUEUE_OWNER_AT((pxQueue), 0U)
+// 选中队首并把它挪到队尾，与 listGET_OWNER_OF_NEXT_ENTRY 一样每选一次轮转一次
+#define taskREADY_QUEUE_GET_NEXT_OWNER(pxTCB, pxQueue)                                                        \
+    do                                                                                                      \
+    {                                                                                                       \
+        ReadyQueue_t *const pxConstQueue = (pxQueue);                                                       \
+        struct tskTaskControlBlock *const pxNextTCB = pxConstQueue->pxTasks[pxConstQueue->uxHead];          \
+        pxConstQueue->pxTasks[(pxConstQueue->uxHead + pxConstQueue->uxNumberOfItems) & taskREADY_RING_MASK] = pxNextTCB; \
+        pxConstQueue->uxHead = (pxConstQueue->uxHead + 1U) & taskREADY_RING_MASK;                           \
+        pxConstQueue->xTailSelected = pdTRUE;                                                               \
+        (pxTCB) = pxNextTCB;                                                                                \
+    } while (0)
+#define taskREADY_QUEUE_INITIALISE(pxQueue) \
+    ((pxQueue)->uxHead = (UBaseType_t)0U, (pxQueue)->uxNumberOfItems = (UBaseType_t)0U, (pxQueue)->xTailSelected = pdFALSE)
+#define taskREADY_QUEUE_INSERT(pxQueue, pxTCB) prvReadyRingInsert((pxQueue), (pxTCB))
+#define taskREADY_QUEUE_REMOVE(pxTCB) prvReadyRingRemove(pxTCB)
+#else
+typedef List_t ReadyQueue_t;
+#define taskREADY_QUEUE_LENGTH(pxQueue) listCURRENT_LIST_LENGTH(pxQueue)
+#define taskREADY_QUEUE_IS_EMPTY(pxQueue) listLIST_IS_EMPTY(pxQueue)
+// pxIndex 的下一项，跳过结束标记
+#define taskREADY_QUEUE_PEEK_NEXT_OWNER(pxQueue)                                                                        \
+    listGET_LIST_ITEM_OWNER((listGET_NEXT(listGET_INDEX(pxQueue)) == listGET_END_MARKER(pxQueue)) ? listGET_HEAD_ENTRY(pxQueue) \
+                                                                                                   : listGET_NEXT(listGET_INDEX(pxQueue)))
+#define taskREADY_QUEUE_GET_NEXT_OWNER(pxTCB, pxQueue) listGET_OWNER_OF_NEXT_ENTRY((pxTCB), (pxQueue))
+#define taskREADY_QUEUE_INITIALISE(pxQueue) vListInitialise(pxQueue)
+#define taskREADY_QUEUE_INSERT(pxQueue, pxTCB) vListInsertEnd((pxQueue), &((pxTCB)->xStateListItem))
+#define taskREADY_QUEUE_REMOVE(pxTCB) uxListRemove(&((pxTCB)->xStateListItem))
+#endif
+// 任务按现在的优先级所在的就绪队列
+#define taskREADY_QUEUE_OF(pxTCB) (&(taskREADY_LISTS_OF(pxTCB)[(pxTCB)->uxPriority]))
+// 任务是否就绪（包括正在运行的任务）
+#define taskIS_READY(pxTCB) listIS_CONTAINED_WITHIN((List_t *)taskREADY_QUEUE_OF(pxTCB), &((pxTCB)->xStateListItem))
+
+// 预算降级与老化提升都需要记住任务原来的优先级
+#if ((configUSE_TASK_BUDGETS == 1) || (configUSE_PRIORITY_AGING == 1))
+#define taskUSE_BASE_PRIORITY 1
+#else
+#define taskUSE_BASE_PRIORITY 0
+#endif
+
 /** 线程控制块
  *  @brief 线程控制块
  *  @param pxTopOfStack 栈顶指针 后面任务切换与任务启动都需要读取或修改这个值，
@@ -65,71 +154,530 @@ typedef struct tskTaskControlBlock
     volatile StackType_t *pxTopOfStack;         // 必须在结构体的顶部，任务启动与切换时会直接访问
     ListItem_t xStateListItem;                  // 挂载在就绪/阻塞/挂起队列的钩子
     ListItem_t xEventListItem;
-    UBaseType_t uxPriority;                     // 任务优先级，最大值由freertos_config.h中configMAX_PRIORITIES设置
     StackType_t *pxStack;                       // 任务的栈顶指针
+    // 优先级类成员与任务名放在一起，8位优先级时中间不留对齐空隙
+    TaskPriority_t uxPriority;                  // 任务优先级，最大值由freertos_config.h中configMAX_PRIORITIES设置
+    #if (configUSE_PREEMPTION_THRESHOLD == 1)
+    TaskPriority_t uxPreemptionThreshold;       // 抢占阈值，运行时只有优先级高于它的任务才能抢占，不小于uxPriority
+    #endif
+    #if (taskUSE_BASE_PRIORITY == 1)
+    TaskPriority_t uxBasePriority;              // 基础优先级，uxPriority 低于它表示因预算降级，高于它表示因老化临时提升
+    #endif
+    #if (configUSE_TASK_NAMES == 1)
     char pcTaskName[configMAX_TASK_NAME_LEN];   // 任务名字
+    #endif
+    #if (configUSE_TASK_BUDGETS == 1)
+    TickType_t xBudget;                         // 每个补充周期内允许运行的tick数，0表示不限制
+    TickType_t xBudgetRemaining;                // 本补充周期内剩余的tick数
+    TickType_t xReplenishPeriod;                // 补充周期
+    TickType_t xBudgetWindowStart;              // 本补充周期的起点，即满预算时第一次被计费的tick
+    UBaseType_t uxBudgetAction;                 // 预算用完后的处理
+    struct tskTaskControlBlock *pxNextDemoted;  // 降级任务链，tick中逐个检查是否到了补充时刻；NULL表示不在链上
+    #endif
+    #if (configUSE_PRIORITY_AGING == 1)
+    TickType_t xAgingStamp;                     // 最近一次加入就绪队列或切入运行的tick
+    #endif
+    #if (configNUMBER_OF_CORES > 1)
+    BaseType_t xCoreID;                         // 挂在哪个核的就绪队列上，运行时就是运行它的核
+    UBaseType_t uxCoreAffinityMask;             // 允许运行的核，每一位对应一个核
+    #endif
+    #if (configUSE_TASK_DELETE == 1)
+    UBaseType_t uxStackDepth;                   // 栈深度（字），删除后放入复用池时按它排序
+    #endif
+    #if (configUSE_RENDEZVOUS_IPC == 1)
+    void *pvIpcTransfer;                        // 进行中的同步IPC的收发缓冲区（IpcTransfer_t，在任务自己的栈上），不在IPC中阻塞时为NULL
+    void *pvIpcServing;                         // 最近一次收到请求的端点，删除时用它解除端点与本任务的绑定
+    #endif
+    #if (configUSE_WAKE_LATENCY == 1)
+    HighResTime_t xWakeTime;                    // 最近一次被唤醒的高精度时刻
+    BaseType_t xWakePending;                    // 被唤醒后还没有切入运行
+    TaskWakeLatency_t xWakeLatency;
+    #endif
 } tskTCB;             // 后面不是用tskTCB而是用TCB_t，为了版本兼容
 typedef tskTCB TCB_t; // TCB_t 是系统私有不被外部使用的类型
 
 // 这个指针式volatile的，不是其指向的内容是volatile的
+#if (configNUMBER_OF_CORES > 1)
+TCB_t *volatile pxCurrentTCBs[configNUMBER_OF_CORES] = {NULL};   // 每个核正在运行的任务
+#else
 TCB_t *volatile pxCurrentTCB = NULL;
+#endif
+
+#if (configUSE_PREEMPTION_THRESHOLD == 1)
+// 实际生效的抢占阈值，不低于当前优先级（老化临时提升后可能高于设定的阈值）
+#if (taskUSE_BASE_PRIORITY == 1)
+// 因预算降级的任务（优先级低于基础优先级）失去阈值保护
+#define taskTHRESHOLD_OF(pxTCB)                                                          \
+    (((pxTCB)->uxPriority < (pxTCB)->uxBasePriority) ? (pxTCB)->uxPriority :             \
+     (((pxTCB)->uxPreemptionThreshold > (pxTCB)->uxPriority) ? (pxTCB)->uxPreemptionThreshold : (pxTCB)->uxPriority))
+#else
+#define taskTHRESHOLD_OF(pxTCB) \
+    (((pxTCB)->uxPreemptionThreshold > (pxTCB)->uxPriority) ? (pxTCB)->uxPreemptionThreshold : (pxTCB)->uxPriority)
+#endif
+// 被唤醒的任务是否要抢占当前任务：优先级必须高于当前任务的抢占阈值，同优先级不抢占，等时间片轮转
+#define taskPREEMPTS_CURRENT_TASK(pxTCB) ((pxTCB)->uxPriority > taskTHRESHOLD_OF(pxCurrentTCB))
+// 阈值高于优先级时，同优先级的任务也不能抢占当前任务，不进行时间片轮转
+#define taskCURRENT_TASK_CAN_TIME_SLICE() (taskTHRESHOLD_OF(pxCurrentTCB) == pxCurrentTCB->uxPriority)
+#elif (configNUMBER_OF_CORES > 1)
+// 与任务所在核的当前任务比较，需要抢占的是其他核时直接通知那个核，返回值只表示本核是否要切换
+static BaseType_t prvPreemptCoreOfTask(const TCB_t *const pxTCB);
+#define taskPREEMPTS_CURRENT_TASK(pxTCB) prvPreemptCoreOfTask(pxTCB)
+#define taskCURRENT_TASK_CAN_TIME_SLICE() (pdTRUE)
+#else
+#define taskPREEMPTS_CURRENT_TASK(pxTCB) ((pxTCB)->uxPriority >= pxCurrentTCB->uxPriority)
+#define taskCURRENT_TASK_CAN_TIME_SLICE() (pdTRUE)
+#endif
 
 // 就绪，阻塞队列
-static List_t pxReadyTasksLists[configMAX_PRIORITIES];
+#if (configNUMBER_OF_CORES > 1)
+static ReadyQueue_t pxReadyTasksListsByCore[configNUMBER_OF_CORES][configMAX_PRIORITIES];
+#else
+static ReadyQueue_t pxReadyTasksLists[configMAX_PRIORITIES];
+#endif
+#if (configUSE_64_BIT_TICKS == 1)
+// 64位tick不会溢出，只需要一个延时队列，也没有队列切换
+static List_t xDelayedTaskList1;
+static List_t *const pxDelayedTaskList = &xDelayedTaskList1;
+#else
 static List_t xDelayedTaskList1, xDelayedTaskList2;
 static List_t *volatile pxDelayedTaskList;
 static List_t *volatile pxOverflowDelayedTaskList;                      
+#endif
 
 static volatile UBaseType_t uxCurrentNumberOfTasks = (UBaseType_t)0U;   // 现在总任务数
+#if (configNUMBER_OF_CORES > 1)
+static volatile UBaseType_t uxTopReadyPriorityByCore[configNUMBER_OF_CORES];  // 每个核各自的就绪优先级位图
+#else
 static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;      // 二进制中每一位置一表示由该优先级的就绪任务
+#endif
 static volatile BaseType_t xSchedulerRunning = pdFALSE;                 // 表示调度器是否已经玉兴
+#if (configUSE_64_BIT_TICKS == 0)
 static volatile BaseType_t xNumOfOverflows = (BaseType_t)0;             // xTickCount 溢出次数
+#endif
 static volatile TickType_t xTickCount = (TickType_t)0U;                 // 系统滴答时钟，每次systick中断加一
 static volatile TickType_t xNextTaskUnblockTime = (TickType_t)0U;       // 最小解阻塞时间，xTickCount计时到这个数需要解阻塞一些阻塞任务
 
 static TaskHandle_t xIdleTaskHandle;
+#if (configNUMBER_OF_CORES > 1)
+static TaskHandle_t xCoreIdleTaskHandles[configNUMBER_OF_CORES];        // 每个核一个空闲任务，固定在这个核上，xIdleTaskHandle 是核0的
+#endif
+
+// 定向让出与同步IPC都用切换提示直接切到指定任务
+#if ((configUSE_DIRECTED_YIELD == 1) || (configUSE_RENDEZVOUS_IPC == 1))
+#define taskUSE_YIELD_TO 1
+#else
+#define taskUSE_YIELD_TO 0
+#endif
+
+#if (taskUSE_YIELD_TO == 1)
+#if (configNUMBER_OF_CORES > 1)
+static TCB_t *pxYieldToTCBByCore[configNUMBER_OF_CORES];
+#define pxYieldToTCB (pxYieldToTCBByCore[portGET_CORE_ID()])
+#else
+static TCB_t *pxYieldToTCB = NULL;                                      // vTaskYieldTo 或同步IPC指定的下一个任务，下一次切换时用掉
+#endif
+#endif
+
+#if (configUSE_TASK_SWITCH_COUNTERS == 1)
+static TaskSwitchCounters_t xSwitchCounters;                            // 任务切换统计，在PendSV中更新
+#endif
+
+#if (configUSE_POST_MORTEM == 1)
+static TCB_t *pxPostMortemTasks[configPOST_MORTEM_TASKS];               // 创建过的任务，故障时逐个计算栈水位
+static StackType_t uxPostMortemDepths[configPOST_MORTEM_TASKS];         // 对应任务的栈深度
+#endif
+
+#if (configUSE_TASK_BUDGETS == 1)
+// 降级任务链的结尾是哨兵而不是NULL，pxNextDemoted 不为NULL就表示任务在链上，不再由优先级推断
+#define taskDEMOTED_LIST_END ((TCB_t *)&pxDemotedTasks)
+static TCB_t *pxDemotedTasks = taskDEMOTED_LIST_END;                    // 因预算用完而降级的任务，等待补充
+static void prvDemotedListRemove(TCB_t *const pxTCB);
+#endif
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+static List_t xHighResDelayedTaskList;                                  // 高精度延时队列，按唤醒时刻(高精度时间，会回绕)排序
+static HighResTime_t xNextTickHighResTime = (HighResTime_t)0U;          // 下一个tick对应的高精度时刻，tick由它推算，不再依赖周期中断
+static BaseType_t prvHighResCatchUpTicks(HighResTime_t xNow);
+static HighResTime_t prvHighResNextEventTime(HighResTime_t xNow, BaseType_t xSwitchRequired);
+#endif
+
+#if (configUSE_TASK_DELETE == 1)
+static List_t xTasksWaitingTermination;                                 // 已删除但还在运行（正在切出）的任务，由空闲任务回收
+static List_t xTaskPool;                                                // 复用池，挂的是空闲TCB的 xStateListItem，按栈深度从小到大排序
+static BaseType_t xTaskPoolInitialised = pdFALSE;                       // 复用池可能在创建第一个任务之前就被 vTaskPoolAdd 使用
+static void prvCheckTasksWaitingTermination(void);
+#if (configUSE_RENDEZVOUS_IPC == 1)
+static void prvIpcDetachTask(TCB_t *const pxTCB);
+#endif
+#endif
+
+#if (configUSE_BASIC_TASKS == 1)
+static TCB_t *pxBasicDispatchers[configMAX_PRIORITIES];                 // 每个优先级的基本任务分发任务，NULL表示这个优先级没有
+static List_t xBasicActivationLists[configMAX_PRIORITIES];              // 每个优先级已激活、等待运行的基本任务，先进先出
+static List_t xBasicAlarmList;                                          // 定时激活链表，节点值是与前一个节点的tick差
+static BaseType_t prvBasicAlarmTick(void);
+#endif
+
+#if (configUSE_READY_QUEUE_RINGS == 1)
+/** 加入就绪环，与 vListInsertEnd 插在 pxIndex 前面一样：
+ *  队尾是最近一次选中的任务时插在它前面，新就绪的任务排在其他等待的任务之后、它的下一轮之前；
+ *  环空了以后还没有选中过任务（相当于 pxIndex 指向结束标记）时直接放在队尾
+ */
+static void prvReadyRingInsert(ReadyQueue_t *const pxQueue, TCB_t *const pxTCB)
+{
+    const UBaseType_t uxTail = (pxQueue->uxHead + pxQueue->uxNumberOfItems) & taskREADY_RING_MASK;
+
+    configASSERT(pxQueue->uxNumberOfItems < (UBaseType_t)configREADY_QUEUE_RING_LENGTH);   // 就绪任务比环长
+    if (pxQueue->xTailSelected != pdFALSE)
+    {
+        const UBaseType_t uxLast = (uxTail - 1U) & taskREADY_RING_MASK;
+        pxQueue->pxTasks[uxTail] = pxQueue->pxTasks[uxLast];
+        pxQueue->pxTasks[uxLast] = pxTCB;
+    }
+    else
+    {
+        pxQueue->pxTasks[uxTail] = pxTCB;
+    }
+    pxQueue->uxNumberOfItems++;
+    listSET_CONTAINER(&(pxTCB->xStateListItem), pxQueue);
+}
+
+/** 从所在的就绪环中删除任务，返回环中剩下的任务数
+ *  从队尾往前找：阻塞的通常是刚运行的任务，就在队尾；队首、队尾都是O(1)，中间的任务要把它后面的元素前移一格
+ */
+static UBaseType_t prvReadyRingRemove(TCB_t *const pxTCB)
+{
+    ReadyQueue_t *const pxQueue = (ReadyQueue_t *)listGET_CONTAINER(&(pxTCB->xStateListItem));
+    UBaseType_t uxOffset = pxQueue->uxNumberOfItems - 1U;
+
+    configASSERT(pxQueue->uxNumberOfItems != (UBaseType_t)0U);
+    while (taskREADY_QUEUE_OWNER_AT(pxQueue, uxOffset) != pxTCB)
+    {
+        configASSERT(uxOffset != (UBaseType_t)0U);
+        uxOffset--;
+    }
+    if (uxOffset == (UBaseType_t)0U)
+    {
+        pxQueue->uxHead = (pxQueue->uxHead + 1U) & taskREADY_RING_MASK;
+    }
+    else
+    {
+        for (; uxOffset < pxQueue->uxNumberOfItems - 1U; uxOffset++)
+        {
+            taskREADY_QUEUE_OWNER_AT(pxQueue, uxOffset) = taskREADY_QUEUE_OWNER_AT(pxQueue, uxOffset + 1U);
+        }
+    }
+    pxQueue->uxNumberOfItems--;
+    if (pxQueue->uxNumberOfItems == (UBaseType_t)0U)
+    {
+        pxQueue->xTailSelected = pdFALSE;
+    }
+    listCLEAR_CONTAINER(&(pxTCB->xStateListItem));
+    return pxQueue->uxNumberOfItems;
+}
+#endif /* configUSE_READY_QUEUE_RINGS */
+
+/** 按唤醒时间插入延时队列
+ *  用上一次插入延时队列的节点作提示：周期任务的唤醒时间一般与上一个阻塞的任务接近，往前或往后比较几次就能找到位置；
+ *  提示节点已经被唤醒或在另一个延时队列中时，改为根据头尾节点选择查找方向
+ */
+static ListItem_t *pxDelayedInsertHint = NULL;
+static void prvInsertDelayedListItem(List_t *const pxList, ListItem_t *const pxItem)
+{
+    ListItem_t *const pxHint = ((pxDelayedInsertHint != NULL) && (listIS_CONTAINED_WITHIN(pxList, pxDelayedInsertHint) != pdFALSE))
+                                   ? pxDelayedInsertHint
+                                   : NULL;
+    vListInsertHinted(pxList, pxHint, pxItem);
+    pxDelayedInsertHint = pxItem;
+}
 
 // vDelayTask调用的将运行态的任务转化成就绪态
 static void prvAddCurrentTaskToDelayedList(const TickType_t xTicksToDelay)
 {
-    if (uxListRemove(&(pxCurrentTCB->xStateListItem)) == (UBaseType_t)0)
+    if (taskREADY_QUEUE_REMOVE(pxCurrentTCB) == (UBaseType_t)0)
     {   // 将这个任务从就绪队列中移去，同时如果就绪队列为空后，将对应位的uxTopReadyPriority置零，表示该优先级没有任务了
         portRESET_READY_PRIORITY(pxCurrentTCB->uxPriority, uxTopReadyPriority);
     }
 
     // 设置该进入阻塞态的任务阻塞时间为现在的xTickCount加上该任务的阻塞时间，到时间后将在systick中断中被处理
     TickType_t xTimeToWake = xTickCount + xTicksToDelay;
+    #if (configUSE_64_BIT_TICKS == 1)
+    if (xTicksToDelay > portMAX_DELAY - xTickCount)
+    {   // xTickCount本身不会溢出，但延时可以大到让和溢出，如 vTaskDelay(portMAX_DELAY)，饱和到portMAX_DELAY，等同于永远不醒
+        xTimeToWake = portMAX_DELAY;
+    }
+    #endif
     listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xStateListItem), xTimeToWake);
 
+    #if (configUSE_64_BIT_TICKS == 1)
+    // 唤醒时间已经饱和，不会小于xTickCount，直接插入唯一的延时队列
+    prvInsertDelayedListItem(pxDelayedTaskList, &(pxCurrentTCB->xStateListItem));
+    if (xTimeToWake < xNextTaskUnblockTime)
+    {
+        xNextTaskUnblockTime = xTimeToWake;
+    }
+    #else
     if (xTimeToWake < xTickCount)
     {   // 如果解阻塞时间小于xTickCount，表示xTimeToWake出现了溢出，需要将任务加入溢出阻塞队列。
         // 等到xTickCount也溢出的时候，两个阻塞队列将调换，之后处理的将是这个溢出阻塞队列。
-        // vListInsert 根据任务解阻塞时间排序，解阻塞时间越近，插入的位置跟靠头部。
-        vListInsert(pxOverflowDelayedTaskList, &(pxCurrentTCB->xStateListItem));
+        // 根据任务解阻塞时间排序，解阻塞时间越近，插入的位置跟靠头部。
+        prvInsertDelayedListItem(pxOverflowDelayedTaskList, &(pxCurrentTCB->xStateListItem));
         // xNextTaskUnblockTime设置由systick中断中调换溢出队列后设置
     }
     else
     {   // 如果解阻塞时间大于xTickCount，表示没有溢出，正常的设置xNextTaskUnblockTime
-        vListInsert(pxDelayedTaskList, &(pxCurrentTCB->xStateListItem));
+        prvInsertDelayedListItem(pxDelayedTaskList, &(pxCurrentTCB->xStateListItem));
         if (xTimeToWake < xNextTaskUnblockTime)
         {   // 设置最小解阻塞时间
             xNextTaskUnblockTime = xTimeToWake;
         }
     }
+    #endif /* configUSE_64_BIT_TICKS */
 }
 // 将调用该函数的任务阻塞。即把他加入组设队列中，并且设置好最小阻塞时间
 void vTaskDelay(const TickType_t xTicksToDelay)
 {
-    prvAddCurrentTaskToDelayedList(xTicksToDelay);
+    // systick中断也会修改延时队列与xTickCount，64位xTickCount在cortex-m3上更是要两条指令才能读完
+    taskENTER_CRITICAL();
+    {
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        // SysTick可能很久没有中断，xTickCount落后于实际时间，先补齐，否则唤醒时间会算早
+        (void)prvHighResCatchUpTicks(portGET_HIGH_RES_TIME());
+        #endif
+        prvAddCurrentTaskToDelayedList(xTicksToDelay);
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        // 当前任务要让出cpu，按最近的截止时间重新设置单次定时
+        vPortHighResTimerSetDeadline(prvHighResNextEventTime(portGET_HIGH_RES_TIME(), pdTRUE));
+        #endif
+    }
+    taskEXIT_CRITICAL();
     taskYIELD();
 }
 
-/* 空闲任务 */
+/* 任务中读取tick，在临界区中读，保证64位tick不会读到高低两半来自不同的时刻 */
+TickType_t xTaskGetTickCount(void)
+{
+    TickType_t xTicks;
+    taskENTER_CRITICAL();
+    {
+        xTicks = xTickCount;
+    }
+    taskEXIT_CRITICAL();
+    return xTicks;
+}
+
+/* 中断中读取tick，不能用taskENTER_CRITICAL，要保存并恢复原来的basepri */
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    TickType_t xTicks;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xTicks = xTickCount;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return xTicks;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    return uxCurrentNumberOfTasks;
+}
+
+#if (configUSE_IDLE_WORK_QUEUE == 1)
+#define taskIDLE_WORK_NOT_QUEUED ((UBaseType_t)0)   // 不在队列中
+#define taskIDLE_WORK_QUEUED ((UBaseType_t)1)       // 在队列中等待运行
+#define taskIDLE_WORK_RUNNING ((UBaseType_t)2)      // 已经取出，正在空闲任务中运行
+
+// 空闲工作队列，先进先出的单链表，和降级任务链一样不需要初始化
+static IdleWork_t *volatile pxIdleWorkHead = NULL;
+static IdleWork_t *pxIdleWorkTail = NULL;
+#define taskIDLE_HAS_NO_WORK() (pxIdleWorkHead == NULL)
+
+/* 加到队尾，必须在临界区中调用 */
+static void prvIdleWorkAppend(IdleWork_t *const pxWork)
+{
+    pxWork->pxNext = NULL;
+    if (pxIdleWorkTail == NULL)
+    {
+        pxIdleWorkHead = pxWork;
+    }
+    else
+    {
+        pxIdleWorkTail->pxNext = pxWork;
+    }
+    pxIdleWorkTail = pxWork;
+    pxWork->uxState = taskIDLE_WORK_QUEUED;
+}
+
+static BaseType_t prvIdleWorkSubmit(IdleWork_t *const pxWork)
+{
+    if (pxWork->uxState == taskIDLE_WORK_QUEUED)
+    {
+        return pdFAIL;
+    }
+    prvIdleWorkAppend(pxWork);
+    return pdPASS;
+}
+
+/** 取出队头的工作，在临界区外运行一片，没做完又没被取消或重新提交的排到队尾
+ *  @return 是否运行了工作
+ */
+static BaseType_t prvRunIdleWork(void)
+{
+    IdleWork_t *pxWork;
+    BaseType_t xMoreWork;
+
+    if (pxIdleWorkHead == NULL)
+    {   // 不进临界区先看一眼，没有工作时空闲任务不去抢内核锁
+        return pdFALSE;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxWork = pxIdleWorkHead;
+        if (pxWork != NULL)
+        {
+            pxIdleWorkHead = pxWork->pxNext;
+            if (pxIdleWorkHead == NULL)
+            {
+                pxIdleWorkTail = NULL;
+            }
+            pxWork->uxState = taskIDLE_WORK_RUNNING;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (pxWork == NULL)
+    {   // 多核时被另一个核的空闲任务取走了
+        return pdFALSE;
+    }
+
+    xMoreWork = pxWork->pxWorkFunction(pxWork->pvParameters);
+
+    taskENTER_CRITICAL();
+    {
+        if (pxWork->uxState == taskIDLE_WORK_RUNNING)
+        {
+            if (xMoreWork != pdFALSE)
+            {
+                prvIdleWorkAppend(pxWork);
+            }
+            else
+            {
+                pxWork->uxState = taskIDLE_WORK_NOT_QUEUED;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+    return pdTRUE;
+}
+
+void vTaskIdleWorkInitialise(IdleWork_t *const pxWork, IdleWorkFunction_t pxWorkFunction, void *const pvParameters)
+{
+    pxWork->pxWorkFunction = pxWorkFunction;
+    pxWork->pvParameters = pvParameters;
+    pxWork->pxNext = NULL;
+    pxWork->uxState = taskIDLE_WORK_NOT_QUEUED;
+}
+
+BaseType_t xTaskIdleWorkSubmit(IdleWork_t *const pxWork)
+{
+    BaseType_t xReturn;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvIdleWorkSubmit(pxWork);
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+BaseType_t xTaskIdleWorkSubmitFromISR(IdleWork_t *const pxWork)
+{
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvIdleWorkSubmit(pxWork);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    return xReturn;
+}
+
+BaseType_t xTaskIdleWorkCancel(IdleWork_t *const pxWork)
+{
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        if (pxWork->uxState == taskIDLE_WORK_QUEUED)
+        {   // 单链表，从头找到它的前一个
+            IdleWork_t *pxPrevious = NULL;
+            IdleWork_t *pxIterator = pxIdleWorkHead;
+            while (pxIterator != pxWork)
+            {
+                pxPrevious = pxIterator;
+                pxIterator = pxIterator->pxNext;
+            }
+            if (pxPrevious == NULL)
+            {
+                pxIdleWorkHead = pxWork->pxNext;
+            }
+            else
+            {
+                pxPrevious->pxNext = pxWork->pxNext;
+            }
+            if (pxIdleWorkTail == pxWork)
+            {
+                pxIdleWorkTail = pxPrevious;
+            }
+        }
+        if (pxWork->uxState != taskIDLE_WORK_NOT_QUEUED)
+        {   // 正在运行的，这一片结束后不再排队
+            xReturn = pdPASS;
+        }
+        pxWork->uxState = taskIDLE_WORK_NOT_QUEUED;
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+#else
+#define taskIDLE_HAS_NO_WORK() (1)
+#endif /* configUSE_IDLE_WORK_QUEUE */
+
+/** 空闲任务
+ *  多核时先窃取其他核的任务；回收自删除的任务；再运行一片后台工作，做完一片回到循环开头；都没有时可以WFI休眠到下一个中断，
+ *  高精度定时（单次定时的tickless）时，休眠会一直持续到最近的唤醒时刻
+ */
+#if (configNUMBER_OF_CORES > 1)
+static BaseType_t prvStealReadyTask(void);
+#endif
+
 static void prvIdleTask(void *pvParameters)
 {
     (void)pvParameters;
     for (;;)
     {
+        #if (configNUMBER_OF_CORES > 1)
+        if (prvStealReadyTask() != pdFALSE)
+        {   // 偷来的任务优先级比空闲任务高，马上切换
+            taskYIELD();
+        }
+        #endif
+
+        #if (configUSE_TASK_DELETE == 1)
+        prvCheckTasksWaitingTermination();
+        #endif
+
+        #if (configUSE_IDLE_WORK_QUEUE == 1)
+        if (prvRunIdleWork() != pdFALSE)
+        {
+            continue;
+        }
+        #endif
+
+        #if (configUSE_IDLE_WFI == 1)
+        portWAIT_FOR_INTERRUPT_IF(taskIDLE_HAS_NO_WORK());   // 中断可能刚提交了工作，关中断后再确认一次
+        #endif
     }
 }
 
@@ -144,10 +692,98 @@ void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackTyp
     *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
 }
 
+#if (configUSE_STATIC_TASK_TABLE == 1)
+/** 静态任务表
+ *  configSTATIC_TASK_TABLE 中每一项在这里展开成一个栈数组、一个TCB与一个句柄，都带初值，由启动代码从flash拷贝到.data：
+ *  1. 栈数组的初值就是 pxPortInitialiseStack 构造的初始栈帧，pxTopOfStack 直接指向栈帧
+ *  2. TCB中的名字、优先级、栈指针、链表项所属者等都是初值，其余成员为0，与 prvInitialiseNewTask 的结果一样
+ *  就绪队列的链接要按优先级把任务串起来，预处理器做不到，由 prvAddStaticTaskTable 在启动调度器时O(n)挂上去
+ *  代价：栈数组不再在.bss中，整个栈都占flash与.data（初值），栈越大占得越多
+ *  @note 任务函数不能是static的，名字必须比 configMAX_TASK_NAME_LEN 短
+ */
+#define taskSTATIC_PRIORITY(uxTaskPriority) \
+    (((UBaseType_t)(uxTaskPriority) < (UBaseType_t)configMAX_PRIORITIES) ? (UBaseType_t)(uxTaskPriority) : ((UBaseType_t)configMAX_PRIORITIES - 1U))
+// 可选成员的初值，与 prvInitialiseNewTask 一致
+#if (configUSE_PREEMPTION_THRESHOLD == 1)
+#define taskSTATIC_THRESHOLD_INIT(uxTaskPriority) .uxPreemptionThreshold = taskSTATIC_PRIORITY(uxTaskPriority),
+#else
+#define taskSTATIC_THRESHOLD_INIT(uxTaskPriority)
+#endif
+#if (taskUSE_BASE_PRIORITY == 1)
+#define taskSTATIC_BASE_PRIORITY_INIT(uxTaskPriority) .uxBasePriority = taskSTATIC_PRIORITY(uxTaskPriority),
+#else
+#define taskSTATIC_BASE_PRIORITY_INIT(uxTaskPriority)
+#endif
+#if (configUSE_TASK_NAMES == 1)
+#define taskSTATIC_NAME_INIT(xName) .pcTaskName = #xName,
+#else
+#define taskSTATIC_NAME_INIT(xName)
+#endif
+#if (configUSE_TASK_DELETE == 1)
+#define taskSTATIC_STACK_DEPTH_INIT(uxDepth) .uxStackDepth = (UBaseType_t)(uxDepth),
+#else
+#define taskSTATIC_STACK_DEPTH_INIT(uxDepth)
+#endif
+#if (configUSE_LIST_INDEX_LINKS == 1)
+// 压缩链接的下标由地址算出，不是地址常量，不能作初值，所属者在 prvAddStaticTaskTable 中设置
+#define taskSTATIC_LIST_ITEMS_INIT(xName)
+#else
+#define taskSTATIC_LIST_ITEMS_INIT(xName)                     \
+    .xStateListItem = {.pvOwner = &(xStaticTCB_##xName)},     \
+    .xEventListItem = {.pvOwner = &(xStaticTCB_##xName)},
+#endif
+
+#define taskSTATIC_TASK_DEFINE(xName, pxTaskCode, pvTaskParameters, uxStackDepth, uxTaskPriority)                          \
+    static StackType_t uxStaticStack_##xName[(uxStackDepth)] __attribute__((aligned(8))) = {                               \
+        portSTATIC_STACK_FRAME(portSTATIC_STACK_TOP_INDEX(uxStackDepth), pxTaskCode, pvTaskParameters)};                   \
+    static TCB_t xStaticTCB_##xName = {                                                                                    \
+        .pxTopOfStack = &(uxStaticStack_##xName[portSTATIC_STACK_TOP_INDEX(uxStackDepth) - portSTATIC_STACK_FRAME_WORDS]), \
+        taskSTATIC_LIST_ITEMS_INIT(xName)                                                                                  \
+        .uxPriority = taskSTATIC_PRIORITY(uxTaskPriority),                                                                 \
+        .pxStack = uxStaticStack_##xName,                                                                                  \
+        taskSTATIC_NAME_INIT(xName)                                                                                        \
+        taskSTATIC_THRESHOLD_INIT(uxTaskPriority)                                                                          \
+        taskSTATIC_STACK_DEPTH_INIT(uxStackDepth)                                                                          \
+        taskSTATIC_BASE_PRIORITY_INIT(uxTaskPriority)};                                                                    \
+    TaskHandle_t const xStaticTaskHandle_##xName = &(xStaticTCB_##xName);
+// 用户的任务函数定义在别的文件中
+#define taskSTATIC_TASK_DECLARE_CODE(xName, pxTaskCode, pvTaskParameters, uxStackDepth, uxTaskPriority) \
+    extern void pxTaskCode(void *);
+#define taskSTATIC_TASK_POINTER(xName, pxTaskCode, pvTaskParameters, uxStackDepth, uxTaskPriority) \
+    &(xStaticTCB_##xName),
+
+configSTATIC_TASK_TABLE(taskSTATIC_TASK_DECLARE_CODE)
+configSTATIC_TASK_TABLE(taskSTATIC_TASK_DEFINE)
+// 空闲任务也放在表中，排在最后，与原来先创建用户任务、启动调度器时再创建空闲任务的顺序一样
+taskSTATIC_TASK_DEFINE(IDLE, prvIdleTask, NULL, configMINIMAL_STACK_SIZE, tskIDLE_PRIORITY)
+
+static TCB_t *const pxStaticTaskTable[] = {configSTATIC_TASK_TABLE(taskSTATIC_TASK_POINTER) &(xStaticTCB_IDLE)};
+
+static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB);
+
+/* 把静态任务表中的任务挂到就绪队列上，TCB已经初始化好，只需要链接 */
+static void prvAddStaticTaskTable(void)
+{
+    for (UBaseType_t i = (UBaseType_t)0U; i < (UBaseType_t)(sizeof(pxStaticTaskTable) / sizeof(pxStaticTaskTable[0])); i++)
+    {
+        #if (configUSE_LIST_INDEX_LINKS == 1)
+        listSE_LIST_ITEM_OWNER(&(pxStaticTaskTable[i]->xStateListItem), pxStaticTaskTable[i]);
+        listSE_LIST_ITEM_OWNER(&(pxStaticTaskTable[i]->xEventListItem), pxStaticTaskTable[i]);
+        #endif
+        prvAddNewTaskToReadyList(pxStaticTaskTable[i]);
+    }
+}
+#endif /* configUSE_STATIC_TASK_TABLE */
+
 /* 创建空闲任务 */
 static BaseType_t prvCreateIdleTasks(void)
 {
     BaseType_t xReturn = pdPASS;
+    #if (configUSE_STATIC_TASK_TABLE == 1)
+    // 空闲任务与用户任务都在静态任务表中，一起挂到就绪队列上
+    prvAddStaticTaskTable();
+    xIdleTaskHandle = (TaskHandle_t)&(xStaticTCB_IDLE);
+    #else
     StaticTask_t *pxIdleTaskTCBBuffer = NULL;   // 空闲任务TCB缓冲区地址
     StackType_t *pxIdleTaskStackBuffer = NULL;  // 空闲任务函数栈缓冲区地址
     StackType_t uxIdleTaskStackSize;            // 空闲任务函数栈的大小
@@ -165,6 +801,34 @@ static BaseType_t prvCreateIdleTasks(void)
     {   // 若空闲任务创建失败
         xReturn = pdFAIL;
     }
+
+    #if (configNUMBER_OF_CORES > 1)
+    {   // 其他核的空闲任务用内核自己的缓冲区，每个空闲任务固定在自己的核上
+        static StaticTask_t xCoreIdleTaskTCBs[configNUMBER_OF_CORES - 1];
+        static StackType_t uxCoreIdleTaskStacks[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+
+        xCoreIdleTaskHandles[0] = xIdleTaskHandle;
+        for (BaseType_t xCoreID = 1; (xCoreID < configNUMBER_OF_CORES) && (xReturn == pdPASS); xCoreID++)
+        {
+            xCoreIdleTaskHandles[xCoreID] = xTaskCreateStatic((TaskFunction_t)prvIdleTask,
+                                                              "IDLE",
+                                                              configMINIMAL_STACK_SIZE,
+                                                              NULL,
+                                                              tskIDLE_PRIORITY,
+                                                              uxCoreIdleTaskStacks[xCoreID - 1],
+                                                              &(xCoreIdleTaskTCBs[xCoreID - 1]));
+            if (xCoreIdleTaskHandles[xCoreID] == NULL)
+            {
+                xReturn = pdFAIL;
+            }
+        }
+        for (BaseType_t xCoreID = 0; (xCoreID < configNUMBER_OF_CORES) && (xReturn == pdPASS); xCoreID++)
+        {
+            vTaskCoreAffinitySet(xCoreIdleTaskHandles[xCoreID], (UBaseType_t)1UL << xCoreID);
+        }
+    }
+    #endif
+    #endif /* configUSE_STATIC_TASK_TABLE */
     return xReturn;
 }
 
@@ -176,92 +840,360 @@ void vTaskStartScheduler(void)
         portDISABLE_INTERRUPTS();               // 关中断，防止设置完systick后，发生systick中断，运行中断函数导致错误
         xNextTaskUnblockTime = portMAX_DELAY;   // 下次任务阻塞结束时间为最大
         xSchedulerRunning = pdTRUE;             // 表示开始启动调度器
-        xTickCount = (TickType_t)0U;            // 初始化tickCount，systick一开始的调度次数为0
+        xTickCount = (TickType_t)configINITIAL_TICK_COUNT;  // 初始化tickCount，默认systick一开始的调度次数为0
+        #if (configNUMBER_OF_CORES > 1)
+        for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
+        {   // 每个核从自己就绪队列中优先级最高的任务开始运行
+            UBaseType_t uxTopPriority;
+            portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriorityByCore[xCoreID]);
+            taskREADY_QUEUE_GET_NEXT_OWNER(pxCurrentTCBs[xCoreID], &(pxReadyTasksListsByCore[xCoreID][uxTopPriority]));
+        }
+        #endif
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        vPortHighResTimeInit();                 // 启动高精度时间基准，第一个tick在一个tick周期之后
+        xNextTickHighResTime = portGET_HIGH_RES_TIME() + portHIGH_RES_COUNTS_PER_TICK;
+        #elif (configUSE_WAKE_LATENCY == 1)
+        vPortHighResTimeInit();                 // 唤醒延迟用高精度时间计
+        #endif
         (void)xPortStartScheduler();            // 启动任务调度
     }
 }
 
 
 // 将任务添加到就绪队列中，同时将uxTopReadyPriority所在优先级位置一，表示该优先级的就绪队列有任务了
+#if (configUSE_PRIORITY_AGING == 1)
+#define taskRECORD_AGING_STAMP(pxTCB) ((pxTCB)->xAgingStamp = xTickCount)
+#else
+#define taskRECORD_AGING_STAMP(pxTCB)
+#endif
+// 唤醒路径（解阻塞）记下时刻，切入时计算唤醒延迟；优先级改变、换核等其他加入就绪队列的路径不记
+#if (configUSE_WAKE_LATENCY == 1)
+#define taskRECORD_WAKE_TIME(pxTCB)                      \
+    do                                                   \
+    {                                                    \
+        (pxTCB)->xWakeTime = portGET_HIGH_RES_TIME();    \
+        (pxTCB)->xWakePending = pdTRUE;                  \
+    } while (0)
+#else
+#define taskRECORD_WAKE_TIME(pxTCB)
+#endif
 #define prvAddTaskToReadyList(pxTCB)                                                           \
     do                                                                                         \
     {                                                                                          \
-        taskRECORD_READY_PRIORITY((pxTCB)->uxPriority);                                        \
-        vListInsertEnd(&(pxReadyTasksLists[(pxTCB)->uxPriority]), &((pxTCB)->xStateListItem)); \
+        taskRECORD_AGING_STAMP(pxTCB);                                                         \
+        taskRECORD_TASK_READY_PRIORITY(pxTCB);                                                 \
+        taskREADY_QUEUE_INSERT(taskREADY_QUEUE_OF(pxTCB), (pxTCB));                            \
     } while (0)
 
-
-/* 初始化任务列表，包括所有优先级的队列，阻塞队列 */
-static void prvInitialiseTaskLists(void)
+#if (configNUMBER_OF_CORES > 1)
+/** 为就绪的任务选一个核，只在任务创建与解阻塞时调用，正在运行或就绪的任务不能换核
+ *  调度器运行时选当前任务优先级最低的允许核，一样低时优先留在原来的核；
+ *  启动前选就绪位图数值最小的核，位图数值小说明它的最高就绪优先级不比另一个核高，任务大致均匀分开
+ */
+static BaseType_t prvSelectCoreForTask(const TCB_t *const pxTCB)
 {
-    for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < (UBaseType_t)configMAX_PRIORITIES; uxPriority++)
+    BaseType_t xSelected = -1;
+
+    for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
     {
-        vListInitialise(&(pxReadyTasksLists[uxPriority]));
+        if ((pxTCB->uxCoreAffinityMask & ((UBaseType_t)1UL << xCoreID)) == (UBaseType_t)0)
+        {
+            continue;
+        }
+        if (xSelected < 0)
+        {
+            xSelected = xCoreID;
+        }
+        else if (xSchedulerRunning != pdFALSE)
+        {
+            const UBaseType_t uxSelectedPriority = pxCurrentTCBs[xSelected]->uxPriority;
+            const UBaseType_t uxPriority = pxCurrentTCBs[xCoreID]->uxPriority;
+            if ((uxPriority < uxSelectedPriority) || ((uxPriority == uxSelectedPriority) && (xCoreID == pxTCB->xCoreID)))
+            {
+                xSelected = xCoreID;
+            }
+        }
+        else if (uxTopReadyPriorityByCore[xCoreID] < uxTopReadyPriorityByCore[xSelected])
+        {
+            xSelected = xCoreID;
+        }
     }
-    // 初始化队列
-    vListInitialise(&xDelayedTaskList1);
-    vListInitialise(&xDelayedTaskList2);
-
-    // 用volatile的指针指向两个阻塞队列，当出现xTickCount溢出时需要调换两个指针指向。
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    configASSERT(xSelected >= 0);
+    return xSelected;
 }
 
-/* 将新创建的任务加入到就绪队列中，如果是第一次创建任务则初始化就绪队列 */
-static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
+static BaseType_t prvPreemptCoreOfTask(const TCB_t *const pxTCB)
 {
-    // 确保中断不会在列表更新的时候访问列表，
-    taskENTER_CRITICAL();
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    if ((xSchedulerRunning != pdFALSE) && (pxTCB->uxPriority >= pxCurrentTCBs[pxTCB->xCoreID]->uxPriority))
     {
-        // 现存任务加一
-        uxCurrentNumberOfTasks++;
-        if (pxCurrentTCB == NULL)
-        { // 若pxCurrentTCB还未初始化
-            pxCurrentTCB = pxNewTCB;
-            if (uxCurrentNumberOfTasks == (UBaseType_t)1)
-            { // 若是第一个创建的任务，要初始化队列
-                prvInitialiseTaskLists();
-            }
+        if (pxTCB->xCoreID == portGET_CORE_ID())
+        {
+            xSwitchRequired = pdTRUE;
         }
         else
-        { // 若pxCurrentTCB已指向一个任务
-            if (xSchedulerRunning == pdFALSE)
-            { // 若调度器还未启动，那可以根据现在创建的任务优先级，让pxCurrentTCB指向优先级最高的最近一个任务
-                if (pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority)
-                {
-                    pxCurrentTCB = pxNewTCB;
-                }
-            }
+        {
+            portYIELD_CORE(pxTCB->xCoreID);
         }
-        // 将任务添加到就绪队列中，同时将uxTopReadyPriority所在优先级位置一，表示该优先级的就绪队列有任务了
-        prvAddTaskToReadyList(pxNewTCB);
     }
-    // 在调度器未开启前，uxCriticalNesting=0xaaaaaaaa，并不能关中断。basepri将一直保持0xbf,b=11,为进临界区设置。
-    taskEXIT_CRITICAL();
+    return xSwitchRequired;
 }
 
-/* 在已经分配好缓冲区的TCB的基础上，根据用户提供的任务信息，初始化TCB*/
-static void prvInitialiseNewTask(TaskFunction_t pxTaskCode,         // 任务函数
-                                 const char *const pcName,          // 任务名
-                                 const StackType_t uxStackDepth,    // 函数栈大小
-                                 void *const pvParameters,          // 任务参数
-                                 UBaseType_t uxPriority,            // 任务优先级
-                                 TaskHandle_t *const pxCreatedTask, // 任务句柄
-                                 TCB_t *pxNewTCB)                   // 任务控制块
+#if (configNUMBER_OF_CORES > 1)
+/** 工作窃取：本核只剩空闲优先级的任务时，从其他核的就绪队列里拿一个允许在本核运行、又没有在运行的任务过来
+ *  先不加锁看一眼其他核的位图，有空闲优先级以上的任务才进临界区，避免空闲的核一直抢内核锁
+ *  @return 是否偷到了任务
+ */
+static BaseType_t prvStealReadyTask(void)
 {
-    /* 初始化任务名 */
-    if (pcName != NULL)
+    const BaseType_t xThisCore = portGET_CORE_ID();   // 空闲任务固定在本核，核号不会变
+    const UBaseType_t uxThisCoreMask = (UBaseType_t)1UL << xThisCore;
+    BaseType_t xStolen = pdFALSE;
+
+    if (uxTopReadyPriorityByCore[xThisCore] > ((UBaseType_t)1UL << tskIDLE_PRIORITY))
+    {   // 本核还有别的活
+        return pdFALSE;
+    }
+
+    for (BaseType_t xCoreID = 0; (xCoreID < configNUMBER_OF_CORES) && (xStolen == pdFALSE); xCoreID++)
     {
-        for (UBaseType_t i = (UBaseType_t)0; i < (UBaseType_t)configMAX_TASK_NAME_LEN; i++)
+        if ((xCoreID == xThisCore) || ((uxTopReadyPriorityByCore[xCoreID] >> 1) == (UBaseType_t)0))
         {
-            pxNewTCB->pcTaskName[i] = pcName[i];
-            if (pcName[i] == (char)0x00)
+            continue;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            UBaseType_t uxPriority;
+            if ((uxTopReadyPriorityByCore[xCoreID] >> 1) != (UBaseType_t)0)
             {
-                break;
+                portGET_HIGHEST_PRIORITY(uxPriority, uxTopReadyPriorityByCore[xCoreID]);
+            }
+            else
+            {
+                uxPriority = tskIDLE_PRIORITY;
+            }
+            // 从高优先级往低找，空闲优先级的任务不偷
+            for (; (uxPriority > tskIDLE_PRIORITY) && (xStolen == pdFALSE); uxPriority--)
+            {
+                ReadyQueue_t *const pxQueue = &(pxReadyTasksListsByCore[xCoreID][uxPriority]);
+                #if (configUSE_READY_QUEUE_RINGS == 1)
+                for (UBaseType_t uxOffset = (UBaseType_t)0U; uxOffset < pxQueue->uxNumberOfItems; uxOffset++)
+                {
+                    TCB_t *const pxTCB = taskREADY_QUEUE_OWNER_AT(pxQueue, uxOffset);
+                #else
+                for (ListItem_t *pxItem = listGET_HEAD_ENTRY(pxQueue); pxItem != listGET_END_MARKER(pxQueue); pxItem = listGET_NEXT(pxItem))
+                {
+                    TCB_t *const pxTCB = (TCB_t *)listGET_LIST_ITEM_OWNER(pxItem);
+                #endif
+                    if ((pxTCB != pxCurrentTCBs[xCoreID]) && ((pxTCB->uxCoreAffinityMask & uxThisCoreMask) != (UBaseType_t)0))
+                    {
+                        (void)taskREADY_QUEUE_REMOVE(pxTCB);
+                        taskRESET_TASK_READY_PRIORITY(pxTCB);
+                        pxTCB->xCoreID = xThisCore;
+                        prvAddTaskToReadyList(pxTCB);
+                        xStolen = pdTRUE;
+                        break;
+                    }
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+    return xStolen;
+}
+#endif /* configNUMBER_OF_CORES */
+
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t xCoreID)
+{
+    configASSERT((xCoreID >= 0) && (xCoreID < configNUMBER_OF_CORES));
+    return (TaskHandle_t)pxCurrentTCBs[xCoreID];
+}
+
+void vTaskCoreAffinitySet(TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    uxCoreAffinityMask &= taskALL_CORES_MASK;
+    configASSERT(uxCoreAffinityMask != (UBaseType_t)0);
+
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+
+        pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+        if ((uxCoreAffinityMask & ((UBaseType_t)1UL << pxTCB->xCoreID)) == (UBaseType_t)0)
+        {
+            if ((xSchedulerRunning != pdFALSE) && (pxTCB == pxCurrentTCBs[pxTCB->xCoreID]))
+            {   // 正在不允许的核上运行，让那个核重新调度，切出时再搬走
+                if (pxTCB->xCoreID == portGET_CORE_ID())
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    portYIELD_CORE(pxTCB->xCoreID);
+                }
+            }
+            else if (taskIS_READY(pxTCB) != pdFALSE)
+            {   // 就绪但没有运行，直接搬到允许的核
+                (void)taskREADY_QUEUE_REMOVE(pxTCB);
+                taskRESET_TASK_READY_PRIORITY(pxTCB);
+                pxTCB->xCoreID = prvSelectCoreForTask(pxTCB);
+                prvAddTaskToReadyList(pxTCB);
+                xYieldRequired = taskPREEMPTS_CURRENT_TASK(pxTCB);
+            }
+            else
+            {   // 阻塞中，解阻塞时还会再选核
+                pxTCB->xCoreID = prvSelectCoreForTask(pxTCB);
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xYieldRequired != pdFALSE)
+    {
+        taskYIELD();
+    }
+}
+
+UBaseType_t uxTaskCoreAffinityGet(TaskHandle_t xTask)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+    return pxTCB->uxCoreAffinityMask;
+}
+#endif /* configNUMBER_OF_CORES */
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    #if (configNUMBER_OF_CORES > 1)
+    // 读核号与读 pxCurrentTCBs 之间不能被切换到别的核
+    TaskHandle_t xReturn;
+    taskENTER_CRITICAL();
+    {
+        xReturn = (TaskHandle_t)pxCurrentTCB;
+    }
+    taskEXIT_CRITICAL();
+    return xReturn;
+    #else
+    return (TaskHandle_t)pxCurrentTCB;
+    #endif
+}
+
+
+/* 初始化任务列表，包括所有优先级的队列，阻塞队列 */
+static void prvInitialiseTaskLists(void)
+{
+    #if (configNUMBER_OF_CORES > 1)
+    for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
+    {
+        for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < (UBaseType_t)configMAX_PRIORITIES; uxPriority++)
+        {
+            taskREADY_QUEUE_INITIALISE(&(pxReadyTasksListsByCore[xCoreID][uxPriority]));
+        }
+    }
+    #else
+    for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < (UBaseType_t)configMAX_PRIORITIES; uxPriority++)
+    {
+        taskREADY_QUEUE_INITIALISE(&(pxReadyTasksLists[uxPriority]));
+    }
+    #endif
+    // 初始化队列
+    vListInitialise(&xDelayedTaskList1);
+    #if (configUSE_64_BIT_TICKS == 0)
+    vListInitialise(&xDelayedTaskList2);
+
+    // 用volatile的指针指向两个阻塞队列，当出现xTickCount溢出时需要调换两个指针指向。
+    pxDelayedTaskList = &xDelayedTaskList1;
+    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    #endif
+
+    #if (configUSE_HIGH_RES_TIMER == 1)
+    vListInitialise(&xHighResDelayedTaskList);
+    #endif
+
+    #if (configUSE_TASK_DELETE == 1)
+    vListInitialise(&xTasksWaitingTermination);
+    #endif
+
+    #if (configUSE_BASIC_TASKS == 1)
+    for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < (UBaseType_t)configMAX_PRIORITIES; uxPriority++)
+    {
+        vListInitialise(&(xBasicActivationLists[uxPriority]));
+    }
+    vListInitialise(&xBasicAlarmList);
+    #endif
+}
+
+/* 将新创建的任务加入到就绪队列中，如果是第一次创建任务则初始化就绪队列 */
+static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
+{
+    // 确保中断不会在列表更新的时候访问列表，
+    taskENTER_CRITICAL();
+    {
+        // 现存任务加一
+        uxCurrentNumberOfTasks++;
+        #if (configNUMBER_OF_CORES > 1)
+        // 每个核运行哪个任务在启动调度器时才确定，这里只选一个核挂上去
+        if (uxCurrentNumberOfTasks == (UBaseType_t)1)
+        {
+            prvInitialiseTaskLists();
+        }
+        pxNewTCB->xCoreID = prvSelectCoreForTask(pxNewTCB);
+        #else
+        if (pxCurrentTCB == NULL)
+        { // 若pxCurrentTCB还未初始化
+            pxCurrentTCB = pxNewTCB;
+            if (uxCurrentNumberOfTasks == (UBaseType_t)1)
+            { // 若是第一个创建的任务，要初始化队列
+                prvInitialiseTaskLists();
+            }
+        }
+        else
+        { // 若pxCurrentTCB已指向一个任务
+            if (xSchedulerRunning == pdFALSE)
+            { // 若调度器还未启动，那可以根据现在创建的任务优先级，让pxCurrentTCB指向优先级最高的最近一个任务
+                if (pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority)
+                {
+                    pxCurrentTCB = pxNewTCB;
+                }
+            }
+        }
+        #endif
+        // 将任务添加到就绪队列中，同时将uxTopReadyPriority所在优先级位置一，表示该优先级的就绪队列有任务了
+        prvAddTaskToReadyList(pxNewTCB);
+    }
+    // 在调度器未开启前，uxCriticalNesting=0xaaaaaaaa，并不能关中断。basepri将一直保持0xbf,b=11,为进临界区设置。
+    taskEXIT_CRITICAL();
+}
+
+/* 在已经分配好缓冲区的TCB的基础上，根据用户提供的任务信息，初始化TCB*/
+static void prvInitialiseNewTask(TaskFunction_t pxTaskCode,         // 任务函数
+                                 const char *const pcName,          // 任务名
+                                 const StackType_t uxStackDepth,    // 函数栈大小
+                                 void *const pvParameters,          // 任务参数
+                                 UBaseType_t uxPriority,            // 任务优先级
+                                 TaskHandle_t *const pxCreatedTask, // 任务句柄
+                                 TCB_t *pxNewTCB)                   // 任务控制块
+{
+    /* 初始化任务名 */
+    #if (configUSE_TASK_NAMES == 1)
+    if (pcName != NULL)
+    {
+        for (UBaseType_t i = (UBaseType_t)0; i < (UBaseType_t)configMAX_TASK_NAME_LEN; i++)
+        {
+            pxNewTCB->pcTaskName[i] = pcName[i];
+            if (pcName[i] == (char)0x00)
+            {
+                break;
             }
         }
         pxNewTCB->pcTaskName[configMAX_TASK_NAME_LEN - 1U] = '\0'; //  字符串结束标志位
     }
+    #else
+    (void)pcName;
+    #endif
 
     /* 初始化栈顶指针 */
     /** 解释
@@ -277,8 +1209,24 @@ static void prvInitialiseNewTask(TaskFunction_t pxTaskCode,         // 任务函
      *      如果此时 PSP（Process Stack Pointer）未 8 字节对齐，会触发 硬件对齐 fault
      *      尤其当启用 FPU 时，还会额外自动压栈 S0–S15 和 FPSCR，这些是 8 字节对齐的结构体块
      */
+    #if (configUSE_POST_MORTEM == 1)
+    // 栈填满固定值，故障时从低地址端数没被改过的字就是栈水位；复用池中的TCB按TCB找到原来的一项
+    for (StackType_t i = (StackType_t)0; i < uxStackDepth; i++)
+    {
+        pxNewTCB->pxStack[i] = tskSTACK_FILL_WORD;
+    }
+    for (UBaseType_t i = (UBaseType_t)0; i < (UBaseType_t)configPOST_MORTEM_TASKS; i++)
+    {
+        if ((pxPostMortemTasks[i] == NULL) || (pxPostMortemTasks[i] == pxNewTCB))
+        {
+            pxPostMortemTasks[i] = pxNewTCB;
+            uxPostMortemDepths[i] = uxStackDepth;
+            break;
+        }
+    }
+    #endif
     StackType_t *pxTopOfStack = pxNewTCB->pxStack + (uxStackDepth - (StackType_t)1);
-    pxTopOfStack = (StackType_t *)((uint32_t)pxTopOfStack & (~((uint32_t)0x0007)));
+    pxTopOfStack = (StackType_t *)((portPOINTER_SIZE_TYPE)pxTopOfStack & (~((portPOINTER_SIZE_TYPE)0x0007)));
     pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack, pxTaskCode, pvParameters);
 
     /* 初始化优先级*/
@@ -287,6 +1235,18 @@ static void prvInitialiseNewTask(TaskFunction_t pxTaskCode,         // 任务函
         uxPriority = (UBaseType_t)configMAX_PRIORITIES - 1;
     }
     pxNewTCB->uxPriority = uxPriority;
+    #if (configUSE_PREEMPTION_THRESHOLD == 1)
+    pxNewTCB->uxPreemptionThreshold = uxPriority;   // 默认阈值等于优先级，与普通的抢占调度一样
+    #endif
+    #if (taskUSE_BASE_PRIORITY == 1)
+    pxNewTCB->uxBasePriority = uxPriority;          // 预算默认为0，不限制，其余成员已被清零
+    #endif
+    #if (configNUMBER_OF_CORES > 1)
+    pxNewTCB->uxCoreAffinityMask = taskALL_CORES_MASK;  // 默认可以在任何核上运行
+    #endif
+    #if (configUSE_TASK_DELETE == 1)
+    pxNewTCB->uxStackDepth = (UBaseType_t)uxStackDepth;
+    #endif
 
     /* 初始化状态链表项(钩子)的所有链表与所有任务 */
     vListInitialiseItem(&(pxNewTCB->xStateListItem));
@@ -341,6 +1301,9 @@ TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,        // 任务函数
     TaskHandle_t xReturn = NULL; // 返回的句柄，实际上是TCB_t *指针
     TCB_t *pxNewTCB;             // 任务控制块的操作指针，方便操作，StaticTask_t，TaskHandle_t都是隐藏结构体内部变量的数据结构，给用户使用。
 
+    // StaticTask_t 必须能放下 TCB_t，TCB_t 增加成员时 FreeRtos.h 中的 StaticTask_t 也要同步增加
+    configASSERT(sizeof(StaticTask_t) >= sizeof(TCB_t));
+
     // 私有的任务控制块函数创建函数
     pxNewTCB = prvCreateStaticTask(pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority, pxStackBuffer, pxTaskBuffer, &xReturn);
 
@@ -351,89 +1314,1652 @@ TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,        // 任务函数
     return xReturn;
 }
 
-void vTaskSwitchContext(void)
+#if (configUSE_TASK_DELETE == 1)
+/* 任务是否正在运行，多核时运行中的任务所在核就是运行它的核 */
+static BaseType_t prvTaskIsRunning(const TCB_t *const pxTCB)
 {
-    taskSELECT_HIGHEST_PRIORITY_TASK();
+    if (xSchedulerRunning == pdFALSE)
+    {
+        return pdFALSE;
+    }
+    #if (configNUMBER_OF_CORES > 1)
+    return (pxCurrentTCBs[pxTCB->xCoreID] == pxTCB) ? pdTRUE : pdFALSE;
+    #else
+    return (pxCurrentTCB == pxTCB) ? pdTRUE : pdFALSE;
+    #endif
 }
 
-// 设置最小解阻塞时间，根据阻塞队列是否为空，或阻塞队列头个任务(解阻塞时间最小)来确定
-static void prvResetNextTaskUnblockTime(void)
+/* 把任务从所有队列中取下，就绪队列空了时清除位图中的对应位，必须在临界区中调用 */
+static void prvRemoveTaskFromLists(TCB_t *const pxTCB)
 {
-    if (listLIST_IS_EMPTY(pxDelayedTaskList))
+    if (taskIS_READY(pxTCB) != pdFALSE)
     {
-        xNextTaskUnblockTime = portMAX_DELAY;
+        (void)taskREADY_QUEUE_REMOVE(pxTCB);
+        taskRESET_TASK_READY_PRIORITY(pxTCB);
     }
-    else
+    else if (listIS_IN_ANY_LIST(&(pxTCB->xStateListItem)) != pdFALSE)
+    {   // 延时队列、溢出延时队列或高精度延时队列，xNextTaskUnblockTime 过时也没关系，到时tick中会重新计算
+        (void)uxListRemove(&(pxTCB->xStateListItem));
+    }
+    if (listIS_IN_ANY_LIST(&(pxTCB->xEventListItem)) != pdFALSE)
     {
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY(pxDelayedTaskList);
+        (void)uxListRemove(&(pxTCB->xEventListItem));
     }
+    #if (configUSE_TASK_BUDGETS == 1)
+    prvDemotedListRemove(pxTCB);   // 可能在降级任务链上
+    #endif
+    #if (configUSE_RENDEZVOUS_IPC == 1)
+    prvIpcDetachTask(pxTCB);       // 可能是正在等回复的调用者，或阻塞在端点上的接收者
+    #endif
 }
 
-// 延时队列切换
-#define taskSWITCH_DELAYED_LISTS()                            \
-    do                                                        \
-    {                                                         \
-        List_t *pxTemp;                                       \
-        configASSERT((listLIST_IS_EMPTY(pxDelayedTaskList))); \
-                                                              \
-        pxTemp = pxDelayedTaskList;                           \
-        pxDelayedTaskList = pxOverflowDelayedTaskList;        \
-        pxOverflowDelayedTaskList = pxTemp;                   \
-        xNumOfOverflows = (BaseType_t)(xNumOfOverflows + 1);  \
-        prvResetNextTaskUnblockTime();                        \
-    } while (0)
-// 每次systick中断都会调用此函数。设置最小解阻塞时间，并把解阻塞时间小于xTickCount的任务切换为就绪状态，返回值是是否进行任务切换
-BaseType_t xTaskIncrementTick(void)
+/* 按栈深度插入复用池，必须在临界区中调用 */
+static void prvTaskPoolInsert(TCB_t *const pxTCB)
 {
-    BaseType_t xSwitchRequired = pdFALSE;   // 是否进行切换标志位
-    xTickCount++;                           // 系统总滴答次数
-    if (xTickCount == (TickType_t)0U)       // 若滴答次数变为零，表示溢出了
+    if (xTaskPoolInitialised == pdFALSE)
     {
-        taskSWITCH_DELAYED_LISTS();         // 进行延时队列的调换，切换的溢出延迟队列做新延迟队列
+        vListInitialise(&xTaskPool);
+        xTaskPoolInitialised = pdTRUE;
     }
-    if (xTickCount >= xNextTaskUnblockTime) // 若最近的延时任务延时到期
+    vListInitialiseItem(&(pxTCB->xStateListItem));
+    listSE_LIST_ITEM_OWNER(&(pxTCB->xStateListItem), pxTCB);
+    listSET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem), (TickType_t)pxTCB->uxStackDepth);
+    vListInsert(&xTaskPool, &(pxTCB->xStateListItem));
+}
+
+/* 任务已经不在任何队列中，也不在运行，由port清理后放入复用池 */
+static void prvReclaimTask(TCB_t *const pxTCB)
+{
+    portCLEAN_UP_TCB(pxTCB);
+    taskENTER_CRITICAL();
     {
-        for (;;)                            // 把所有延时到期的任务都加到就绪队列中
+        prvTaskPoolInsert(pxTCB);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/* 空闲任务中调用，回收已经切出的自删除任务 */
+static void prvCheckTasksWaitingTermination(void)
+{
+    while (listLIST_IS_EMPTY(&xTasksWaitingTermination) == pdFALSE)
+    {
+        TCB_t *pxTCB = NULL;
+
+        taskENTER_CRITICAL();
         {
-            if (listLIST_IS_EMPTY(pxDelayedTaskList))   
-            {   // 若延时队列为空，意味else把所有阻塞任务都处理完了，现在没有阻塞任务了，那等待解阻塞的时间设为最大。
-                xNextTaskUnblockTime = portMAX_DELAY;   
-                break;
+            if (listLIST_IS_EMPTY(&xTasksWaitingTermination) == pdFALSE)
+            {
+                TCB_t *const pxCandidate = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&xTasksWaitingTermination);
+                if (prvTaskIsRunning(pxCandidate) == pdFALSE)
+                {
+                    (void)uxListRemove(&(pxCandidate->xStateListItem));
+                    pxTCB = pxCandidate;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if (pxTCB == NULL)
+        {   // 多核时它还没有从那个核上切出，下一轮再来
+            break;
+        }
+        prvReclaimTask(pxTCB);
+    }
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    TCB_t *pxTCB;
+    BaseType_t xReclaimNow = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        pxTCB = (xTaskToDelete == NULL) ? pxCurrentTCB : (TCB_t *)xTaskToDelete;
+
+        #if (configNUMBER_OF_CORES > 1)
+        for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
+        {
+            configASSERT(pxTCB != (TCB_t *)xCoreIdleTaskHandles[xCoreID]);
+        }
+        #else
+        configASSERT(pxTCB != (TCB_t *)xIdleTaskHandle);
+        #endif
+        #if (configUSE_BASIC_TASKS == 1)
+        for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < (UBaseType_t)configMAX_PRIORITIES; uxPriority++)
+        {
+            configASSERT(pxTCB != pxBasicDispatchers[uxPriority]);
+        }
+        #endif
+
+        prvRemoveTaskFromLists(pxTCB);
+        uxCurrentNumberOfTasks--;
+
+        if (prvTaskIsRunning(pxTCB) != pdFALSE)
+        {   // 还在用自己的栈，切出之后才能回收
+            vListInsertEnd(&xTasksWaitingTermination, &(pxTCB->xStateListItem));
+            #if (configNUMBER_OF_CORES > 1)
+            if (pxTCB->xCoreID == portGET_CORE_ID())
+            {
+                xYieldRequired = pdTRUE;
             }
             else
-            {   // 延时队列不为空，获取时间上最近要解阻塞的任务进行处理
-                TCB_t *pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedTaskList);
-                TickType_t xItemValue = listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem));
+            {
+                portYIELD_CORE(pxTCB->xCoreID);
+            }
+            #else
+            xYieldRequired = pdTRUE;
+            #endif
+        }
+        else
+        {
+            #if (configNUMBER_OF_CORES == 1)
+            if (pxTCB == pxCurrentTCB)
+            {   // 调度器启动前删除了准备第一个运行的任务，重新选
+                taskSELECT_HIGHEST_PRIORITY_TASK();
+            }
+            #endif
+            xReclaimNow = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
 
-                if (xTickCount < xItemValue)
-                {   // 如果最近的要解阻塞的任务时间还没到，那把最小解阻塞时间设置为阻塞队列中最小解阻塞时间
-                    xNextTaskUnblockTime = xItemValue;
-                    break;
-                }
+    if (xReclaimNow != pdFALSE)
+    {
+        prvReclaimTask(pxTCB);
+    }
+    if (xYieldRequired != pdFALSE)
+    {   // 自删除，切出后不会再回来
+        taskYIELD();
+    }
+}
 
-                // 最近的要解阻塞的任务时间已经到了，总阻塞队列中删除这个任务并加入到就绪队列中
-                (void)uxListRemove(&(pxTCB->xStateListItem));
-                prvAddTaskToReadyList(pxTCB);
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode,
+                       const char *const pcName,
+                       const StackType_t uxStackDepth,
+                       void *const pvParameters,
+                       UBaseType_t uxPriority,
+                       TaskHandle_t *const pxCreatedTask)
+{
+    TCB_t *pxPooledTCB = NULL;
+    TaskHandle_t xHandle = NULL;
 
-                #if (configUSE_PREEMPTION == 1)
-                {   // 优先级调度
-                    if (pxTCB->uxPriority >= pxCurrentTCB->uxPriority)
-                    {   // 如果新加入的任务优先级大于等于现在任务优先级，那么需要进行任务切换
-                        xSwitchRequired = pdTRUE;
-                    }
+    taskENTER_CRITICAL();
+    {
+        if (xTaskPoolInitialised != pdFALSE)
+        {
+            const ListItem_t *const pxEnd = listGET_END_MARKER(&xTaskPool);
+            for (ListItem_t *pxIterator = listGET_HEAD_ENTRY(&xTaskPool); pxIterator != pxEnd; pxIterator = listGET_NEXT(pxIterator))
+            {   // 按栈深度从小到大排序，第一个够用的就是最合适的
+                if (listGET_LIST_ITEM_VALUE(pxIterator) >= (TickType_t)uxStackDepth)
+                {
+                    pxPooledTCB = (TCB_t *)listGET_LIST_ITEM_OWNER(pxIterator);
+                    (void)uxListRemove(pxIterator);
+                    break;
                 }
-                #endif /* configUSE_PREEMPTION */
             }
         }
-    } /* xConstTickCount >= xNextTaskUnblockTime */
+    }
+    taskEXIT_CRITICAL();
 
-    #if ((configUSE_PREEMPTION == 1) && (configUSE_TIME_SLICING == 1))
-    {   // 时间片轮转调度
-        if (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[pxCurrentTCB->uxPriority])) > (UBaseType_t)1)
-        {   // 如果当前优先级的就绪队列总有多个任务，那么每一次systick都需要进行时间片轮转调度
-            xSwitchRequired = pdTRUE;
-        }
+    if (pxPooledTCB != NULL)
+    {
+        xHandle = xTaskCreateStatic(pxTaskCode, pcName, (StackType_t)pxPooledTCB->uxStackDepth, pvParameters, uxPriority,
+                                    pxPooledTCB->pxStack, (StaticTask_t *)pxPooledTCB);
     }
-    #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+    if (pxCreatedTask != NULL)
+    {
+        *pxCreatedTask = xHandle;
+    }
+    return (xHandle != NULL) ? pdPASS : errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+}
+
+void vTaskPoolAdd(StaticTask_t *const pxTaskBuffer, StackType_t *const pxStackBuffer, const StackType_t uxStackDepth)
+{
+    TCB_t *const pxTCB = (TCB_t *)pxTaskBuffer;
+
+    configASSERT(sizeof(StaticTask_t) >= sizeof(TCB_t));
+    memset((void *)pxTCB, 0x00, sizeof(TCB_t));
+    pxTCB->pxStack = pxStackBuffer;
+    pxTCB->uxStackDepth = (UBaseType_t)uxStackDepth;
+    taskENTER_CRITICAL();
+    {
+        prvTaskPoolInsert(pxTCB);
+    }
+    taskEXIT_CRITICAL();
+}
+
+UBaseType_t uxTaskPoolGetCount(void)
+{
+    return (xTaskPoolInitialised != pdFALSE) ? listCURRENT_LIST_LENGTH(&xTaskPool) : (UBaseType_t)0U;
+}
+#endif /* configUSE_TASK_DELETE */
+
+/** 修改任务的优先级
+ *  任务在就绪队列中时，要从原优先级的就绪队列移到新优先级的就绪队列，同时维护uxTopReadyPriority的对应位，都是O(1)；
+ *  不在就绪队列中（阻塞）时，解阻塞时会加入新优先级的就绪队列；在事件等待队列中时按新优先级重新排序，否则唤醒顺序还是旧优先级的
+ *  @note 必须在临界区或中断中调用
+ */
+static void prvMoveTaskToPriority(TCB_t *const pxTCB, const UBaseType_t uxNewPriority)
+{
+    if (taskIS_READY(pxTCB) != pdFALSE)
+    {
+        (void)taskREADY_QUEUE_REMOVE(pxTCB);
+        taskRESET_TASK_READY_PRIORITY(pxTCB);
+        pxTCB->uxPriority = uxNewPriority;
+        prvAddTaskToReadyList(pxTCB);
+    }
+    else
+    {
+        pxTCB->uxPriority = uxNewPriority;
+        if (listIS_IN_ANY_LIST(&(pxTCB->xEventListItem)) != pdFALSE)
+        {   // 事件等待队列都按 configMAX_PRIORITIES - uxPriority 排序
+            List_t *const pxEventList = listGET_CONTAINER(&(pxTCB->xEventListItem));
+            (void)uxListRemove(&(pxTCB->xEventListItem));
+            listSET_LIST_ITEM_VALUE(&(pxTCB->xEventListItem), (TickType_t)configMAX_PRIORITIES - (TickType_t)uxNewPriority);
+            vListInsertBidirectional(pxEventList, &(pxTCB->xEventListItem));
+        }
+    }
+}
+
+void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    if (uxNewPriority >= (UBaseType_t)configMAX_PRIORITIES)
+    {
+        uxNewPriority = (UBaseType_t)configMAX_PRIORITIES - 1U;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+
+        #if (taskUSE_BASE_PRIORITY == 1)
+        // 降级或临时提升中的任务只改基础优先级，恢复时按新的基础优先级恢复
+        BaseType_t xPriorityIsTemporary = (pxTCB->uxPriority != pxTCB->uxBasePriority) ? pdTRUE : pdFALSE;
+        pxTCB->uxBasePriority = uxNewPriority;
+        if (xPriorityIsTemporary == pdFALSE)
+        #endif
+        {
+            prvMoveTaskToPriority(pxTCB, uxNewPriority);
+        }
+
+        if (xSchedulerRunning == pdFALSE)
+        {   // 调度器还未启动，与创建任务时一样，让pxCurrentTCB指向优先级最高的任务；多核时启动调度器才选
+            #if (configNUMBER_OF_CORES == 1)
+            if (pxCurrentTCB->uxPriority <= pxTCB->uxPriority)
+            {
+                pxCurrentTCB = pxTCB;
+            }
+            #endif
+        }
+        #if (configNUMBER_OF_CORES > 1)
+        else if (pxTCB == pxCurrentTCBs[pxTCB->xCoreID])
+        {   // 任务正在某个核上运行，让那个核重新调度
+            if (pxTCB->xCoreID == portGET_CORE_ID())
+            {
+                xYieldRequired = pdTRUE;
+            }
+            else
+            {
+                portYIELD_CORE(pxTCB->xCoreID);
+            }
+        }
+        #else
+        else if (pxTCB == pxCurrentTCB)
+        {   // 当前任务降低了优先级，可能有就绪任务比它高了
+            UBaseType_t uxTopPriority;
+            portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);
+            #if (configUSE_PREEMPTION_THRESHOLD == 1)
+            if (uxTopPriority > taskTHRESHOLD_OF(pxCurrentTCB))
+            #else
+            if (uxTopPriority > pxCurrentTCB->uxPriority)
+            #endif
+            {
+                xYieldRequired = pdTRUE;
+            }
+        }
+        #endif
+        else if ((taskIS_READY(pxTCB) != pdFALSE) &&
+                 taskPREEMPTS_CURRENT_TASK(pxTCB))
+        {   // 就绪任务提高了优先级，可以抢占当前任务
+            xYieldRequired = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xYieldRequired != pdFALSE)
+    {
+        taskYIELD();
+    }
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+    return pxTCB->uxPriority;
+}
+
+#if (configUSE_QUEUES == 1)
+void vTaskPlaceOnEventList(List_t *const pxEventList, const TickType_t xTicksToWait)
+{
+    // 按优先级排序，高优先级的任务先被唤醒；等待的多是同一优先级的任务，从尾部往前找一般比较一次就停下
+    listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xEventListItem), (TickType_t)configMAX_PRIORITIES - (TickType_t)pxCurrentTCB->uxPriority);
+    vListInsertBidirectional(pxEventList, &(pxCurrentTCB->xEventListItem));
+
+    if (xTicksToWait == portMAX_DELAY)
+    {   // 永久等待，不挂延时队列
+        (void)taskREADY_QUEUE_REMOVE(pxCurrentTCB);
+        taskRESET_TASK_READY_PRIORITY(pxCurrentTCB);
+    }
+    else
+    {
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        (void)prvHighResCatchUpTicks(portGET_HIGH_RES_TIME());
+        #endif
+        prvAddCurrentTaskToDelayedList(xTicksToWait);
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        vPortHighResTimerSetDeadline(prvHighResNextEventTime(portGET_HIGH_RES_TIME(), pdTRUE));
+        #endif
+    }
+}
+
+BaseType_t xTaskRemoveFromEventList(const List_t *const pxEventList)
+{
+    TCB_t *const pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxEventList);
+
+    (void)uxListRemove(&(pxTCB->xEventListItem));
+    if (listIS_IN_ANY_LIST(&(pxTCB->xStateListItem)) != pdFALSE)
+    {   // 带超时的等待还在延时队列中，xNextTaskUnblockTime 过时也没关系，到时tick中会重新计算
+        (void)uxListRemove(&(pxTCB->xStateListItem));
+    }
+    taskSELECT_CORE_FOR_TASK(pxTCB);
+    taskRECORD_WAKE_TIME(pxTCB);
+    prvAddTaskToReadyList(pxTCB);
+    return taskPREEMPTS_CURRENT_TASK(pxTCB) ? pdTRUE : pdFALSE;
+}
+
+void vTaskSetTimeOutState(TimeOut_t *const pxTimeOut)
+{
+    pxTimeOut->xTimeOnEntering = xTickCount;
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *const pxTimeOut, TickType_t *const pxTicksToWait)
+{
+    // 无符号减法，tick溢出后经过的时间也是对的
+    const TickType_t xElapsed = xTickCount - pxTimeOut->xTimeOnEntering;
+
+    if (*pxTicksToWait == portMAX_DELAY)
+    {
+        return pdFALSE;
+    }
+    if (xElapsed < *pxTicksToWait)
+    {
+        *pxTicksToWait -= xElapsed;
+        pxTimeOut->xTimeOnEntering = xTickCount;
+        return pdFALSE;
+    }
+    *pxTicksToWait = (TickType_t)0;
+    return pdTRUE;
+}
+#endif /* configUSE_QUEUES */
+
+#if (configUSE_PRIORITY_AGING == 1)
+/** 优先级老化，tick中调用，返回值是是否进行任务切换
+ *  比当前任务优先级低的每个就绪队列，只检查轮转顺序中下一个要运行的任务（它等待得最久），每个tick代价是O(优先级数)；
+ *  就绪后 configAGING_THRESHOLD_TICKS 个tick都没有运行的任务，临时提升到比当前任务高一级（不超过 configAGING_MAX_PRIORITY），
+ *  运行一个tick后在切出时恢复基础优先级。这样后台任务的等待时间有上限，又不会反过来长期占用cpu
+ */
+static BaseType_t prvAgeReadyTasks(void)
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+    UBaseType_t uxBoostPriority = pxCurrentTCB->uxPriority + 1U;
+
+    if (pxCurrentTCB->uxPriority > pxCurrentTCB->uxBasePriority)
+    {   // 被提升的任务已经运行了一个tick，切出时恢复
+        xSwitchRequired = pdTRUE;
+    }
+    if (uxBoostPriority > (UBaseType_t)configAGING_MAX_PRIORITY)
+    {
+        uxBoostPriority = (UBaseType_t)configAGING_MAX_PRIORITY;
+    }
+
+    for (UBaseType_t uxPriority = (UBaseType_t)0U; uxPriority < pxCurrentTCB->uxPriority; uxPriority++)
+    {
+        ReadyQueue_t *const pxQueue = &(pxReadyTasksLists[uxPriority]);
+        TCB_t *pxTCB;
+
+        if (taskREADY_QUEUE_IS_EMPTY(pxQueue) != pdFALSE)
+        {
+            continue;
+        }
+        pxTCB = (TCB_t *)taskREADY_QUEUE_PEEK_NEXT_OWNER(pxQueue);
+
+        if ((pxTCB != (TCB_t *)xIdleTaskHandle) &&
+            (pxTCB->uxPriority == pxTCB->uxBasePriority) &&     // 降级中的任务不提升，否则预算限制失效
+            ((TickType_t)(xTickCount - pxTCB->xAgingStamp) >= (TickType_t)configAGING_THRESHOLD_TICKS))
+        {
+            prvMoveTaskToPriority(pxTCB, uxBoostPriority);
+            xSwitchRequired = pdTRUE;
+        }
+    }
+    return xSwitchRequired;
+}
+#endif /* configUSE_PRIORITY_AGING */
+
+#if (configUSE_TASK_BUDGETS == 1)
+/* 不在链上时什么也不做，必须在临界区或中断中调用 */
+static void prvDemotedListRemove(TCB_t *const pxTCB)
+{
+    TCB_t **ppxLink = &pxDemotedTasks;
+
+    if (pxTCB->pxNextDemoted == NULL)
+    {
+        return;
+    }
+    while (*ppxLink != pxTCB)
+    {
+        ppxLink = &((*ppxLink)->pxNextDemoted);
+    }
+    *ppxLink = pxTCB->pxNextDemoted;
+    pxTCB->pxNextDemoted = NULL;
+}
+
+/* 补满预算，在降级任务链上的任务从链上取下并恢复原优先级；
+ * 只恢复被降低的优先级，基础优先级不高于降级优先级时没有降级，这时因老化临时提升的优先级由切出时恢复 */
+static void prvReplenishBudget(TCB_t *const pxTCB)
+{
+    pxTCB->xBudgetRemaining = pxTCB->xBudget;
+    if (pxTCB->pxNextDemoted != NULL)
+    {
+        prvDemotedListRemove(pxTCB);
+        if (pxTCB->uxPriority < pxTCB->uxBasePriority)
+        {
+            prvMoveTaskToPriority(pxTCB, pxTCB->uxBasePriority);
+        }
+    }
+}
+
+/* 本补充周期是否已经结束，预算用过才有补充周期 */
+#define prvBUDGET_WINDOW_EXPIRED(pxTCB)                      \
+    (((pxTCB)->xBudgetRemaining < (pxTCB)->xBudget) &&        \
+     ((TickType_t)(xTickCount - (pxTCB)->xBudgetWindowStart) >= (pxTCB)->xReplenishPeriod))
+
+/** tick中调用，返回值是是否进行任务切换
+ *  1. 降级任务不运行就不会被计费，要在tick中主动检查它们的补充时刻
+ *  2. 给刚刚运行了一个tick的当前任务计费，预算从满开始用时记下补充周期起点，用完就阻塞到补充时刻或降级
+ */
+static BaseType_t prvTaskBudgetTick(void)
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+    TCB_t *pxTCB = pxDemotedTasks;
+
+    while (pxTCB != taskDEMOTED_LIST_END)
+    {
+        TCB_t *const pxNext = pxTCB->pxNextDemoted;
+        if (prvBUDGET_WINDOW_EXPIRED(pxTCB))
+        {
+            prvReplenishBudget(pxTCB);
+            xSwitchRequired = pdTRUE;
+        }
+        pxTCB = pxNext;
+    }
+
+    pxTCB = pxCurrentTCB;
+    if ((pxTCB->xBudget == (TickType_t)0) || (pxTCB->xBudgetRemaining == (TickType_t)0) ||
+        (taskIS_READY(pxTCB) == pdFALSE))
+    {   // 不限制预算，已经降级在用剩余时间，或已经阻塞(等待切换)的任务不计费
+        return xSwitchRequired;
+    }
+    if (prvBUDGET_WINDOW_EXPIRED(pxTCB))
+    {
+        prvReplenishBudget(pxTCB);
+    }
+    if (pxTCB->xBudgetRemaining == pxTCB->xBudget)
+    {   // 刚过去的这个tick是从满预算开始运行的，周期从这个tick的开头算
+        pxTCB->xBudgetWindowStart = xTickCount - (TickType_t)1;
+    }
+
+    pxTCB->xBudgetRemaining--;
+    if (pxTCB->xBudgetRemaining == (TickType_t)0)
+    {
+        if (pxTCB->uxBudgetAction == tskBUDGET_DEMOTE)
+        {   // 基础优先级不高于降级优先级时不改优先级，只挂在链上等补充
+            pxTCB->pxNextDemoted = pxDemotedTasks;
+            pxDemotedTasks = pxTCB;
+            if (pxTCB->uxBasePriority > (UBaseType_t)configTASK_BUDGET_DEMOTED_PRIORITY)
+            {
+                prvMoveTaskToPriority(pxTCB, (UBaseType_t)configTASK_BUDGET_DEMOTED_PRIORITY);
+            }
+        }
+        else
+        {   // 阻塞到补充时刻，由延时队列唤醒，切入时补满预算
+            prvAddCurrentTaskToDelayedList((TickType_t)(pxTCB->xBudgetWindowStart + pxTCB->xReplenishPeriod - xTickCount));
+        }
+        xSwitchRequired = pdTRUE;
+    }
+    return xSwitchRequired;
+}
+
+void vTaskBudgetSet(TaskHandle_t xTask, TickType_t xBudget, TickType_t xPeriod, UBaseType_t uxAction)
+{
+    configASSERT((xBudget == (TickType_t)0) || (xBudget < xPeriod));
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+
+        pxTCB->xBudget = xBudget;
+        pxTCB->xReplenishPeriod = xPeriod;
+        pxTCB->uxBudgetAction = uxAction;
+        prvReplenishBudget(pxTCB);
+    }
+    taskEXIT_CRITICAL();
+}
+
+TickType_t xTaskBudgetRemainingGet(TaskHandle_t xTask)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+    return pxTCB->xBudgetRemaining;
+}
+#endif /* configUSE_TASK_BUDGETS */
+
+#if (configUSE_PREEMPTION_THRESHOLD == 1)
+/** 当前任务是否继续运行
+ *  当前任务还在就绪队列中（没有阻塞），而优先级最高的就绪任务没有超过它的抢占阈值，就不切换；
+ *  最高就绪优先级等于当前任务优先级时，是同优先级任务之间的主动让出，照常轮转
+ */
+static BaseType_t prvCurrentTaskKeepsRunning(void)
+{
+    UBaseType_t uxTopPriority;
+
+    if (taskIS_READY(pxCurrentTCB) == pdFALSE)
+    {
+        return pdFALSE;
+    }
+    portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);
+    return ((uxTopPriority > pxCurrentTCB->uxPriority) && (uxTopPriority <= taskTHRESHOLD_OF(pxCurrentTCB))) ? pdTRUE : pdFALSE;
+}
+#endif
+
+#if (taskUSE_YIELD_TO == 1)
+/** 按 vTaskYieldTo 或同步IPC的指定切换，指定只用一次
+ *  指定的任务还在本核就绪，而且不会越过更高优先级的就绪任务时，直接切到它：
+ *  让出者还在就绪时不越过比它们两个都高的任务，让出者阻塞时不越过比指定任务高的任务
+ */
+static BaseType_t prvSwitchToYieldTarget(void)
+{
+    TCB_t *const pxTarget = pxYieldToTCB;
+    UBaseType_t uxTopPriority;
+    UBaseType_t uxLimit;
+
+    if (pxTarget == NULL)
+    {
+        return pdFALSE;
+    }
+    pxYieldToTCB = NULL;
+    if (taskIS_READY(pxTarget) == pdFALSE)
+    {
+        return pdFALSE;
+    }
+    #if (configNUMBER_OF_CORES > 1)
+    if (pxTarget->xCoreID != portGET_CORE_ID())
+    {
+        return pdFALSE;
+    }
+    #endif
+    uxLimit = pxTarget->uxPriority;
+    if ((taskIS_READY(pxCurrentTCB) != pdFALSE) && (pxCurrentTCB->uxPriority > uxLimit))
+    {
+        uxLimit = pxCurrentTCB->uxPriority;
+    }
+    portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);
+    if (uxTopPriority > uxLimit)
+    {
+        return pdFALSE;
+    }
+    pxCurrentTCB = pxTarget;
+    return pdTRUE;
+}
+#endif
+
+#if (configUSE_DIRECTED_YIELD == 1)
+
+void vTaskYieldTo(TaskHandle_t xTask)
+{
+    taskENTER_CRITICAL();
+    {
+        TCB_t *const pxTCB = (TCB_t *)xTask;
+
+        if ((pxTCB != NULL) && (pxTCB != pxCurrentTCB) && (pxTCB->uxPriority <= pxCurrentTCB->uxPriority))
+        {
+            pxYieldToTCB = pxTCB;
+        }
+        // 指定在本核的下一次切换时用掉，就是这次让出
+        taskYIELD();
+    }
+    taskEXIT_CRITICAL();
+}
+#endif /* configUSE_DIRECTED_YIELD */
+
+#if (configUSE_RENDEZVOUS_IPC == 1)
+/** 一次同步IPC中一方的收发缓冲区，在调用者或接收者自己的栈上，TCB 的 pvIpcTransfer 指向它
+ *  调用者：pvSend 是请求，pvReceive 是回复缓冲区，pxEndpoint 是调用的端点，pxPeer 是收下请求的服务任务
+ *  接收者：pvReceive 是请求缓冲区，pxPeer 是收到的调用者
+ *  接收者收到请求、调用者收到回复后，TCB 的 pvIpcTransfer 清为NULL，之后它所在的栈帧可能已经不存在
+ */
+typedef struct tskIPC_TRANSFER
+{
+    const void *pvSend;
+    size_t xSendLength;
+    void *pvReceive;
+    size_t xReceiveLength;
+    size_t xReceivedLength;     // 实际拷入 pvReceive 的长度
+    TCB_t *pxPeer;
+    IpcEndpoint_t *pxEndpoint;
+} IpcTransfer_t;
+
+/* 把服务者提升到 uxPriority，第一次提升时记下原来的优先级，必须在临界区中调用 */
+static void prvIpcBoostServer(IpcEndpoint_t *const pxEndpoint, TCB_t *const pxServer, const UBaseType_t uxPriority)
+{
+    if (pxServer->uxPriority < uxPriority)
+    {
+        if (pxEndpoint->xServerBoosted == pdFALSE)
+        {
+            pxEndpoint->uxServerPriority = pxServer->uxPriority;
+            pxEndpoint->xServerBoosted = pdTRUE;
+        }
+        prvMoveTaskToPriority(pxServer, uxPriority);
+    }
+}
+
+/* 把调用者的请求直接拷到接收者的缓冲区，接收者继承调用者的优先级，必须在临界区中调用 */
+static void prvIpcDeliver(IpcEndpoint_t *const pxEndpoint, TCB_t *const pxCaller, TCB_t *const pxReceiver)
+{
+    IpcTransfer_t *const pxCall = (IpcTransfer_t *)pxCaller->pvIpcTransfer;
+    IpcTransfer_t *const pxReceive = (IpcTransfer_t *)pxReceiver->pvIpcTransfer;
+    const size_t xLength = (pxCall->xSendLength < pxReceive->xReceiveLength) ? pxCall->xSendLength : pxReceive->xReceiveLength;
+
+    memcpy(pxReceive->pvReceive, pxCall->pvSend, xLength);
+    pxReceive->xReceivedLength = xLength;
+    pxReceive->pxPeer = pxCaller;
+    pxCall->pxPeer = pxReceiver;
+    pxReceiver->pvIpcTransfer = NULL;
+    pxReceiver->pvIpcServing = pxEndpoint;
+    pxEndpoint->pvServer = pxReceiver;
+    prvIpcBoostServer(pxEndpoint, pxReceiver, pxCaller->uxPriority);
+}
+
+/** 服务任务处理完一个调用（回复，或调用者被删除）后调整优先级：
+ *  还有调用者在排队时保持它们中最高的优先级，尽快回来接收；否则恢复提升前的优先级。
+ *  端点与服务任务的绑定保持到它回到 xTaskIpcReceive 阻塞为止，这期间来的调用者照样提升它，
+ *  否则回复后到再次接收之间被中间优先级的任务抢占，高优先级的调用者就要一直等。返回优先级是否降低，必须在临界区中调用
+ */
+static BaseType_t prvIpcReleaseServer(IpcEndpoint_t *const pxEndpoint, TCB_t *const pxServer)
+{
+    BaseType_t xLowered = pdFALSE;
+
+    if (pxEndpoint->pvServer != pxServer)
+    {   // 端点已经由别的服务任务接收，提升状态属于它
+        return pdFALSE;
+    }
+    if (pxEndpoint->xServerBoosted != pdFALSE)
+    {
+        UBaseType_t uxNewPriority = pxEndpoint->uxServerPriority;
+        if (listLIST_IS_EMPTY(&(pxEndpoint->xCallers)) == pdFALSE)
+        {
+            const TCB_t *const pxWaiting = (const TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&(pxEndpoint->xCallers));
+            if (pxWaiting->uxPriority > uxNewPriority)
+            {
+                uxNewPriority = pxWaiting->uxPriority;
+            }
+        }
+        if (uxNewPriority == pxEndpoint->uxServerPriority)
+        {
+            pxEndpoint->xServerBoosted = pdFALSE;
+        }
+        if (pxServer->uxPriority != uxNewPriority)
+        {
+            prvMoveTaskToPriority(pxServer, uxNewPriority);
+            xLowered = pdTRUE;
+        }
+    }
+    return xLowered;
+}
+
+/* 当前任务离开就绪队列并让出，在临界区中调用，真正的切换在退出临界区后发生 */
+static void prvIpcBlockCurrentTask(void)
+{
+    (void)taskREADY_QUEUE_REMOVE(pxCurrentTCB);
+    taskRESET_TASK_READY_PRIORITY(pxCurrentTCB);
+    taskYIELD();
+}
+
+/* 唤醒阻塞的对方，返回本核是否需要切换；多核时对方在别的核上由那个核切换，必须在临界区中调用 */
+static BaseType_t prvIpcWake(TCB_t *const pxTCB)
+{
+    taskSELECT_CORE_FOR_TASK(pxTCB);
+    taskRECORD_WAKE_TIME(pxTCB);
+    prvAddTaskToReadyList(pxTCB);
+    return taskPREEMPTS_CURRENT_TASK(pxTCB) ? pdTRUE : pdFALSE;
+}
+
+void vTaskIpcEndpointInitialise(IpcEndpoint_t *const pxEndpoint)
+{
+    vListInitialise(&(pxEndpoint->xCallers));
+    pxEndpoint->pvReceiver = NULL;
+    pxEndpoint->pvServer = NULL;
+    pxEndpoint->uxServerPriority = tskIDLE_PRIORITY;
+    pxEndpoint->xServerBoosted = pdFALSE;
+}
+
+size_t xTaskIpcCall(IpcEndpoint_t *const pxEndpoint,
+                    const void *const pvRequest,
+                    const size_t xRequestLength,
+                    void *const pvReply,
+                    const size_t xReplyLength)
+{
+    IpcTransfer_t xCall = {pvRequest, xRequestLength, pvReply, xReplyLength, 0, NULL, pxEndpoint};
+
+    taskENTER_CRITICAL();
+    {
+        TCB_t *const pxReceiver = (TCB_t *)pxEndpoint->pvReceiver;
+        TCB_t *const pxServer = (TCB_t *)pxEndpoint->pvServer;
+
+        pxCurrentTCB->pvIpcTransfer = &xCall;
+        if (pxReceiver != NULL)
+        {   // 接收者已经在等，请求直接交给它，然后切过去
+            pxEndpoint->pvReceiver = NULL;
+            prvIpcDeliver(pxEndpoint, pxCurrentTCB, pxReceiver);
+            (void)prvIpcWake(pxReceiver);
+            pxYieldToTCB = pxReceiver;
+        }
+        else
+        {   // 按优先级排队等接收者，高优先级的排在前面
+            listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xEventListItem), (TickType_t)configMAX_PRIORITIES - (TickType_t)pxCurrentTCB->uxPriority);
+            vListInsertBidirectional(&(pxEndpoint->xCallers), &(pxCurrentTCB->xEventListItem));
+            if (pxServer != NULL)
+            {   // 服务者在忙，提升到本任务的优先级，不让中间优先级的任务拖住它
+                prvIpcBoostServer(pxEndpoint, pxServer, pxCurrentTCB->uxPriority);
+                (void)taskPREEMPTS_CURRENT_TASK(pxServer);
+            }
+        }
+        // 阻塞到回复
+        prvIpcBlockCurrentTask();
+    }
+    taskEXIT_CRITICAL();
+    return xCall.xReceivedLength;
+}
+
+TaskHandle_t xTaskIpcReceive(IpcEndpoint_t *const pxEndpoint,
+                             void *const pvBuffer,
+                             const size_t xBufferLength,
+                             size_t *const pxReceivedLength)
+{
+    IpcTransfer_t xReceive = {NULL, 0, pvBuffer, xBufferLength, 0, NULL, pxEndpoint};
+
+    taskENTER_CRITICAL();
+    {
+        pxCurrentTCB->pvIpcTransfer = &xReceive;
+        if (listLIST_IS_EMPTY(&(pxEndpoint->xCallers)) == pdFALSE)
+        {   // 取优先级最高的调用者，它继续阻塞等回复
+            TCB_t *const pxCaller = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&(pxEndpoint->xCallers));
+            (void)uxListRemove(&(pxCaller->xEventListItem));
+            prvIpcDeliver(pxEndpoint, pxCaller, pxCurrentTCB);
+        }
+        else
+        {   // 阻塞到有调用者，调用者把请求拷进 xReceive；等待的接收者接替绑定，之后的调用者直接交给它，不再需要提升
+            configASSERT(pxEndpoint->pvReceiver == NULL);
+            if (pxEndpoint->pvServer == pxCurrentTCB)
+            {
+                pxEndpoint->pvServer = NULL;
+            }
+            pxEndpoint->pvReceiver = pxCurrentTCB;
+            prvIpcBlockCurrentTask();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (pxReceivedLength != NULL)
+    {
+        *pxReceivedLength = xReceive.xReceivedLength;
+    }
+    return (TaskHandle_t)xReceive.pxPeer;
+}
+
+void vTaskIpcReply(TaskHandle_t xCaller, const void *const pvReply, const size_t xLength)
+{
+    taskENTER_CRITICAL();
+    {
+        TCB_t *const pxCaller = (TCB_t *)xCaller;
+        IpcTransfer_t *const pxCall = (IpcTransfer_t *)pxCaller->pvIpcTransfer;
+
+        // 调用者在服务期间被删除时已经解除了关联，优先级也在删除时调整过，回复直接丢弃
+        if (pxCall != NULL)
+        {
+            const size_t xCopyLength = (xLength < pxCall->xReceiveLength) ? xLength : pxCall->xReceiveLength;
+            BaseType_t xYieldRequired;
+
+            configASSERT(pxCall->pxPeer == pxCurrentTCB);
+            memcpy(pxCall->pvReceive, pvReply, xCopyLength);
+            pxCall->xReceivedLength = xCopyLength;
+            pxCaller->pvIpcTransfer = NULL;
+
+            // 降下来后可能有别的任务可以运行了
+            xYieldRequired = prvIpcReleaseServer(pxCall->pxEndpoint, pxCurrentTCB);
+            if (prvIpcWake(pxCaller) != pdFALSE)
+            {
+                xYieldRequired = pdTRUE;
+            }
+            if (xYieldRequired != pdFALSE)
+            {
+                pxYieldToTCB = pxCaller;
+                taskYIELD();
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+#if (configUSE_TASK_DELETE == 1)
+/** 解除被删除的任务与端点的关联，必须在临界区中调用，任务的栈这时还在
+ *  服务任务：最近收到请求的端点不再绑定它，之后的调用者不会再提升一个已删除的任务；
+ *  接收者：端点上不再有等待的接收者；排队的调用者已经由 prvRemoveTaskFromLists 从 xCallers 中取下；
+ *  已交给服务任务的调用者：按它已经回复处理服务任务的优先级，之后对它的 vTaskIpcReply 什么也不做
+ */
+static void prvIpcDetachTask(TCB_t *const pxTCB)
+{
+    IpcTransfer_t *const pxTransfer = (IpcTransfer_t *)pxTCB->pvIpcTransfer;
+    IpcEndpoint_t *const pxServing = (IpcEndpoint_t *)pxTCB->pvIpcServing;
+
+    if ((pxServing != NULL) && (pxServing->pvServer == pxTCB))
+    {
+        pxServing->pvServer = NULL;
+        pxServing->xServerBoosted = pdFALSE;
+    }
+    pxTCB->pvIpcServing = NULL;
+    if (pxTransfer == NULL)
+    {
+        return;
+    }
+    pxTCB->pvIpcTransfer = NULL;
+    if (pxTransfer->pxEndpoint->pvReceiver == pxTCB)
+    {
+        pxTransfer->pxEndpoint->pvReceiver = NULL;
+    }
+    else if (pxTransfer->pxPeer != NULL)
+    {
+        TCB_t *const pxServer = pxTransfer->pxPeer;
+        if ((prvIpcReleaseServer(pxTransfer->pxEndpoint, pxServer) != pdFALSE) && (prvTaskIsRunning(pxServer) != pdFALSE))
+        {   // 服务任务正在运行，降低后让它所在的核重新调度
+            #if (configNUMBER_OF_CORES > 1)
+            if (pxServer->xCoreID != portGET_CORE_ID())
+            {
+                portYIELD_CORE(pxServer->xCoreID);
+            }
+            else
+            #endif
+            {
+                taskYIELD();
+            }
+        }
+    }
+}
+#endif /* configUSE_TASK_DELETE */
+#endif /* configUSE_RENDEZVOUS_IPC */
+
+#if (configUSE_WAKE_LATENCY == 1)
+/* 被唤醒的任务切入运行，计入唤醒延迟，在 vTaskSwitchContext 中调用 */
+static void prvRecordWakeLatency(TCB_t *const pxTCB)
+{
+    TaskWakeLatency_t *const pxLatency = &(pxTCB->xWakeLatency);
+    const uint32_t ulLatency = (uint32_t)(portGET_HIGH_RES_TIME() - pxTCB->xWakeTime);
+    uint32_t ulBucket = 31UL - (uint32_t)__builtin_clz(ulLatency | 1UL);
+
+    pxTCB->xWakePending = pdFALSE;
+    if ((pxLatency->ulCount == 0UL) || (ulLatency < pxLatency->ulMin))
+    {
+        pxLatency->ulMin = ulLatency;
+    }
+    if (ulLatency > pxLatency->ulMax)
+    {
+        pxLatency->ulMax = ulLatency;
+    }
+    if (ulBucket >= (uint32_t)configWAKE_LATENCY_BUCKETS)
+    {
+        ulBucket = (uint32_t)configWAKE_LATENCY_BUCKETS - 1UL;
+    }
+    pxLatency->ulHistogram[ulBucket]++;
+    pxLatency->ulCount++;
+}
+#endif /* configUSE_WAKE_LATENCY */
+
+void vTaskSwitchContext(void)
+{
+    #if ((configUSE_TASK_SWITCH_COUNTERS == 1) || (configUSE_POST_MORTEM == 1))
+    TCB_t *const pxPreviousTCB = pxCurrentTCB;
+    #endif
+    #if (configUSE_TASK_SWITCH_COUNTERS == 1)
+    xSwitchCounters.ulSwitchRequests++;
+    #endif
+
+    #if (configUSE_PREEMPTION_THRESHOLD == 1)
+    if (prvCurrentTaskKeepsRunning() != pdFALSE)
+    {
+        #if (configUSE_TASK_SWITCH_COUNTERS == 1)
+        xSwitchCounters.ulPreemptionsDeferred++;
+        #endif
+        return;
+    }
+    #endif
+
+    #if (configUSE_PRIORITY_AGING == 1)
+    if (pxCurrentTCB->uxPriority > pxCurrentTCB->uxBasePriority)
+    {   // 因老化临时提升的任务切出时恢复基础优先级
+        prvMoveTaskToPriority(pxCurrentTCB, pxCurrentTCB->uxBasePriority);
+    }
+    #endif
+
+    #if (configNUMBER_OF_CORES > 1)
+    if (((pxCurrentTCB->uxCoreAffinityMask & ((UBaseType_t)1UL << portGET_CORE_ID())) == (UBaseType_t)0) &&
+        (taskIS_READY(pxCurrentTCB) != pdFALSE))
+    {   // 亲和性改了，不能再在本核运行，切出时搬到允许的核
+        TCB_t *const pxTCB = pxCurrentTCB;
+        (void)taskREADY_QUEUE_REMOVE(pxTCB);
+        taskRESET_TASK_READY_PRIORITY(pxTCB);
+        pxTCB->xCoreID = prvSelectCoreForTask(pxTCB);
+        prvAddTaskToReadyList(pxTCB);
+        (void)taskPREEMPTS_CURRENT_TASK(pxTCB);
+    }
+    #endif
+
+    #if (taskUSE_YIELD_TO == 1)
+    if (prvSwitchToYieldTarget() != pdFALSE)
+    {
+        #if (configUSE_TASK_SWITCH_COUNTERS == 1)
+        xSwitchCounters.ulDirectedYields++;
+        #endif
+    }
+    else
+    #endif
+    {
+        taskSELECT_HIGHEST_PRIORITY_TASK();
+    }
+
+    #if (configUSE_PRIORITY_AGING == 1)
+    taskRECORD_AGING_STAMP(pxCurrentTCB);
+    #endif
+
+    #if (configUSE_WAKE_LATENCY == 1)
+    if (pxCurrentTCB->xWakePending != pdFALSE)
+    {
+        prvRecordWakeLatency(pxCurrentTCB);
+    }
+    #endif
+
+    #if (configUSE_TASK_BUDGETS == 1)
+    if (prvBUDGET_WINDOW_EXPIRED(pxCurrentTCB))
+    {   // 因预算用完而阻塞的任务到补充时刻被唤醒，切入时补满
+        prvReplenishBudget(pxCurrentTCB);
+    }
+    #endif
+
+    #if (configUSE_TASK_SWITCH_COUNTERS == 1)
+    if (pxCurrentTCB != pxPreviousTCB)
+    {
+        xSwitchCounters.ulContextSwitches++;
+    }
+    #endif
+
+    #if (configUSE_POST_MORTEM == 1)
+    if (pxCurrentTCB != pxPreviousTCB)
+    {   // 切换环在 .bss.noinit 中，看门狗复位后也能看到停住前的切换
+        PostMortemSwitch_t *const pxSwitch = &(xPostMortem.xSwitches[xPostMortem.ulSwitchCount & (configPOST_MORTEM_SWITCHES - 1UL)]);
+        pxSwitch->ulTick = (uint32_t)xTickCount;
+        pxSwitch->ulTask = (uint32_t)pxCurrentTCB;
+        xPostMortem.ulSwitchCount++;
+    }
+    #endif
+}
+
+#if (configUSE_PREEMPTION_THRESHOLD == 1)
+void vTaskPreemptionThresholdSet(TaskHandle_t xTask, UBaseType_t uxNewThreshold)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+
+        if (uxNewThreshold >= (UBaseType_t)configMAX_PRIORITIES)
+        {
+            uxNewThreshold = (UBaseType_t)configMAX_PRIORITIES - 1U;
+        }
+        #if (taskUSE_BASE_PRIORITY == 1)
+        if (uxNewThreshold < pxTCB->uxBasePriority)
+        {
+            uxNewThreshold = pxTCB->uxBasePriority;
+        }
+        #else
+        if (uxNewThreshold < pxTCB->uxPriority)
+        {
+            uxNewThreshold = pxTCB->uxPriority;
+        }
+        #endif
+
+        pxTCB->uxPreemptionThreshold = uxNewThreshold;
+        if (pxTCB == pxCurrentTCB)
+        {   // 降低阈值后，之前被挡住的就绪任务可能可以抢占了
+            UBaseType_t uxTopPriority;
+            portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);
+            if (uxTopPriority > taskTHRESHOLD_OF(pxTCB))
+            {
+                xYieldRequired = pdTRUE;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xYieldRequired != pdFALSE)
+    {
+        taskYIELD();
+    }
+}
+
+UBaseType_t uxTaskPreemptionThresholdGet(TaskHandle_t xTask)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+    return pxTCB->uxPreemptionThreshold;
+}
+#endif /* configUSE_PREEMPTION_THRESHOLD */
+
+#if (configUSE_TASK_SWITCH_COUNTERS == 1)
+void vTaskGetSwitchCounters(TaskSwitchCounters_t *const pxCounters)
+{
+    taskENTER_CRITICAL();
+    {
+        *pxCounters = xSwitchCounters;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vTaskResetSwitchCounters(void)
+{
+    taskENTER_CRITICAL();
+    {
+        memset((void *)&xSwitchCounters, 0x00, sizeof(xSwitchCounters));
+    }
+    taskEXIT_CRITICAL();
+}
+#endif /* configUSE_TASK_SWITCH_COUNTERS */
+
+#if (configUSE_POST_MORTEM == 1)
+UBaseType_t uxTaskPostMortemStacks(PostMortemStack_t *const pxStacks, const UBaseType_t uxMaxStacks)
+{
+    UBaseType_t uxCount = (UBaseType_t)0;
+
+    for (UBaseType_t i = (UBaseType_t)0; (i < (UBaseType_t)configPOST_MORTEM_TASKS) && (uxCount < uxMaxStacks); i++)
+    {
+        const TCB_t *const pxTCB = pxPostMortemTasks[i];
+        uint32_t ulFree = 0UL;
+
+        if (pxTCB == NULL)
+        {
+            break;
+        }
+        while ((ulFree < (uint32_t)uxPostMortemDepths[i]) && (pxTCB->pxStack[ulFree] == tskSTACK_FILL_WORD))
+        {
+            ulFree++;
+        }
+        pxStacks[uxCount].ulTask = (uint32_t)pxTCB;
+        pxStacks[uxCount].ulStack = (uint32_t)pxTCB->pxStack;
+        pxStacks[uxCount].ulDepth = (uint32_t)uxPostMortemDepths[i];
+        pxStacks[uxCount].ulFree = ulFree;
+        uxCount++;
+    }
+    return uxCount;
+}
+#endif /* configUSE_POST_MORTEM */
+
+#if (configUSE_WAKE_LATENCY == 1)
+void vTaskGetWakeLatency(TaskHandle_t xTask, TaskWakeLatency_t *const pxLatency)
+{
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+        *pxLatency = pxTCB->xWakeLatency;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vTaskResetWakeLatency(TaskHandle_t xTask)
+{
+    taskENTER_CRITICAL();
+    {
+        TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+        memset((void *)&(pxTCB->xWakeLatency), 0x00, sizeof(pxTCB->xWakeLatency));
+    }
+    taskEXIT_CRITICAL();
+}
+#endif /* configUSE_WAKE_LATENCY */
+
+#if (configUSE_BASIC_TASKS == 1)
+/** 基本任务的分发任务，每个用到的优先级一个
+ *  激活队列不空时取出队头的基本任务，退出临界区后直接调用它的函数；同优先级的基本任务一个接一个运行，
+ *  之间只有函数返回与调用，没有上下文切换。激活队列空了就离开就绪队列，不挂在任何队列上，
+ *  直到有基本任务被激活时再由 prvBasicTaskActivate 加回就绪队列
+ */
+static void prvBasicDispatcherTask(void *pvParameters)
+{
+    List_t *const pxActivations = &(xBasicActivationLists[(UBaseType_t)pvParameters]);
+
+    for (;;)
+    {
+        BasicTask_t *pxBasicTask = NULL;
+
+        taskENTER_CRITICAL();
+        {
+            if (listLIST_IS_EMPTY(pxActivations))
+            {   // 在临界区中让出，cortex-m3上PendSV在退出临界区后才发生，中间激活的基本任务不会丢
+                (void)taskREADY_QUEUE_REMOVE(pxCurrentTCB);
+                taskRESET_TASK_READY_PRIORITY(pxCurrentTCB);
+                taskYIELD();
+            }
+            else
+            {
+                pxBasicTask = (BasicTask_t *)listGET_OWNER_OF_HEAD_ENTRY(pxActivations);
+                (void)uxListRemove(&(pxBasicTask->xActivationListItem));
+                pxBasicTask->uxPendingActivations--;
+                if (pxBasicTask->uxPendingActivations > (UBaseType_t)0)
+                {   // 还有没处理的激活，排到队尾，和同优先级的其他基本任务轮流
+                    vListInsertEnd(pxActivations, &(pxBasicTask->xActivationListItem));
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if (pxBasicTask != NULL)
+        {
+            pxBasicTask->pxTaskCode(pxBasicTask->pvParameters);
+        }
+    }
+}
+
+/* 激活基本任务，分发任务在等激活时加回就绪队列，必须在临界区或中断中调用，返回值是是否进行任务切换 */
+static BaseType_t prvBasicTaskActivate(BasicTask_t *const pxBasicTask)
+{
+    TCB_t *const pxDispatcher = pxBasicDispatchers[pxBasicTask->uxPriority];
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    if (pxBasicTask->uxPendingActivations == (UBaseType_t)0)
+    {
+        vListInsertEnd(&(xBasicActivationLists[pxBasicTask->uxPriority]), &(pxBasicTask->xActivationListItem));
+    }
+    pxBasicTask->uxPendingActivations++;
+
+    if (listIS_IN_ANY_LIST(&(pxDispatcher->xStateListItem)) == pdFALSE)
+    {   // 分发任务在就绪队列中（正在运行基本任务或等待运行）时，它会自己处理新的激活
+        taskSELECT_CORE_FOR_TASK(pxDispatcher);
+        taskRECORD_WAKE_TIME(pxDispatcher);
+        prvAddTaskToReadyList(pxDispatcher);
+        #if (configUSE_PREEMPTION == 1)
+        if (taskPREEMPTS_CURRENT_TASK(pxDispatcher))
+        {
+            xSwitchRequired = pdTRUE;
+        }
+        #endif
+    }
+    return xSwitchRequired;
+}
+
+/* 按 xDelay 个tick后到期插入定时激活链表，经过的节点从 xDelay 中减去，插入点后面的节点改为相对新节点的差 */
+static void prvBasicAlarmInsert(BasicTask_t *const pxBasicTask, TickType_t xDelay)
+{
+    const ListItem_t *const pxEnd = listGET_END_MARKER(&xBasicAlarmList);
+    ListItem_t *pxIterator = listGET_HEAD_ENTRY(&xBasicAlarmList);
+
+    while ((pxIterator != pxEnd) && (listGET_LIST_ITEM_VALUE(pxIterator) <= xDelay))
+    {   // 同时到期的按设置顺序激活
+        xDelay -= listGET_LIST_ITEM_VALUE(pxIterator);
+        pxIterator = listGET_NEXT(pxIterator);
+    }
+    if (pxIterator != pxEnd)
+    {
+        listSET_LIST_ITEM_VALUE(pxIterator, listGET_LIST_ITEM_VALUE(pxIterator) - xDelay);
+    }
+    listSET_LIST_ITEM_VALUE(&(pxBasicTask->xAlarmListItem), xDelay);
+    vListInsertBefore(&xBasicAlarmList, pxIterator, &(pxBasicTask->xAlarmListItem));
+}
+
+/* 从定时激活链表中移除，它的差值加到后一个节点上 */
+static void prvBasicAlarmRemove(BasicTask_t *const pxBasicTask)
+{
+    ListItem_t *const pxItem = &(pxBasicTask->xAlarmListItem);
+
+    if (listIS_IN_ANY_LIST(pxItem) != pdFALSE)
+    {
+        ListItem_t *const pxNext = listGET_NEXT(pxItem);
+        if (pxNext != listGET_END_MARKER(&xBasicAlarmList))
+        {
+            listSET_LIST_ITEM_VALUE(pxNext, listGET_LIST_ITEM_VALUE(pxNext) + listGET_LIST_ITEM_VALUE(pxItem));
+        }
+        (void)uxListRemove(pxItem);
+    }
+}
+
+/* tick中处理定时激活：头节点的差值减一，减到0的节点都到期，周期性的按周期重新插入，返回值是是否进行任务切换 */
+static BaseType_t prvBasicAlarmTick(void)
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    if (listLIST_IS_EMPTY(&xBasicAlarmList) == pdFALSE)
+    {
+        ListItem_t *pxHead = listGET_HEAD_ENTRY(&xBasicAlarmList);
+        listSET_LIST_ITEM_VALUE(pxHead, listGET_LIST_ITEM_VALUE(pxHead) - 1U);
+
+        while ((listLIST_IS_EMPTY(&xBasicAlarmList) == pdFALSE) &&
+               (listGET_ITEM_VALUE_OF_HEAD_ENTRY(&xBasicAlarmList) == (TickType_t)0U))
+        {
+            BasicTask_t *const pxBasicTask = (BasicTask_t *)listGET_OWNER_OF_HEAD_ENTRY(&xBasicAlarmList);
+            (void)uxListRemove(&(pxBasicTask->xAlarmListItem));
+            if (pxBasicTask->xAlarmPeriod != (TickType_t)0U)
+            {   // 周期不为0，重新插入后差值至少为1，不会在这个tick再次到期
+                prvBasicAlarmInsert(pxBasicTask, pxBasicTask->xAlarmPeriod);
+            }
+            if (prvBasicTaskActivate(pxBasicTask) != pdFALSE)
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+    }
+    return xSwitchRequired;
+}
+
+TaskHandle_t xTaskBasicDispatcherCreateStatic(UBaseType_t uxPriority,
+                                              const StackType_t uxStackDepth,
+                                              StackType_t *const pxStackBuffer,
+                                              StaticTask_t *const pxTaskBuffer)
+{
+    configASSERT(uxPriority < (UBaseType_t)configMAX_PRIORITIES);
+    configASSERT(pxBasicDispatchers[uxPriority] == NULL);
+
+    TaskHandle_t xHandle = xTaskCreateStatic(prvBasicDispatcherTask, "basic", uxStackDepth, (void *)uxPriority,
+                                             uxPriority, pxStackBuffer, pxTaskBuffer);
+    pxBasicDispatchers[uxPriority] = (TCB_t *)xHandle;
+    return xHandle;
+}
+
+void vTaskBasicCreateStatic(TaskFunction_t pxTaskCode,
+                            void *const pvParameters,
+                            UBaseType_t uxPriority,
+                            BasicTask_t *const pxBasicTaskBuffer)
+{
+    if (uxPriority >= (UBaseType_t)configMAX_PRIORITIES)
+    {
+        uxPriority = (UBaseType_t)configMAX_PRIORITIES - 1U;
+    }
+    configASSERT(pxBasicDispatchers[uxPriority] != NULL);
+
+    pxBasicTaskBuffer->pxTaskCode = pxTaskCode;
+    pxBasicTaskBuffer->pvParameters = pvParameters;
+    pxBasicTaskBuffer->uxPriority = uxPriority;
+    pxBasicTaskBuffer->uxPendingActivations = (UBaseType_t)0U;
+    pxBasicTaskBuffer->xAlarmPeriod = (TickType_t)0U;
+    vListInitialiseItem(&(pxBasicTaskBuffer->xActivationListItem));
+    listSE_LIST_ITEM_OWNER(&(pxBasicTaskBuffer->xActivationListItem), pxBasicTaskBuffer);
+    vListInitialiseItem(&(pxBasicTaskBuffer->xAlarmListItem));
+    listSE_LIST_ITEM_OWNER(&(pxBasicTaskBuffer->xAlarmListItem), pxBasicTaskBuffer);
+}
+
+void vTaskBasicActivate(BasicTask_t *const pxBasicTask)
+{
+    BaseType_t xYieldRequired;
+
+    taskENTER_CRITICAL();
+    {
+        xYieldRequired = prvBasicTaskActivate(pxBasicTask);
+    }
+    taskEXIT_CRITICAL();
+
+    if ((xYieldRequired != pdFALSE) && (xSchedulerRunning != pdFALSE))
+    {
+        taskYIELD();
+    }
+}
+
+void vTaskBasicActivateFromISR(BasicTask_t *const pxBasicTask, BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if ((prvBasicTaskActivate(pxBasicTask) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+}
+
+void vTaskBasicAlarmSet(BasicTask_t *const pxBasicTask, TickType_t xDelay, TickType_t xPeriod)
+{
+    configASSERT(xDelay > (TickType_t)0U);
+
+    taskENTER_CRITICAL();
+    {
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        // 和 vTaskDelay 一样先补齐tick，定时从现在算起
+        (void)prvHighResCatchUpTicks(portGET_HIGH_RES_TIME());
+        #endif
+        prvBasicAlarmRemove(pxBasicTask);
+        pxBasicTask->xAlarmPeriod = xPeriod;
+        prvBasicAlarmInsert(pxBasicTask, xDelay);
+        #if (configUSE_HIGH_RES_TIMER == 1)
+        // 有定时激活时每个tick都要处理，重新设置单次定时
+        vPortHighResTimerSetDeadline(prvHighResNextEventTime(portGET_HIGH_RES_TIME(), pdFALSE));
+        #endif
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vTaskBasicAlarmCancel(BasicTask_t *const pxBasicTask)
+{
+    taskENTER_CRITICAL();
+    {
+        prvBasicAlarmRemove(pxBasicTask);
+    }
+    taskEXIT_CRITICAL();
+}
+#endif /* configUSE_BASIC_TASKS */
+
+#if (configUSE_64_BIT_TICKS == 0)
+// 设置最小解阻塞时间，根据阻塞队列是否为空，或阻塞队列头个任务(解阻塞时间最小)来确定
+static void prvResetNextTaskUnblockTime(void)
+{
+    if (listLIST_IS_EMPTY(pxDelayedTaskList))
+    {
+        xNextTaskUnblockTime = portMAX_DELAY;
+    }
+    else
+    {
+        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY(pxDelayedTaskList);
+    }
+}
+
+// 延时队列切换
+#define taskSWITCH_DELAYED_LISTS()                            \
+    do                                                        \
+    {                                                         \
+        List_t *pxTemp;                                       \
+        configASSERT((listLIST_IS_EMPTY(pxDelayedTaskList))); \
+                                                              \
+        pxTemp = pxDelayedTaskList;                           \
+        pxDelayedTaskList = pxOverflowDelayedTaskList;        \
+        pxOverflowDelayedTaskList = pxTemp;                   \
+        xNumOfOverflows = (BaseType_t)(xNumOfOverflows + 1);  \
+        prvResetNextTaskUnblockTime();                        \
+    } while (0)
+#endif /* configUSE_64_BIT_TICKS */
+// 每次systick中断都会调用此函数。设置最小解阻塞时间，并把解阻塞时间小于xTickCount的任务切换为就绪状态，返回值是是否进行任务切换
+BaseType_t xTaskIncrementTick(void)
+{
+    BaseType_t xSwitchRequired = pdFALSE;   // 是否进行切换标志位
+    xTickCount++;                           // 系统总滴答次数
+    #if (configUSE_64_BIT_TICKS == 0)
+    if (xTickCount == (TickType_t)0U)       // 若滴答次数变为零，表示溢出了
+    {
+        taskSWITCH_DELAYED_LISTS();         // 进行延时队列的调换，切换的溢出延迟队列做新延迟队列
+    }
+    #endif
+    if (xTickCount >= xNextTaskUnblockTime) // 若最近的延时任务延时到期
+    {
+        for (;;)                            // 把所有延时到期的任务都加到就绪队列中
+        {
+            if (listLIST_IS_EMPTY(pxDelayedTaskList))   
+            {   // 若延时队列为空，意味else把所有阻塞任务都处理完了，现在没有阻塞任务了，那等待解阻塞的时间设为最大。
+                xNextTaskUnblockTime = portMAX_DELAY;   
+                break;
+            }
+            else
+            {   // 延时队列不为空，获取时间上最近要解阻塞的任务进行处理
+                TCB_t *pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedTaskList);
+                TickType_t xItemValue = listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem));
+
+                if (xTickCount < xItemValue)
+                {   // 如果最近的要解阻塞的任务时间还没到，那把最小解阻塞时间设置为阻塞队列中最小解阻塞时间
+                    xNextTaskUnblockTime = xItemValue;
+                    break;
+                }
+
+                // 最近的要解阻塞的任务时间已经到了，总阻塞队列中删除这个任务并加入到就绪队列中
+                (void)uxListRemove(&(pxTCB->xStateListItem));
+                #if (configUSE_QUEUES == 1)
+                if (listIS_IN_ANY_LIST(&(pxTCB->xEventListItem)) != pdFALSE)
+                {   // 等待队列超时，同时从队列的等待链表中删除
+                    (void)uxListRemove(&(pxTCB->xEventListItem));
+                }
+                #endif
+                taskSELECT_CORE_FOR_TASK(pxTCB);
+                taskRECORD_WAKE_TIME(pxTCB);
+                prvAddTaskToReadyList(pxTCB);
+
+                #if (configUSE_PREEMPTION == 1)
+                {   // 优先级调度
+                    if (taskPREEMPTS_CURRENT_TASK(pxTCB))
+                    {   // 如果新加入的任务优先级大于等于现在任务优先级（使用抢占阈值时为高于阈值），那么需要进行任务切换
+                        xSwitchRequired = pdTRUE;
+                    }
+                }
+                #endif /* configUSE_PREEMPTION */
+            }
+        }
+    } /* xConstTickCount >= xNextTaskUnblockTime */
+
+    #if (configUSE_TASK_BUDGETS == 1)
+    if (prvTaskBudgetTick() != pdFALSE)
+    {
+        xSwitchRequired = pdTRUE;
+    }
+    #endif
+
+    #if (configUSE_PRIORITY_AGING == 1)
+    if (prvAgeReadyTasks() != pdFALSE)
+    {
+        xSwitchRequired = pdTRUE;
+    }
+    #endif
+
+    #if (configUSE_BASIC_TASKS == 1)
+    if (prvBasicAlarmTick() != pdFALSE)
+    {
+        xSwitchRequired = pdTRUE;
+    }
+    #endif
+
+    #if ((configNUMBER_OF_CORES > 1) && (configUSE_PREEMPTION == 1))
+    for (BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++)
+    {   // 每个核各自做时间片轮转；唤醒任务时发给其他核的通知可能落在刚切出的线程上而丢失，也在这里补上
+        const TCB_t *const pxRunningTCB = pxCurrentTCBs[xCoreID];
+        UBaseType_t uxTopPriority;
+        portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriorityByCore[xCoreID]);
+        if ((uxTopPriority > pxRunningTCB->uxPriority) ||
+            ((configUSE_TIME_SLICING == 1) &&
+             (taskREADY_QUEUE_LENGTH(&(pxReadyTasksListsByCore[xCoreID][pxRunningTCB->uxPriority])) > (UBaseType_t)1)))
+        {
+            if (xCoreID == portGET_CORE_ID())
+            {
+                xSwitchRequired = pdTRUE;
+            }
+            else
+            {
+                portYIELD_CORE(xCoreID);
+            }
+        }
+    }
+    #elif ((configUSE_PREEMPTION == 1) && (configUSE_TIME_SLICING == 1))
+    {   // 时间片轮转调度
+        if ((taskREADY_QUEUE_LENGTH(&(pxReadyTasksLists[pxCurrentTCB->uxPriority])) > (UBaseType_t)1) &&
+            taskCURRENT_TASK_CAN_TIME_SLICE())
+        {   // 如果当前优先级的就绪队列总有多个任务，那么每一次systick都需要进行时间片轮转调度
+            xSwitchRequired = pdTRUE;
+        }
+    }
+    #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+    return xSwitchRequired;
+}
+
+#if (configUSE_HIGH_RES_TIMER == 1)
+/* 补齐到 xNow 为止所有到期的tick，返回值是是否进行任务切换 */
+static BaseType_t prvHighResCatchUpTicks(HighResTime_t xNow)
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+    while ((int32_t)(xNow - xNextTickHighResTime) >= 0)
+    {   // 单次定时可能跨过了多个tick周期，逐个补上，溢出队列切换等逻辑和周期中断时完全一样
+        if (xTaskIncrementTick() != pdFALSE)
+        {
+            xSwitchRequired = pdTRUE;
+        }
+        xNextTickHighResTime += portHIGH_RES_COUNTS_PER_TICK;
+    }
+    return xSwitchRequired;
+}
+
+/** 计算下一次需要内核处理的高精度时刻
+ *  1. 有任务切换待处理或当前优先级要时间片轮转，下一个tick就要中断
+ *  2. 否则只在最近的延时任务解阻塞的那个tick中断，当前任务独占最高优先级且没有延时任务时tick中断完全停掉
+ *  3. 高精度延时队列头的唤醒时刻
+ *  以上都没有时，只保留硬件允许的最长单次定时，保证补齐tick时高精度时间不会回绕出错
+ */
+static HighResTime_t prvHighResNextEventTime(HighResTime_t xNow, BaseType_t xSwitchRequired)
+{
+    HighResTime_t xDeadline = xNow + portHIGH_RES_MAX_ONE_SHOT;
+    HighResTime_t xTickDeadline;
+
+    if ((xSwitchRequired != pdFALSE) ||
+        #if (configUSE_TASK_BUDGETS == 1)
+        (pxCurrentTCB->xBudget != (TickType_t)0) || (pxDemotedTasks != taskDEMOTED_LIST_END) ||   // 预算按tick计费
+        #endif
+        #if (configUSE_PRIORITY_AGING == 1)
+        (pxCurrentTCB->uxPriority > tskIDLE_PRIORITY) ||   // 可能有更低优先级的任务在等待老化提升
+        #endif
+        #if (configUSE_BASIC_TASKS == 1)
+        (listLIST_IS_EMPTY(&xBasicAlarmList) == pdFALSE) ||   // 定时激活按tick递减
+        #endif
+        ((taskREADY_QUEUE_LENGTH(&(pxReadyTasksLists[pxCurrentTCB->uxPriority])) > (UBaseType_t)1) && taskCURRENT_TASK_CAN_TIME_SLICE()) ||
+        (xNextTaskUnblockTime <= xTickCount))
+    {
+        xTickDeadline = xNextTickHighResTime;
+    }
+    else if ((TickType_t)(xNextTaskUnblockTime - xTickCount) <= (TickType_t)(portHIGH_RES_MAX_ONE_SHOT / portHIGH_RES_COUNTS_PER_TICK))
+    {   // xNextTickHighResTime 对应第 xTickCount + 1 个tick
+        xTickDeadline = xNextTickHighResTime + (HighResTime_t)(xNextTaskUnblockTime - xTickCount - 1U) * portHIGH_RES_COUNTS_PER_TICK;
+    }
+    else
+    {
+        xTickDeadline = xDeadline;
+    }
+    if ((int32_t)(xTickDeadline - xDeadline) < 0)
+    {
+        xDeadline = xTickDeadline;
+    }
+
+    if (listLIST_IS_EMPTY(&xHighResDelayedTaskList) == pdFALSE)
+    {
+        HighResTime_t xWakeTime = (HighResTime_t)listGET_ITEM_VALUE_OF_HEAD_ENTRY(&xHighResDelayedTaskList);
+        if ((int32_t)(xWakeTime - xDeadline) < 0)
+        {
+            xDeadline = xWakeTime;
+        }
+    }
+    return xDeadline;
+}
+
+/* 将当前任务加入高精度延时队列，唤醒时刻会回绕，不能用vListInsert按大小排序，要按与唤醒时刻的有符号差值找位置 */
+static void prvAddCurrentTaskToHighResDelayedList(const HighResTime_t xWakeTime)
+{
+    ListItem_t *pxIterator;
+
+    if (taskREADY_QUEUE_REMOVE(pxCurrentTCB) == (UBaseType_t)0)
+    {
+        portRESET_READY_PRIORITY(pxCurrentTCB->uxPriority, uxTopReadyPriority);
+    }
+    listSET_LIST_ITEM_VALUE(&(pxCurrentTCB->xStateListItem), (TickType_t)xWakeTime);
+
+    // 唤醒时刻相同的任务，新任务排在旧任务的后面，与vListInsert一致
+    for (pxIterator = listGET_HEAD_ENTRY(&xHighResDelayedTaskList);
+         (pxIterator != listGET_END_MARKER(&xHighResDelayedTaskList)) &&
+         ((int32_t)((HighResTime_t)listGET_LIST_ITEM_VALUE(pxIterator) - xWakeTime) <= 0);
+         pxIterator = listGET_NEXT(pxIterator))
+    {
+    }
+    vListInsertBefore(&xHighResDelayedTaskList, pxIterator, &(pxCurrentTCB->xStateListItem));
+
+    // 新的唤醒时刻可能比已经设置的单次定时更早
+    vPortHighResTimerSetDeadline(prvHighResNextEventTime(portGET_HIGH_RES_TIME(), pdTRUE));
+}
+
+HighResTime_t xTaskGetHighResTime(void)
+{
+    return portGET_HIGH_RES_TIME();
+}
+
+void vTaskDelayUs(const uint32_t ulMicroseconds)
+{
+    taskENTER_CRITICAL();
+    {
+        prvAddCurrentTaskToHighResDelayedList(portGET_HIGH_RES_TIME() + portHIGH_RES_TIME_FROM_US(ulMicroseconds));
+    }
+    taskEXIT_CRITICAL();
+    taskYIELD();
+}
+
+void vTaskDelayUntilUs(HighResTime_t *const pxPreviousWakeTime, const uint32_t ulIncrementUs)
+{
+    BaseType_t xShouldDelay = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        *pxPreviousWakeTime += portHIGH_RES_TIME_FROM_US(ulIncrementUs);
+        if ((int32_t)(*pxPreviousWakeTime - portGET_HIGH_RES_TIME()) > 0)
+        {   // 唤醒时刻还没到才阻塞，已经错过就直接返回，下一周期仍以原节拍为准
+            prvAddCurrentTaskToHighResDelayedList(*pxPreviousWakeTime);
+            xShouldDelay = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xShouldDelay != pdFALSE)
+    {
+        taskYIELD();
+    }
+}
+
+/* 单次定时中断：tick只是粗粒度的时间基准，由高精度时间推算补齐，高精度延时任务按各自的唤醒时刻精确唤醒 */
+BaseType_t xTaskHighResTimerHandler(void)
+{
+    HighResTime_t xNow = portGET_HIGH_RES_TIME();
+    BaseType_t xSwitchRequired = prvHighResCatchUpTicks(xNow);
+
+    while (listLIST_IS_EMPTY(&xHighResDelayedTaskList) == pdFALSE)
+    {
+        TCB_t *pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&xHighResDelayedTaskList);
+        if ((int32_t)(xNow - (HighResTime_t)listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem))) < 0)
+        {   // 队列按唤醒时刻排序，头部没到期，后面的也没到期
+            break;
+        }
+        (void)uxListRemove(&(pxTCB->xStateListItem));
+        taskRECORD_WAKE_TIME(pxTCB);
+        prvAddTaskToReadyList(pxTCB);
+
+        #if (configUSE_PREEMPTION == 1)
+        {
+            if (taskPREEMPTS_CURRENT_TASK(pxTCB))
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+        #endif /* configUSE_PREEMPTION */
+    }
+
+    vPortHighResTimerSetDeadline(prvHighResNextEventTime(xNow, xSwitchRequired));
     return xSwitchRequired;
 }
+#endif /* configUSE_HIGH_RES_TIMER */
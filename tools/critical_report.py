@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""屏蔽中断时长报告
+
+固件打开 configUSE_CRITICAL_TIMING，运行一段时间后停下调试器，导出统计：
+    (gdb) dump binary value critical.bin xCriticalTiming
+然后对照同一个ELF列出每个调用点：
+    python3 tools/critical_report.py firmware.elf critical.bin --clock-hz 72000000
+
+每行是一个调用点：函数名与源文件行号、次数、最长周期数，以及按2的幂分桶的直方图；
+临界区的调用点是 vPortEnterCritical 的返回地址，SysTick、PendSV 的调用点是处理函数本身。
+--buckets 必须与固件的 configCRITICAL_TIMING_BUCKETS 相同，调用点个数由文件长度算出。
+"""
+import argparse
+import struct
+import subprocess
+import sys
+
+HEADER = struct.Struct("<III")  # ulMaxCycles, ulMaxSite, ulOverflows
+
+
+def read_timing(path, buckets):
+    """读出 CriticalTiming_t，返回头部与用过的调用点 (ulSite, ulCount, ulMaxCycles, [直方图])"""
+    site = struct.Struct("<III%dI" % buckets)
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size or (len(data) - HEADER.size) % site.size != 0:
+        sys.exit("%s: 长度 %d 不是 xCriticalTiming 的导出，或者 --buckets 与固件不一致" % (path, len(data)))
+    max_cycles, max_site, overflows = HEADER.unpack_from(data, 0)
+    sites = []
+    for offset in range(HEADER.size, len(data), site.size):
+        fields = site.unpack_from(data, offset)
+        if fields[0] != 0:
+            sites.append((fields[0], fields[1], fields[2], list(fields[3:])))
+    return max_cycles, max_site, overflows, sites
+
+
+def symbolize(elf, addr2line, addresses):
+    """地址换成“函数 (文件:行)”。返回地址指向调用之后的指令，减1（同时去掉Thumb位）才落在调用所在的行"""
+    if not addresses:
+        return {}
+    query = "\n".join("0x%x" % ((a & ~1) - 1 if a & 1 else a) for a in addresses) + "\n"
+    out = subprocess.run([addr2line, "-f", "-C", "-e", elf], input=query,
+                         check=True, capture_output=True, text=True).stdout.splitlines()
+    names = {}
+    for i, address in enumerate(addresses):
+        function, location = out[2 * i], out[2 * i + 1]
+        if function == "??":
+            function = "0x%08x" % address
+        if not location.startswith("??"):
+            function = "%s (%s)" % (function, location.rsplit("/", 1)[-1])
+        names[address] = function
+    return names
+
+
+def format_cycles(cycles, clock_hz):
+    if clock_hz:
+        return "%d 周期 (%.2f us)" % (cycles, cycles * 1e6 / clock_hz)
+    return "%d 周期" % cycles
+
+
+def main():
+    parser = argparse.ArgumentParser(description="把 xCriticalTiming 的导出对照ELF符号化，按最长屏蔽时间列出调用点")
+    parser.add_argument("elf", help="与运行中固件相同的ELF")
+    parser.add_argument("dump", help="gdb 导出的 xCriticalTiming 二进制文件")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="工具链前缀，默认 arm-none-eabi-")
+    parser.add_argument("--buckets", type=int, default=16, help="configCRITICAL_TIMING_BUCKETS，默认16")
+    parser.add_argument("--clock-hz", type=float, help="CPU时钟频率，给出时同时显示微秒")
+    args = parser.parse_args()
+
+    max_cycles, max_site, overflows, sites = read_timing(args.dump, args.buckets)
+    names = symbolize(args.elf, args.prefix + "addr2line", sorted({s[0] for s in sites} | {max_site} - {0}))
+
+    print("最长屏蔽: %s，在 %s" % (format_cycles(max_cycles, args.clock_hz), names.get(max_site, "-")))
+    for address, count, site_max, histogram in sorted(sites, key=lambda s: s[2], reverse=True):
+        print("\n%s\n  次数 %d，最长 %s" % (names[address], count, format_cycles(site_max, args.clock_hz)))
+        for i, n in enumerate(histogram):
+            if n == 0:
+                continue
+            upper = ("%d" % ((1 << (i + 1)) - 1)) if i + 1 < args.buckets else "..."
+            print("  %7d - %-7s %10d" % (1 << i if i else 0, upper, n))
+    if overflows:
+        print("\n调用点表已满，%d 次屏蔽没有按调用点记录（只计入了最长屏蔽），可以增大 configCRITICAL_TIMING_SITES" % overflows,
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""故障现场记录解码
+
+固件打开 configUSE_POST_MORTEM，出故障或看门狗复位后，在调度器启动之前停下调试器（或由启动代码从串口发出），
+导出 .bss.noinit 中的记录：
+    (gdb) dump binary value postmortem.bin xPostMortem
+然后对照同一个ELF解码：
+    python3 tools/post_mortem.py firmware.elf postmortem.bin
+
+输出复位原因；故障时还有故障寄存器的含义、异常帧（PC、LR对应的函数与行号）、每个任务的栈水位；
+最后是切换环，从最旧到最新，最后一项就是停住前运行的任务。TCB地址按ELF符号表换成任务名（如 Task1TCB）。
+"""
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+MAGIC_RUNNING = 0x504D5255
+MAGIC_FAULT = 0x504D4654
+
+HEADER = struct.Struct("<IIII")         # ulMagic, ulSwitchSlots, ulStackSlots, ulSwitchCount
+SWITCH = struct.Struct("<II")           # ulTick, ulTask
+FAULT = struct.Struct("<IIII8IIIIII")   # ulTickCount ... ulStackCount
+STACK = struct.Struct("<IIII")          # ulTask, ulStack, ulDepth, ulFree
+
+FRAME_NAMES = ("r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr")
+
+# CFSR 各位：MMFSR(0-7)、BFSR(8-15)、UFSR(16-31)
+CFSR_BITS = {
+    0: "IACCVIOL 取指违反MPU", 1: "DACCVIOL 数据访问违反MPU（地址见MMFAR）", 3: "MUNSTKERR 出栈时违反MPU",
+    4: "MSTKERR 压栈时违反MPU（多半是栈溢出）", 5: "MLSPERR 浮点惰性压栈违反MPU", 7: "MMARVALID MMFAR有效",
+    8: "IBUSERR 取指总线错误", 9: "PRECISERR 精确数据总线错误（地址见BFAR）", 10: "IMPRECISERR 不精确数据总线错误（PC不是出错的指令）",
+    11: "UNSTKERR 出栈时总线错误", 12: "STKERR 压栈时总线错误（多半是栈溢出）", 13: "LSPERR 浮点惰性压栈总线错误",
+    15: "BFARVALID BFAR有效",
+    16: "UNDEFINSTR 未定义指令", 17: "INVSTATE 非法状态（跳到了偶数地址，不是Thumb）", 18: "INVPC 非法的异常返回",
+    19: "NOCP 协处理器不可用（没打开FPU）", 24: "UNALIGNED 非对齐访问", 25: "DIVBYZERO 除以0",
+}
+HFSR_BITS = {1: "VECTTBL 读向量表出错", 30: "FORCED 由可配置故障升级而来，原因见CFSR", 31: "DEBUGEVT 调试事件"}
+
+
+def parse(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit("%s: 文件太短，不是 xPostMortem 的导出" % path)
+    magic, switch_slots, stack_slots, switch_count = HEADER.unpack_from(data, 0)
+    expected = HEADER.size + switch_slots * SWITCH.size + FAULT.size + stack_slots * STACK.size
+    if magic not in (MAGIC_RUNNING, MAGIC_FAULT) or len(data) != expected:
+        return {"magic": magic}
+    offset = HEADER.size
+    used = min(switch_count, switch_slots)
+    switches = []
+    for n in range(switch_count - used, switch_count):
+        switches.append(SWITCH.unpack_from(data, offset + (n % switch_slots) * SWITCH.size))
+    offset += switch_slots * SWITCH.size
+    fields = FAULT.unpack_from(data, offset)
+    offset += FAULT.size
+    record = {
+        "magic": magic, "switch_count": switch_count, "switches": switches,
+        "tick": fields[0], "task": fields[1], "exc_return": fields[2], "sp": fields[3],
+        "frame": fields[4:12], "cfsr": fields[12], "hfsr": fields[13], "mmfar": fields[14], "bfar": fields[15],
+    }
+    stack_count = min(fields[16], stack_slots)
+    record["stacks"] = [STACK.unpack_from(data, offset + i * STACK.size) for i in range(stack_count)]
+    return record
+
+
+class Symbols:
+    """全局变量的地址范围，用来把TCB地址换成任务名"""
+
+    def __init__(self, elf, nm):
+        out = subprocess.run([nm, "-S", "--defined-only", elf], check=True, capture_output=True, text=True).stdout
+        self.symbols = []
+        for line in out.splitlines():
+            parts = line.split()
+            if len(parts) == 4 and parts[2] in "bBdD":
+                start = int(parts[0], 16)
+                self.symbols.append((start, start + int(parts[1], 16), parts[3]))
+        self.symbols.sort()
+        self.starts = [s[0] for s in self.symbols]
+
+    def task(self, address):
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i >= 0 and self.symbols[i][0] <= address < self.symbols[i][1]:
+            start, _, name = self.symbols[i]
+            return name if address == start else "%s+0x%x" % (name, address - start)
+        return "task@0x%08x" % address
+
+
+def code_location(elf, addr2line, address, is_return):
+    """代码地址换成“函数 (文件:行)”；LR是返回地址，减1才落在调用所在的行"""
+    query = (address & ~1) - (1 if is_return else 0)
+    out = subprocess.run([addr2line, "-f", "-C", "-e", elf, "0x%x" % query],
+                         check=True, capture_output=True, text=True).stdout.splitlines()
+    function, location = (out + ["??", "??:0"])[:2]
+    if function == "??":
+        return "?"
+    return function if location.startswith("??") else "%s (%s)" % (function, location.rsplit("/", 1)[-1])
+
+
+def bits(value, names):
+    return [text for bit, text in sorted(names.items()) if value & (1 << bit)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="把 xPostMortem 的导出对照ELF解码")
+    parser.add_argument("elf", help="与出故障的固件相同的ELF")
+    parser.add_argument("dump", help="gdb 导出的 xPostMortem 二进制文件")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="工具链前缀，默认 arm-none-eabi-")
+    args = parser.parse_args()
+
+    record = parse(args.dump)
+    if "switches" not in record:
+        print("ulMagic = 0x%08x：没有有效记录（上电复位，或者导出的大小与固件的配置不一致）" % record["magic"])
+        return
+    symbols = Symbols(args.elf, args.prefix + "nm")
+    addr2line = args.prefix + "addr2line"
+
+    if record["magic"] == MAGIC_FAULT:
+        frame = dict(zip(FRAME_NAMES, record["frame"]))
+        print("上次因 HardFault 复位，tick %d，当前任务 %s" % (record["tick"], symbols.task(record["task"])))
+        print("  EXC_RETURN 0x%08x，故障前用的是%s，栈指针 0x%08x"
+              % (record["exc_return"], "PSP（任务）" if record["exc_return"] & 4 else "MSP（中断）", record["sp"]))
+        print("  PC   0x%08x  %s" % (frame["pc"], code_location(args.elf, addr2line, frame["pc"], False)))
+        print("  LR   0x%08x  %s" % (frame["lr"], code_location(args.elf, addr2line, frame["lr"], True)))
+        print("  " + "  ".join("%s=0x%08x" % (name, frame[name]) for name in ("r0", "r1", "r2", "r3", "r12", "xpsr")))
+        print("  HFSR 0x%08x  %s" % (record["hfsr"], "，".join(bits(record["hfsr"], HFSR_BITS)) or "-"))
+        print("  CFSR 0x%08x  %s" % (record["cfsr"], "，".join(bits(record["cfsr"], CFSR_BITS)) or "-"))
+        if record["cfsr"] & (1 << 7):
+            print("  MMFAR 0x%08x" % record["mmfar"])
+        if record["cfsr"] & (1 << 15):
+            print("  BFAR  0x%08x" % record["bfar"])
+        print("\n栈水位（从没用到过的字数）：")
+        for task, stack, depth, free in record["stacks"]:
+            warning = "  <-- 用满了，很可能溢出" if free == 0 else ""
+            print("  %-24s 栈 0x%08x  %5d / %5d 字空闲%s" % (symbols.task(task), stack, free, depth, warning))
+    else:
+        print("上次在运行中复位（看门狗或手动复位），没有故障记录，只有切换环")
+
+    print("\n最近 %d 次任务切换（共 %d 次），从旧到新：" % (len(record["switches"]), record["switch_count"]))
+    for tick, task in record["switches"]:
+        print("  tick %10d  %s" % (tick, symbols.task(task)))
+
+
+if __name__ == "__main__":
+    main()
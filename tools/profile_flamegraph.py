@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""采样剖析结果转火焰图
+
+固件打开 configUSE_SAMPLING_PROFILER，运行一段时间后停下调试器，导出环形缓冲区：
+    (gdb) dump binary value profile.bin xProfilerRing
+然后对照同一个ELF生成火焰图：
+    python3 tools/profile_flamegraph.py firmware.elf profile.bin --svg profile.svg > profile.folded
+
+每个样本是一层任务名加上PC所在的函数，内联函数按 addr2line -i 展开成多层；
+任务名是TCB地址所在的全局变量名（如 Task1TCB），找不到时用地址。
+输出的 folded 格式（"任务;函数;内联函数 次数"）也可以交给 flamegraph.pl、speedscope 等工具。
+"""
+import argparse
+import bisect
+import collections
+import html
+import struct
+import subprocess
+import sys
+
+SAMPLE = struct.Struct("<II")  # ProfilerSample_t：ulPC, ulTask
+
+
+def read_samples(path):
+    """读出 ProfilerRing_t：ulCount 之后是 configPROFILER_SAMPLE_COUNT 个样本，没写满时只取前 ulCount 个"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < 4:
+        sys.exit("%s: 文件太短，不是 xProfilerRing 的导出" % path)
+    (count,) = struct.unpack_from("<I", data, 0)
+    capacity = (len(data) - 4) // SAMPLE.size
+    used = min(count, capacity)
+    return [SAMPLE.unpack_from(data, 4 + i * SAMPLE.size) for i in range(used)], count, capacity
+
+
+def load_data_symbols(elf, nm):
+    """全局变量的 (起始地址, 结束地址, 名字)，按地址排序，用来把TCB地址换成任务名"""
+    out = subprocess.run([nm, "-S", "--defined-only", elf], check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 4 or parts[2] not in "bBdD":
+            continue
+        start, size = int(parts[0], 16), int(parts[1], 16)
+        symbols.append((start, start + size, parts[3]))
+    symbols.sort()
+    return symbols
+
+
+def task_name(symbols, starts, address):
+    i = bisect.bisect_right(starts, address) - 1
+    if i >= 0 and symbols[i][0] <= address < symbols[i][1]:
+        start, _, name = symbols[i]
+        return name if address == start else "%s+0x%x" % (name, address - start)
+    return "task@0x%08x" % address
+
+
+def symbolize(elf, addr2line, addresses, with_lines):
+    """每个PC换成从外到内的函数列表，一次调用 addr2line 处理全部地址"""
+    if not addresses:
+        return {}
+    query = "\n".join("0x%x" % a for a in addresses) + "\n"
+    out = subprocess.run([addr2line, "-a", "-f", "-i", "-C", "-e", elf], input=query,
+                         check=True, capture_output=True, text=True).stdout.splitlines()
+    frames = {}
+    current = None
+    i = 0
+    while i < len(out):
+        line = out[i]
+        if line.startswith("0x"):
+            current = int(line, 16)
+            frames[current] = []
+            i += 1
+            continue
+        function = line if line != "??" else "0x%08x" % current
+        location = out[i + 1] if i + 1 < len(out) else "??:0"
+        if with_lines and not location.startswith("??"):
+            function = "%s (%s)" % (function, location.rsplit("/", 1)[-1])
+        frames[current].append(function)
+        i += 2
+    # addr2line -i 先输出最内层
+    return {a: list(reversed(f)) for a, f in frames.items()}
+
+
+def fold(samples, symbols, frames):
+    starts = [s[0] for s in symbols]
+    stacks = collections.Counter()
+    for pc, task in samples:
+        stack = [task_name(symbols, starts, task)] + frames.get(pc, ["0x%08x" % pc])
+        stacks[";".join(f.replace(";", ":") for f in stack)] += 1
+    return stacks
+
+
+def write_svg(path, stacks, title):
+    """最简单的火焰图：每层一行，宽度与样本数成正比，鼠标悬停显示名字与样本数"""
+    root = {"name": "all", "count": 0, "children": collections.OrderedDict()}
+    for stack, count in sorted(stacks.items()):
+        node = root
+        node["count"] += count
+        for frame in stack.split(";"):
+            node = node["children"].setdefault(frame, {"name": frame, "count": 0, "children": collections.OrderedDict()})
+            node["count"] += count
+
+    width, row, total = 1200.0, 16, max(root["count"], 1)
+    rects = []
+
+    def depth_of(node):
+        return 1 + max((depth_of(c) for c in node["children"].values()), default=0)
+
+    height = depth_of(root) * row + 40
+
+    def walk(node, x, depth):
+        w = width * node["count"] / total
+        y = height - (depth + 1) * row - 10
+        label = "%s (%d 样本, %.1f%%)" % (node["name"], node["count"], 100.0 * node["count"] / total)
+        hue = 30 + sum(node["name"].encode()) % 30  # 同一个名字每次颜色相同
+        text = html.escape(node["name"]) if w > 40 else ""
+        rects.append('<g><title>%s</title><rect x="%.1f" y="%d" width="%.1f" height="%d" fill="hsl(%d,90%%,60%%)" stroke="white"/>'
+                     '<text x="%.1f" y="%d" font-size="11">%s</text></g>'
+                     % (html.escape(label), x, y, w, row - 1, hue, x + 3, y + 12, text[: int(w / 7)]))
+        for child in node["children"].values():
+            walk(child, x, depth + 1)
+            x += width * child["count"] / total
+
+    walk(root, 0.0, 0)
+    with open(path, "w", encoding="utf-8") as f:
+        f.write('<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="monospace">\n' % (width, height))
+        f.write('<text x="4" y="16" font-size="14">%s</text>\n' % html.escape(title))
+        f.write("\n".join(rects))
+        f.write("\n</svg>\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="把 xProfilerRing 的导出对照ELF符号化，生成 folded 栈与SVG火焰图")
+    parser.add_argument("elf", help="与运行中固件相同的ELF")
+    parser.add_argument("dump", help="gdb 导出的 xProfilerRing 二进制文件")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="工具链前缀，默认 arm-none-eabi-")
+    parser.add_argument("--lines", action="store_true", help="函数名后面加上源文件行号")
+    parser.add_argument("--svg", help="同时输出SVG火焰图")
+    args = parser.parse_args()
+
+    samples, count, capacity = read_samples(args.dump)
+    symbols = load_data_symbols(args.elf, args.prefix + "nm")
+    frames = symbolize(args.elf, args.prefix + "addr2line", sorted({pc for pc, _ in samples}), args.lines)
+    stacks = fold(samples, symbols, frames)
+    for stack, n in stacks.most_common():
+        print("%s %d" % (stack, n))
+    if count > capacity:
+        print("共采样 %d 次，环形缓冲区只保留了最近的 %d 个" % (count, capacity), file=sys.stderr)
+    if args.svg:
+        write_svg(args.svg, stacks, "%s: %d 样本" % (args.elf, len(samples)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,284 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 活动对象
+ * freertos_config.h 中设置 configUSE_QUEUES、configUSE_MSGBUS 和 configUSE_ACTIVE_OBJECTS 为 1
+ * 4个状态机只用2个宿主任务的栈：
+ *   shared_host（任务优先级2）上有 ping、pong（对象优先级1）和 monitor（对象优先级2）
+ *   log_host（任务优先级1）上只有 logger，一个对象一个任务
+ * ticker 任务每个tick给 ping 发一个 TICK 事件，ping 收到后与 pong 来回 PINGS_PER_TICK 次，
+ * 每次带序号，sequence_errors 不为0说明丢失或乱序，上一轮还没结束时到来的 TICK 只计入 busy_ticks；ping 与 pong 在同一个宿主中，来回只是函数调用，不切换任务
+ * ticker 每 REPORT_TICKS 个tick在 TICK 之后给 monitor 发 REPORT，monitor 优先级高，应当先于这个 TICK 分发，
+ * order_errors 不为0说明同一宿主中没有按对象优先级分发；monitor 把 rounds 转发给另一个宿主上的 logger
+ * 打开 configUSE_TASK_SWITCH_COUNTERS 时 context_switches 是任务切换次数，远小于 rounds 的两倍
+ * （每个状态机一个任务时，每次来回至少切换两次）
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+#include "active.h"
+
+#if (configUSE_ACTIVE_OBJECTS == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_QUEUES、configUSE_MSGBUS 和 configUSE_ACTIVE_OBJECTS 为 1"
+#endif
+
+#define PINGS_PER_TICK 8
+#define REPORT_TICKS 10
+#define EVENT_BLOCKS 8
+#define QUEUE_LENGTH 4
+
+enum
+{
+	SIG_TICK = 1,
+	SIG_PING,
+	SIG_PONG,
+	SIG_REPORT,
+	SIG_LOG
+};
+
+typedef struct
+{
+	ActiveEvent_t super;
+	uint32_t value;
+} ValueEvent_t;
+
+typedef struct
+{
+	ActiveObject_t super;
+	uint32_t next_seq;
+	uint32_t burst_left;
+} Ping_t;
+
+volatile uint32_t rounds;
+volatile uint32_t sequence_errors;
+volatile uint32_t order_errors;
+volatile uint32_t post_failures;
+volatile uint32_t busy_ticks;
+volatile uint32_t logs;
+volatile uint32_t report_pending;
+volatile uint32_t context_switches;
+
+MsgPool_t EventPool;
+uint64_t event_pool_storage[msgbusPOOL_STORAGE_WORDS(EVENT_BLOCKS, sizeof(ValueEvent_t))];
+ActiveHost_t SharedHost;
+ActiveHost_t LogHost;
+Ping_t PingObject;
+ActiveObject_t PongObject;
+ActiveObject_t MonitorObject;
+ActiveObject_t LoggerObject;
+const ActiveEvent_t *ping_queue[QUEUE_LENGTH];
+const ActiveEvent_t *pong_queue[QUEUE_LENGTH];
+const ActiveEvent_t *monitor_queue[QUEUE_LENGTH];
+const ActiveEvent_t *logger_queue[QUEUE_LENGTH];
+
+static void post_value(ActiveObject_t *target, UBaseType_t signal, uint32_t value)
+{
+	ValueEvent_t *event = (ValueEvent_t *)pxActiveEventAlloc(&EventPool, signal, 0);
+
+	if (event == NULL)
+	{
+		post_failures++;
+		return;
+	}
+	event->value = value;
+	if (xActivePost(target, &event->super) != pdPASS)
+	{
+		post_failures++;
+	}
+}
+
+void ping_dispatch(ActiveObject_t *const object, const ActiveEvent_t *const event)
+{
+	Ping_t *const me = (Ping_t *)object;
+
+	switch (event->uxSignal)
+	{
+	case SIG_TICK:
+		if (report_pending)
+		{
+			order_errors++;
+		}
+		// 上一轮来回还没结束时不再开始新的一轮，否则两串来回交错
+		if (me->burst_left > 0)
+		{
+			busy_ticks++;
+			break;
+		}
+		me->burst_left = PINGS_PER_TICK;
+		post_value(&PongObject, SIG_PING, me->next_seq);
+		break;
+	case SIG_PONG:
+		if (((const ValueEvent_t *)event)->value != me->next_seq)
+		{
+			sequence_errors++;
+		}
+		me->next_seq++;
+		rounds++;
+		if (--me->burst_left > 0)
+		{
+			post_value(&PongObject, SIG_PING, me->next_seq);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void pong_dispatch(ActiveObject_t *const object, const ActiveEvent_t *const event)
+{
+	if (event->uxSignal == SIG_PING)
+	{
+		post_value(&PingObject.super, SIG_PONG, ((const ValueEvent_t *)event)->value);
+	}
+}
+
+void monitor_dispatch(ActiveObject_t *const object, const ActiveEvent_t *const event)
+{
+	if (event->uxSignal == SIG_REPORT)
+	{
+		report_pending = 0;
+		#if (configUSE_TASK_SWITCH_COUNTERS == 1)
+		{
+			TaskSwitchCounters_t counters;
+			vTaskGetSwitchCounters(&counters);
+			context_switches = counters.ulContextSwitches;
+		}
+		#endif
+		post_value(&LoggerObject, SIG_LOG, rounds);
+	}
+}
+
+void logger_dispatch(ActiveObject_t *const object, const ActiveEvent_t *const event)
+{
+	static uint32_t last_rounds;
+
+	if (event->uxSignal == SIG_LOG)
+	{
+		if (((const ValueEvent_t *)event)->value < last_rounds)
+		{
+			sequence_errors++;
+		}
+		last_rounds = ((const ValueEvent_t *)event)->value;
+		logs++;
+	}
+}
+
+// 普通任务，相当于定时中断，给活动对象发事件
+void ticker_entry(void *p_arg)
+{
+	uint32_t tick = 0;
+
+	for (;;)
+	{
+		vTaskDelay(1);
+		post_value(&PingObject.super, SIG_TICK, tick);
+		if (++tick % REPORT_TICKS == 0)
+		{
+			report_pending = 1;
+			post_value(&MonitorObject, SIG_REPORT, tick);
+		}
+	}
+}
+
+StaticTask_t SharedHostTCB;
+#define SHARED_HOST_STACK_SIZE 128
+StackType_t SharedHostStack[SHARED_HOST_STACK_SIZE];
+StaticTask_t LogHostTCB;
+#define LOG_HOST_STACK_SIZE 128
+StackType_t LogHostStack[LOG_HOST_STACK_SIZE];
+StaticTask_t TickerTCB;
+#define TICKER_STACK_SIZE 128
+StackType_t TickerStack[TICKER_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	vMsgPoolInitialise(&EventPool, event_pool_storage, EVENT_BLOCKS, sizeof(ValueEvent_t));
+	vActiveHostInitialise(&SharedHost);
+	vActiveHostInitialise(&LogHost);
+	vActiveObjectCreate(&PingObject.super, &SharedHost, ping_dispatch, 1, ping_queue, QUEUE_LENGTH);
+	vActiveObjectCreate(&PongObject, &SharedHost, pong_dispatch, 1, pong_queue, QUEUE_LENGTH);
+	vActiveObjectCreate(&MonitorObject, &SharedHost, monitor_dispatch, 2, monitor_queue, QUEUE_LENGTH);
+	vActiveObjectCreate(&LoggerObject, &LogHost, logger_dispatch, 1, logger_queue, QUEUE_LENGTH);
+
+	xTaskCreateStatic((TaskFunction_t)vActiveHostTask,
+					  "shared_host",
+					  SHARED_HOST_STACK_SIZE,
+					  &SharedHost,
+					  2,
+					  SharedHostStack,
+					  &SharedHostTCB);
+	xTaskCreateStatic((TaskFunction_t)vActiveHostTask,
+					  "log_host",
+					  LOG_HOST_STACK_SIZE,
+					  &LogHost,
+					  1,
+					  LogHostStack,
+					  &LogHostTCB);
+	xTaskCreateStatic((TaskFunction_t)ticker_entry,
+					  "ticker",
+					  TICKER_STACK_SIZE,
+					  NULL,
+					  3,
+					  TickerStack,
+					  &TickerTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,186 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 基本任务（运行到结束）
+ * freertos_config.h 中设置 configUSE_BASIC_TASKS 为 1
+ * 优先级2、3各有一个分发任务，各自一个栈；task1 是优先级1的普通任务，照常翻转 flag1
+ *   1. PERIODIC_COUNT 个优先级2的基本任务共用一个函数，第i个每 (i % 8) + 1 个tick定时激活一次，
+ *      翻转 led_bits 的第i位，run_counts[i] 计数
+ *   2. 优先级3的 sampler 每5个tick定时激活，每次激活两次优先级2的 filter；filter 优先级低，要等 sampler 返回后才运行，
+ *      filter_errors 不为0说明 filter 在 sampler 运行中途插了进来；激活不会丢，filter_runs 是 sampler_runs 的两倍
+ *   3. 每个基本任务进入时检查同优先级有没有别的基本任务正在运行，nesting_errors 不为0说明同优先级之间发生了抢占
+ * 优先级2的 PERIODIC_COUNT + 1 个基本任务只用一个栈，每个基本任务只占一个 BasicTask_t（size_basic_task 字节）
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_BASIC_TASKS == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_BASIC_TASKS 为 1"
+#endif
+
+#define PERIODIC_COUNT 16
+
+volatile uint32_t flag1;
+volatile uint32_t led_bits;
+volatile uint32_t run_counts[PERIODIC_COUNT];
+volatile uint32_t sampler_runs;
+volatile uint32_t filter_runs;
+volatile uint32_t filter_errors;
+volatile uint32_t nesting_errors;
+volatile uint32_t size_basic_task;
+volatile uint32_t level2_running;
+volatile uint32_t level3_running;
+
+BasicTask_t PeriodicBasic[PERIODIC_COUNT];
+BasicTask_t SamplerBasic;
+BasicTask_t FilterBasic;
+
+void periodic_entry(void *p_arg)
+{
+	uint32_t i = (uint32_t)(uintptr_t)p_arg;
+	if (level2_running != 0)
+	{
+		nesting_errors++;
+	}
+	level2_running = 1;
+	led_bits ^= (1UL << i);
+	run_counts[i]++;
+	level2_running = 0;
+}
+
+void sampler_entry(void *p_arg)
+{
+	if (level3_running != 0)
+	{
+		nesting_errors++;
+	}
+	level3_running = 1;
+	sampler_runs++;
+	// filter 优先级更低，两次激活都要等 sampler 返回后才运行
+	vTaskBasicActivate(&FilterBasic);
+	vTaskBasicActivate(&FilterBasic);
+	level3_running = 0;
+}
+
+void filter_entry(void *p_arg)
+{
+	if (level2_running != 0)
+	{
+		nesting_errors++;
+	}
+	level2_running = 1;
+	filter_runs++;
+	if (level3_running != 0)
+	{
+		filter_errors++;
+	}
+	level2_running = 0;
+}
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag1 = 1;
+		vTaskDelay(3);
+		flag1 = 0;
+		vTaskDelay(3);
+	}
+}
+
+StaticTask_t Task1TCB;
+TaskHandle_t task1_handle;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Level2TCB;
+#define LEVEL2_STACK_SIZE 128
+StackType_t Level2Stack[LEVEL2_STACK_SIZE];
+StaticTask_t Level3TCB;
+#define LEVEL3_STACK_SIZE 128
+StackType_t Level3Stack[LEVEL3_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	size_basic_task = sizeof(BasicTask_t);
+
+	task1_handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task1Stack,
+									 &Task1TCB);
+	xTaskBasicDispatcherCreateStatic(2, LEVEL2_STACK_SIZE, Level2Stack, &Level2TCB);
+	xTaskBasicDispatcherCreateStatic(3, LEVEL3_STACK_SIZE, Level3Stack, &Level3TCB);
+
+	for (uint32_t i = 0; i < PERIODIC_COUNT; i++)
+	{
+		vTaskBasicCreateStatic(periodic_entry, (void *)(uintptr_t)i, 2, &PeriodicBasic[i]);
+		vTaskBasicAlarmSet(&PeriodicBasic[i], (TickType_t)((i % 8) + 1), (TickType_t)((i % 8) + 1));
+	}
+	vTaskBasicCreateStatic(filter_entry, NULL, 2, &FilterBasic);
+	vTaskBasicCreateStatic(sampler_entry, NULL, 3, &SamplerBasic);
+	vTaskBasicAlarmSet(&SamplerBasic, 5, 5);
+
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
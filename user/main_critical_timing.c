@@ -0,0 +1,160 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 屏蔽中断时长统计
+ * freertos_config.h 中设置 configUSE_CRITICAL_TIMING 为 1（只支持 ARM_CM3、ARM_CM4F）
+ * task1 每轮进入一次很短的临界区（short_section），每 LONG_PERIOD 轮进入一次很长的临界区（long_section）；
+ * task2 每 100 个tick检查一次：启动后第一次检查时清空统计，之后 long_is_max 为1表示最长的一次屏蔽来自 long_section，
+ * max_cycles 是它的周期数。停下调试器后：
+ *   (gdb) dump binary value critical.bin xCriticalTiming
+ *   python3 tools/critical_report.py 固件.elf critical.bin --clock-hz 72000000
+ * 报告中 long_section、short_section、SysTick_Handler、PendSV_Handler 各一行，long_section 排在最前
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_CRITICAL_TIMING == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_CRITICAL_TIMING 为 1"
+#endif
+
+#define LONG_LOOP 2000
+#define LONG_PERIOD 50
+
+volatile uint32_t short_count;
+volatile uint32_t long_count;
+volatile uint32_t long_is_max;
+volatile uint32_t max_cycles;
+volatile uint32_t crunch_result;
+
+__attribute__((noinline)) void short_section(void)
+{
+	taskENTER_CRITICAL();
+	short_count++;
+	taskEXIT_CRITICAL();
+}
+
+__attribute__((noinline)) void long_section(void)
+{
+	taskENTER_CRITICAL();
+	for (uint32_t i = 0; i < LONG_LOOP; i++)
+	{
+		crunch_result = crunch_result * 1103515245UL + 12345UL;
+	}
+	long_count++;
+	taskEXIT_CRITICAL();
+}
+
+void task1_entry(void *p_arg)
+{
+	for (uint32_t i = 0;; i++)
+	{
+		short_section();
+		if ((i % LONG_PERIOD) == 0)
+		{
+			long_section();
+		}
+		if ((i % 10) == 0)
+		{
+			vTaskDelay(1);
+		}
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	vTaskDelay(100);
+	vPortCriticalTimingReset(); // 跳过启动阶段
+	for (;;)
+	{
+		vTaskDelay(100);
+		// 调用点是 long_section 中 vPortEnterCritical 的返回地址，在函数开头几条指令之内
+		long_is_max = ((xCriticalTiming.ulMaxSite & ~1UL) - ((uint32_t)long_section & ~1UL)) < 32UL;
+		max_cycles = xCriticalTiming.ulMaxCycles;
+	}
+}
+
+StaticTask_t Task1TCB;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	xTaskCreateStatic((TaskFunction_t)task1_entry,
+					  "task1",
+					  TASK1_STACK_SIZE,
+					  NULL,
+					  1,
+					  Task1Stack,
+					  &Task1TCB);
+	xTaskCreateStatic((TaskFunction_t)task2_entry,
+					  "task2",
+					  TASK2_STACK_SIZE,
+					  NULL,
+					  2,
+					  Task2Stack,
+					  &Task2TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
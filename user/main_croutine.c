@@ -0,0 +1,213 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 无栈协程
+ * freertos_config.h 中设置 configUSE_CO_ROUTINES 为 1
+ * task1 运行全部协程，没有就绪的协程时阻塞一个tick；task2 是普通任务，照常翻转 flag2
+ *   1. BLINKER_COUNT 个闪灯协程共用一个函数，第i个每 (i % 8) + 1 个tick翻转 led_bits 的第i位，blink_counts[i] 计数
+ *   2. 生产者协程每次连续发送8个递增的数，队列长度只有4，会等待消费者取走；消费者检查收到的数是连续的，
+ *      queue_errors 不为0说明丢失或重复
+ * 每个协程只占一个 CRCB_t（size_crcb 字节），而任务要一个TCB加上自己的栈
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+#include "croutine.h"
+
+#if (configUSE_CO_ROUTINES == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_CO_ROUTINES 为 1"
+#endif
+
+#define BLINKER_COUNT 32
+#define QUEUE_LENGTH 4
+
+volatile uint32_t flag2;
+volatile uint32_t led_bits;
+volatile uint32_t blink_counts[BLINKER_COUNT];
+volatile uint32_t items_sent;
+volatile uint32_t items_received;
+volatile uint32_t queue_errors;
+volatile uint32_t size_crcb;
+
+CRCB_t BlinkerCRCB[BLINKER_COUNT];
+CRCB_t ProducerCRCB;
+CRCB_t ConsumerCRCB;
+CoRoutineQueue_t number_queue;
+uint8_t number_queue_storage[QUEUE_LENGTH * sizeof(uint32_t)];
+
+// 局部变量在让出后不保留，这个函数中没有需要保留的状态
+void blinker_entry(CoRoutineHandle_t xHandle, UBaseType_t uxIndex)
+{
+	crSTART(xHandle);
+	for (;;)
+	{
+		crDELAY(xHandle, (TickType_t)((uxIndex % 8U) + 1U));
+		led_bits ^= (1UL << uxIndex);
+		blink_counts[uxIndex]++;
+	}
+	crEND();
+}
+
+void producer_entry(CoRoutineHandle_t xHandle, UBaseType_t uxIndex)
+{
+	static uint32_t next_number = 0;
+	static uint32_t burst;
+	BaseType_t result;
+
+	crSTART(xHandle);
+	for (;;)
+	{
+		for (burst = 0; burst < 8; burst++)
+		{
+			crQUEUE_SEND(xHandle, &number_queue, &next_number, 10, &result);
+			if (result == pdPASS)
+			{
+				next_number++;
+				items_sent++;
+			}
+		}
+		crDELAY(xHandle, 5);
+	}
+	crEND();
+}
+
+void consumer_entry(CoRoutineHandle_t xHandle, UBaseType_t uxIndex)
+{
+	static uint32_t expected = 0;
+	static uint32_t number;
+	BaseType_t result;
+
+	crSTART(xHandle);
+	for (;;)
+	{
+		crQUEUE_RECEIVE(xHandle, &number_queue, &number, 100, &result);
+		if (result == pdPASS)
+		{
+			if (number != expected)
+			{
+				queue_errors++;
+			}
+			expected = number + 1;
+			items_received++;
+		}
+	}
+	crEND();
+}
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		if (xCoRoutineSchedule() == pdFALSE)
+		{
+			vTaskDelay(1);
+		}
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag2 = 1;
+		vTaskDelay(3);
+		flag2 = 0;
+		vTaskDelay(3);
+	}
+}
+
+StaticTask_t Task1TCB;
+TaskHandle_t task1_handle;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+TaskHandle_t task2_handle;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	size_crcb = sizeof(CRCB_t);
+	vCoRoutineQueueInitialise(&number_queue, QUEUE_LENGTH, sizeof(uint32_t), number_queue_storage);
+	for (UBaseType_t i = 0; i < BLINKER_COUNT; i++)
+	{
+		xCoRoutineCreateStatic(blinker_entry, 0, i, &BlinkerCRCB[i]);
+	}
+	xCoRoutineCreateStatic(producer_entry, 1, 0, &ProducerCRCB);
+	xCoRoutineCreateStatic(consumer_entry, 0, 0, &ConsumerCRCB);
+
+	task1_handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task1Stack,
+									 &Task1TCB);
+	task2_handle = xTaskCreateStatic((TaskFunction_t)task2_entry,
+									 "task2",
+									 TASK2_STACK_SIZE,
+									 NULL,
+									 2,
+									 Task2Stack,
+									 &Task2TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
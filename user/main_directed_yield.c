@@ -0,0 +1,219 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 定向让出：4级流水线的每跳延时
+ * freertos_config.h 中设置 configUSE_DIRECTED_YIELD 为 1
+ * stage0 产生一个数据，经 stage1、stage2 到 stage3，每一级把数据放进下一级的槽里然后让出，共3跳；
+ * 同优先级还有 NOISE_COUNT 个一直在让出的任务（没有数据的级也在让出等待），创建顺序使轮转顺序与流水线方向相反。两种让出方式交替测量，每种 PHASE_TOKENS 个数据：
+ *   hop_avg[0]/hop_max[0]  taskYIELD：按轮转顺序，下一级要等同优先级的其他任务都轮一遍才运行
+ *   hop_avg[1]/hop_max[1]  vTaskYieldTo(下一级)：直接切到下一级
+ * 一跳的时间从放进槽里到下一级取出，单位是高精度时间计数：Cortex-M3 上是cpu时钟周期(DWT)，Posix port 上是纳秒
+ * tokens 是流过的数据个数，order_errors 不为0说明数据丢了或乱序
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_DIRECTED_YIELD == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_DIRECTED_YIELD 为 1"
+#endif
+#if (configNUMBER_OF_CORES > 1)
+#error "流水线各级需要在同一个核上，只在单核下测量"
+#endif
+
+#define STAGES 4
+#define NOISE_COUNT STAGES
+#define PHASE_TOKENS 256
+#define STAGE_STACK_SIZE 128
+
+volatile uint32_t tokens;
+volatile uint32_t order_errors;
+volatile uint32_t noise_runs;
+volatile uint32_t hop_sum[2];
+volatile uint32_t hop_count[2];
+volatile uint32_t hop_avg[2];
+volatile uint32_t hop_max[2];
+volatile uint32_t directed;     // 当前测量的让出方式，0:taskYIELD 1:vTaskYieldTo
+
+volatile uint32_t slot[STAGES];             // 0表示空
+volatile HighResTime_t slot_time[STAGES];   // 放进槽里的时刻
+
+TaskHandle_t stage_handles[STAGES];
+StaticTask_t StageTCB[STAGES];
+StackType_t StageStack[STAGES][STAGE_STACK_SIZE];
+StaticTask_t NoiseTCB[NOISE_COUNT];
+StackType_t NoiseStack[NOISE_COUNT][STAGE_STACK_SIZE];
+
+// 放进第 i 级的槽里，然后让给它
+void pass_to(uint32_t i, uint32_t value)
+{
+	slot_time[i] = portGET_HIGH_RES_TIME();
+	slot[i] = value;
+	if (directed)
+	{
+		vTaskYieldTo(stage_handles[i]);
+	}
+	else
+	{
+		taskYIELD();
+	}
+}
+
+// 等到第 i 级的槽里有数据，记下这一跳的时间
+uint32_t take_from(uint32_t i)
+{
+	uint32_t value;
+	uint32_t hop;
+
+	while (slot[i] == 0)
+	{
+		taskYIELD();
+	}
+	hop = (uint32_t)(portGET_HIGH_RES_TIME() - slot_time[i]);
+	value = slot[i];
+	slot[i] = 0;
+	if (i > 0)
+	{
+		hop_sum[directed] += hop;
+		hop_count[directed]++;
+		if (hop > hop_max[directed])
+		{
+			hop_max[directed] = hop;
+		}
+	}
+	return value;
+}
+
+void stage_entry(void *p_arg)
+{
+	uint32_t i = (uint32_t)(uintptr_t)p_arg;
+
+	for (;;)
+	{
+		uint32_t value = take_from(i);
+		if (i < STAGES - 1)
+		{
+			pass_to(i + 1, value);
+		}
+		else
+		{
+			// 最后一级：检查顺序，通知 stage0 可以产生下一个
+			if (value != tokens + 1)
+			{
+				order_errors++;
+			}
+			tokens = value;
+			pass_to(0, value);
+		}
+	}
+}
+
+void producer_entry(void *p_arg)
+{
+	uint32_t next = 1;
+
+	vPortHighResTimeInit();
+	for (;;)
+	{
+		if (((next - 1) % PHASE_TOKENS) == 0 && next > 1)
+		{
+			// 换一种让出方式前算出本阶段的平均值
+			hop_avg[directed] = hop_sum[directed] / hop_count[directed];
+			directed = !directed;
+		}
+		pass_to(1, next);
+		(void)take_from(0);
+		next++;
+	}
+}
+
+void noise_entry(void *p_arg)
+{
+	for (;;)
+	{
+		noise_runs++;
+		taskYIELD();
+	}
+}
+
+int main(void)
+{
+	dummy_noinit = 0;
+	// 倒序创建，每两级之间插一个干扰任务，轮转顺序与流水线方向相反
+	for (uint32_t i = STAGES; i-- > 0;)
+	{
+		stage_handles[i] = xTaskCreateStatic((i == 0) ? (TaskFunction_t)producer_entry : (TaskFunction_t)stage_entry,
+											 "stage",
+											 STAGE_STACK_SIZE,
+											 (void *)(uintptr_t)i,
+											 2,
+											 StageStack[i],
+											 &StageTCB[i]);
+		(void)xTaskCreateStatic((TaskFunction_t)noise_entry,
+								"noise",
+								STAGE_STACK_SIZE,
+								NULL,
+								2,
+								NoiseStack[i],
+								&NoiseTCB[i]);
+	}
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,186 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * cortex-m4f 惰性浮点上下文测试
+ * 工程使用 freertos/portable/GCC/ARM_CM4F，编译选项 -mcpu=cortex-m4 -mthumb -mfpu=fpv4-sp-d16 -mfloat-abi=hard
+ * task1、task2(优先级1) 用浮点反复做同一段计算，中间调用 vDelay，编译器会把中间结果放在 s16-s31 里，
+ * 时间片轮转时如果浮点寄存器没有正确保存恢复，结果就会与第一次计算的不同，fpu_error1/fpu_error2 会增加；
+ * task3(优先级2) 只用整数，周期性抢占浮点任务，它的栈上没有浮点上下文，切换时只比cortex-m3多保存一个字。
+ * 用过FPU的任务每次切换多占用 16+18 个字的栈（s16-s31 与硬件预留的 s0-s15、FPSCR），任务栈要留足。
+ *
+ * QEMU 中运行（没有DWT周期计数器，configUSE_HIGH_RES_TIMER 保持为0）：
+ *   qemu-system-arm -M mps2-an386 -nographic -kernel demo.elf -S -gdb tcp::1234      // cortex-m4f，25MHz
+ *   qemu-system-arm -M netduinoplus2 -nographic -kernel demo.elf -S -gdb tcp::1234   // stm32f405，cortex-m4f
+ *   configCPU_CLOCK_HZ 要改成对应机器的SysTick时钟，链接脚本与启动文件按机器的flash/ram地址编写
+ *   arm-none-eabi-gdb demo.elf -ex "target remote :1234" 后观察 fpu_loops1 fpu_loops2 递增、fpu_error1 fpu_error2 保持为0
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+volatile TickType_t flag1;
+volatile TickType_t flag2;
+volatile TickType_t flag3;
+volatile uint32_t fpu_loops1;
+volatile uint32_t fpu_loops2;
+volatile uint32_t fpu_error1;
+volatile uint32_t fpu_error2;
+
+void vDelay(uint32_t delay)
+{
+	for (uint32_t i = 0; i < delay; i++)
+		;
+}
+
+/* 中间结果跨越函数调用，编译器会用 callee-saved 的 s16-s31 保存 */
+static float prvFloatWork(float fSeed)
+{
+	float fSum = 0.0f;
+	float fTerm = fSeed;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		fSum += fTerm;
+		fTerm = fTerm * 0.75f + 0.125f;
+		vDelay(100);
+	}
+	return fSum * fTerm;
+}
+
+void task1_entry(void *p_arg)
+{
+	const float fReference = prvFloatWork(1.5f);
+	for (;;)
+	{
+		flag1 = 1;
+		if (prvFloatWork(1.5f) != fReference)
+		{
+			fpu_error1++;
+		}
+		flag1 = 0;
+		fpu_loops1++;
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	const float fReference = prvFloatWork(-3.25f);
+	for (;;)
+	{
+		flag2 = 1;
+		if (prvFloatWork(-3.25f) != fReference)
+		{
+			fpu_error2++;
+		}
+		flag2 = 0;
+		fpu_loops2++;
+	}
+}
+
+void task3_entry(void *p_arg)
+{
+	for (;;)
+	{	// 只用整数
+		flag3 = 1;
+		vTaskDelay(1);
+		flag3 = 0;
+		vTaskDelay(1);
+	}
+}
+
+StaticTask_t Task1TCB;
+TaskHandle_t task1_handle;
+#define TASK1_STACK_SIZE 256
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+TaskHandle_t task2_handle;
+#define TASK2_STACK_SIZE 256
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+StaticTask_t Task3TCB;
+TaskHandle_t task3_handle;
+#define TASK3_STACK_SIZE 128
+StackType_t Task3Stack[TASK3_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	task1_handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task1Stack,
+									 &Task1TCB);
+	task2_handle = xTaskCreateStatic((TaskFunction_t)task2_entry,
+									 "task2",
+									 TASK2_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task2Stack,
+									 &Task2TCB);
+	task3_handle = xTaskCreateStatic((TaskFunction_t)task3_entry,
+									 "task3",
+									 TASK3_STACK_SIZE,
+									 NULL,
+									 2,
+									 Task3Stack,
+									 &Task3TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
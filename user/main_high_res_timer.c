@@ -0,0 +1,175 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 高精度定时（单次SysTick + DWT周期计数器）
+ * freertos_config.h 中设置 configUSE_HIGH_RES_TIMER 为 1，只支持 ARM_CM3、ARM_CM4F
+ *   1. task1（优先级2）用 vTaskDelayUntilUs 以 PERIOD_US 为周期唤醒 BURST_PERIODS 次，周期比一个tick短，
+ *      period_late_us 记录实际唤醒比应该唤醒的时刻晚多少微秒（最小、最大）
+ *   2. 之后 task1 用 vTaskDelayUs 睡 QUIET_US，跨过好几个tick；这期间没有任务需要tick时SysTick不中断，
+ *      醒来时在一次中断中补齐所有tick：quiet_ticks 是这次睡眠中 xTickCount 走过的tick数，
+ *      tick_errors 计数 xTickCount 走过的tick与高精度时间换算出的tick相差超过1的次数，应为0
+ *   3. task2（优先级1）轮流用 delays_us[] 中不是tick整数倍的时长调用 vTaskDelayUs，
+ *      delay_late_us 记录实际延时比要求的长多少微秒（最小、最大）
+ * 正常时 period_late_us 与 delay_late_us 只有中断与任务切换的开销，几微秒，远小于一个tick
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_HIGH_RES_TIMER == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_HIGH_RES_TIMER 为 1"
+#endif
+
+#define PERIOD_US 250
+#define BURST_PERIODS 40
+#define QUIET_US 7300
+
+volatile uint32_t flag1;
+volatile uint32_t flag2;
+volatile uint32_t period_late_us[2] = {0xFFFFFFFFUL, 0};
+volatile uint32_t delay_late_us[2] = {0xFFFFFFFFUL, 0};
+volatile uint32_t periods;
+volatile uint32_t delays;
+volatile uint32_t quiet_ticks;
+volatile uint32_t tick_errors;
+
+static const uint32_t delays_us[] = {37, 420, 1234, 2750, 5101};
+
+/* 记录一次迟到的微秒数，late[0] 是最小值，late[1] 是最大值 */
+static void record_late(volatile uint32_t *late, HighResTime_t xLate)
+{
+	const uint32_t us = portHIGH_RES_TIME_TO_US(xLate);
+	if (us < late[0])
+	{
+		late[0] = us;
+	}
+	if (us > late[1])
+	{
+		late[1] = us;
+	}
+}
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		HighResTime_t wake = xTaskGetHighResTime();
+		for (uint32_t i = 0; i < BURST_PERIODS; i++)
+		{
+			vTaskDelayUntilUs(&wake, PERIOD_US);
+			record_late(period_late_us, xTaskGetHighResTime() - wake);
+			flag1 ^= 1;
+			periods++;
+		}
+
+		TickType_t ticks = xTaskGetTickCount();
+		HighResTime_t start = xTaskGetHighResTime();
+		vTaskDelayUs(QUIET_US);
+		ticks = xTaskGetTickCount() - ticks;
+		// 高精度时间换算出的tick数与这段时间在tick边界上的位置有关，允许差1
+		uint32_t expected = (uint32_t)((xTaskGetHighResTime() - start) / portHIGH_RES_COUNTS_PER_TICK);
+		quiet_ticks = (uint32_t)ticks;
+		if (((uint32_t)ticks > expected + 1UL) || ((uint32_t)ticks + 1UL < expected))
+		{
+			tick_errors++;
+		}
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	for (uint32_t n = 0;; n++)
+	{
+		const uint32_t us = delays_us[n % (sizeof(delays_us) / sizeof(delays_us[0]))];
+		HighResTime_t start = xTaskGetHighResTime();
+		vTaskDelayUs(us);
+		record_late(delay_late_us, xTaskGetHighResTime() - start - portHIGH_RES_TIME_FROM_US(us));
+		flag2 ^= 1;
+		delays++;
+	}
+}
+
+StaticTask_t Task1TCB;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	xTaskCreateStatic((TaskFunction_t)task1_entry,
+					  "task1",
+					  TASK1_STACK_SIZE,
+					  NULL,
+					  2,
+					  Task1Stack,
+					  &Task1TCB);
+	xTaskCreateStatic((TaskFunction_t)task2_entry,
+					  "task2",
+					  TASK2_STACK_SIZE,
+					  NULL,
+					  1,
+					  Task2Stack,
+					  &Task2TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,239 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 空闲工作队列
+ * freertos_config.h 中设置 configUSE_IDLE_WORK_QUEUE 为 1，可以同时打开 configUSE_IDLE_WFI
+ * task1、task2 是普通任务，大部分时间在延时，剩下的时间由空闲任务分片运行三个后台工作：
+ *   1. scrub：校验和巡检，每片累加 SCRUB_SLICE 字节，一轮扫完 image 后与 image_sum 比较，
+ *      scrub_passes 是扫完的轮数，scrub_errors 不为0说明校验和不对；做不完，一直排队
+ *   2. compact：task2 每个tick写一条日志，超过一半时提交压缩工作，每片搬走 COMPACT_SLICE 条，搬完就结束；
+ *      compacted_records 应该跟上 logged_records
+ *   3. report：task1 每 100 个tick提交一次的单次工作，上一次还没运行时提交失败，submit_rejects 计数
+ * 不需要为后台工作创建任务与栈，它们只占 IdleWork_t（size_idle_work 字节）
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_IDLE_WORK_QUEUE == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_IDLE_WORK_QUEUE 为 1"
+#endif
+
+#define IMAGE_SIZE 4096
+#define SCRUB_SLICE 64
+#define LOG_LENGTH 64
+#define COMPACT_SLICE 8
+
+volatile uint32_t flag1;
+volatile uint32_t flag2;
+volatile uint32_t scrub_passes;
+volatile uint32_t scrub_errors;
+volatile uint32_t logged_records;
+volatile uint32_t compacted_records;
+volatile uint32_t log_overflows;
+volatile uint32_t report_runs;
+volatile uint32_t submit_rejects;
+volatile uint32_t idle_slices;
+volatile uint32_t size_idle_work;
+
+uint8_t image[IMAGE_SIZE];
+uint32_t image_sum;
+uint32_t log_records[LOG_LENGTH];
+volatile uint32_t log_count;
+
+IdleWork_t ScrubWork;
+IdleWork_t CompactWork;
+IdleWork_t ReportWork;
+
+BaseType_t scrub_entry(void *p_arg)
+{
+	static uint32_t offset;
+	static uint32_t sum;
+
+	for (uint32_t i = 0; i < SCRUB_SLICE; i++)
+	{
+		sum += image[offset + i];
+	}
+	offset += SCRUB_SLICE;
+	if (offset >= IMAGE_SIZE)
+	{
+		if (sum != image_sum)
+		{
+			scrub_errors++;
+		}
+		scrub_passes++;
+		offset = 0;
+		sum = 0;
+	}
+	idle_slices++;
+	return pdTRUE;
+}
+
+// 从头搬走最多 COMPACT_SLICE 条，剩下的前移；和 task2 写日志互斥
+BaseType_t compact_entry(void *p_arg)
+{
+	BaseType_t more;
+
+	taskENTER_CRITICAL();
+	{
+		uint32_t n = (log_count < COMPACT_SLICE) ? log_count : COMPACT_SLICE;
+		for (uint32_t i = n; i < log_count; i++)
+		{
+			log_records[i - n] = log_records[i];
+		}
+		log_count -= n;
+		compacted_records += n;
+		more = (log_count > 0) ? pdTRUE : pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+	idle_slices++;
+	return more;
+}
+
+BaseType_t report_entry(void *p_arg)
+{
+	report_runs++;
+	idle_slices++;
+	return pdFALSE;
+}
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag1 = 1;
+		vTaskDelay(50);
+		flag1 = 0;
+		vTaskDelay(50);
+		if (xTaskIdleWorkSubmit(&ReportWork) == pdFAIL)
+		{
+			submit_rejects++;
+		}
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag2 = !flag2;
+		taskENTER_CRITICAL();
+		{
+			if (log_count < LOG_LENGTH)
+			{
+				log_records[log_count] = logged_records;
+				log_count++;
+				logged_records++;
+			}
+			else
+			{
+				log_overflows++;
+			}
+		}
+		taskEXIT_CRITICAL();
+		if (log_count > LOG_LENGTH / 2)
+		{
+			(void)xTaskIdleWorkSubmit(&CompactWork);
+		}
+		vTaskDelay(1);
+	}
+}
+
+StaticTask_t Task1TCB;
+TaskHandle_t task1_handle;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+TaskHandle_t task2_handle;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	size_idle_work = sizeof(IdleWork_t);
+	for (uint32_t i = 0; i < IMAGE_SIZE; i++)
+	{
+		image[i] = (uint8_t)(i * 7 + 3);
+		image_sum += image[i];
+	}
+
+	vTaskIdleWorkInitialise(&ScrubWork, scrub_entry, NULL);
+	vTaskIdleWorkInitialise(&CompactWork, compact_entry, NULL);
+	vTaskIdleWorkInitialise(&ReportWork, report_entry, NULL);
+	(void)xTaskIdleWorkSubmit(&ScrubWork);
+
+	task1_handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 2,
+									 Task1Stack,
+									 &Task1TCB);
+	task2_handle = xTaskCreateStatic((TaskFunction_t)task2_entry,
+									 "task2",
+									 TASK2_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task2Stack,
+									 &Task2TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,218 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 同步IPC：客户/服务驱动任务
+ * freertos_config.h 中设置 configUSE_RENDEZVOUS_IPC 为 1
+ * driver 是优先级1的服务任务，从端点接收请求，读写一个模拟的寄存器组后回复；
+ *   client_high（优先级4）每个tick调用一次，测量往返时间 rtt_avg/rtt_max（高精度时间计数，Cortex-M3 上是cpu时钟周期，Posix port 上是纳秒）
+ *   client_low（优先级1）不停地调用，driver 大部分时间在为它服务
+ *   hog（优先级3）每5个tick忙2个tick
+ * driver 服务 client_high 时继承优先级4，正在服务 client_low 时 client_high 排队也会把它提升到4，
+ * 所以 hog 忙的时候 client_high 也不用等它，rtt_max 远小于2个tick
+ * inherit_errors：driver 服务时的优先级低于调用者；reply_errors：回复内容不对；两者都应该为0
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_RENDEZVOUS_IPC == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_RENDEZVOUS_IPC 为 1"
+#endif
+
+#define CMD_WRITE 1
+#define CMD_READ 2
+#define REG_COUNT 8
+#define SERVICE_SPIN 200
+
+typedef struct
+{
+	uint32_t cmd;
+	uint32_t reg;
+	uint32_t value;
+} request_t;
+
+typedef struct
+{
+	uint32_t status;
+	uint32_t value;
+} reply_t;
+
+volatile uint32_t calls_high;
+volatile uint32_t calls_low;
+volatile uint32_t served;
+volatile uint32_t reply_errors;
+volatile uint32_t inherit_errors;
+volatile uint32_t rtt_avg;
+volatile uint32_t rtt_max;
+volatile uint32_t hog_spins;
+
+IpcEndpoint_t DriverEndpoint;
+uint32_t registers[REG_COUNT];
+uint64_t rtt_sum;
+
+void driver_entry(void *p_arg)
+{
+	request_t req;
+	reply_t rep;
+	size_t len;
+
+	for (;;)
+	{
+		TaskHandle_t caller = xTaskIpcReceive(&DriverEndpoint, &req, sizeof(req), &len);
+
+		if (uxTaskPriorityGet(NULL) < uxTaskPriorityGet(caller))
+		{
+			inherit_errors++;
+		}
+		rep.status = (len == sizeof(req)) ? 0 : 1;
+		if (req.cmd == CMD_WRITE)
+		{
+			registers[req.reg % REG_COUNT] = req.value;
+		}
+		rep.value = registers[req.reg % REG_COUNT];
+		// 模拟访问外设的耗时
+		for (volatile uint32_t i = 0; i < SERVICE_SPIN; i++)
+		{
+		}
+		served++;
+		vTaskIpcReply(caller, &rep, sizeof(rep));
+	}
+}
+
+void client_high_entry(void *p_arg)
+{
+	request_t req = {CMD_WRITE, 0, 0};
+	reply_t rep;
+
+	for (;;)
+	{
+		HighResTime_t start = portGET_HIGH_RES_TIME();
+		uint32_t rtt;
+
+		req.value++;
+		if ((xTaskIpcCall(&DriverEndpoint, &req, sizeof(req), &rep, sizeof(rep)) != sizeof(rep)) ||
+			(rep.status != 0) || (rep.value != req.value))
+		{
+			reply_errors++;
+		}
+		rtt = (uint32_t)(portGET_HIGH_RES_TIME() - start);
+		calls_high++;
+		rtt_sum += rtt;
+		rtt_avg = (uint32_t)(rtt_sum / calls_high);
+		if (rtt > rtt_max)
+		{
+			rtt_max = rtt;
+		}
+		vTaskDelay(1);
+	}
+}
+
+void client_low_entry(void *p_arg)
+{
+	request_t req = {CMD_WRITE, 1, 0};
+	reply_t rep;
+
+	for (;;)
+	{
+		req.value++;
+		(void)xTaskIpcCall(&DriverEndpoint, &req, sizeof(req), &rep, sizeof(rep));
+		if (rep.value != req.value)
+		{
+			reply_errors++;
+		}
+		calls_low++;
+	}
+}
+
+// 先延时，让 driver 先运行到接收：第一次接收之前端点还不知道服务任务是谁，没法提升它
+void hog_entry(void *p_arg)
+{
+	for (;;)
+	{
+		vTaskDelay(3);
+		TickType_t start = xTaskGetTickCount();
+		while ((TickType_t)(xTaskGetTickCount() - start) < 2)
+		{
+			hog_spins++;
+		}
+	}
+}
+
+StaticTask_t DriverTCB;
+StackType_t DriverStack[128];
+StaticTask_t ClientHighTCB;
+StackType_t ClientHighStack[128];
+StaticTask_t ClientLowTCB;
+StackType_t ClientLowStack[128];
+StaticTask_t HogTCB;
+StackType_t HogStack[128];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	vPortHighResTimeInit();
+	vTaskIpcEndpointInitialise(&DriverEndpoint);
+	(void)xTaskCreateStatic((TaskFunction_t)driver_entry, "driver", 128, NULL, 1, DriverStack, &DriverTCB);
+	(void)xTaskCreateStatic((TaskFunction_t)client_high_entry, "client_high", 128, NULL, 4, ClientHighStack, &ClientHighTCB);
+	(void)xTaskCreateStatic((TaskFunction_t)client_low_entry, "client_low", 128, NULL, 1, ClientLowStack, &ClientLowTCB);
+	(void)xTaskCreateStatic((TaskFunction_t)hog_entry, "hog", 128, NULL, 3, HogStack, &HogTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
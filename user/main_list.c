@@ -57,12 +57,386 @@
 
 __attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
 
+/* ----------------------------------------------------------------------------
+ * list.c 随机测试与计时
+ * 两个链表、LIST_TEST_ITEMS 个节点，随机执行初始化、各种插入、删除与 listGET_OWNER_OF_NEXT_ENTRY，
+ * 每一步之后与参考模型（按链表顺序排列的节点编号数组 + pxIndex 的位置）逐项比较：
+ *   1. 从头往后、从尾往前走一遍，节点顺序与模型相同，节点数等于 uxNumberOfItems
+ *   2. 每个节点的所属容器是这个链表，不在链表中的节点所属容器为空
+ *   3. 有序链表从小到大排列，pxIndex 指向模型中的位置（结束标记或某个节点）
+ * list_errors 不为0时，first_error_step / first_error_code 记录第一次出错的步数与检查项
+ * op_avg_counts[] 是每种操作平均耗时的高精度时间计数（包括读计数器本身的开销），修改链表实现前后对比
+ * 主机上用 Posix port 编译可以跑更多步：-DLIST_TEST_STEPS=1000000，跑完打印步数、出错数与平均耗时，有错时返回1，可以直接放进脚本
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+#if defined(__linux__)
+#include <stdio.h>
+#endif
+
+#ifndef LIST_TEST_STEPS
+#define LIST_TEST_STEPS 20000
+#endif
+#define LIST_TEST_ITEMS 32
+#define LIST_TEST_NONE 0xFFFFFFFFUL
+
+enum
+{
+	OP_INITIALISE,      // 清空一个链表
+	OP_INSERT,          // vListInsert 插入有序链表
+	OP_INSERT_BIDIR,    // vListInsertBidirectional 插入有序链表
+	OP_INSERT_HINTED,   // vListInsertHinted 插入有序链表，随机提示节点
+	OP_INSERT_END,      // vListInsertEnd 插入轮转链表
+	OP_REMOVE,          // uxListRemove
+	OP_NEXT_OWNER,      // listGET_OWNER_OF_NEXT_ENTRY 轮转
+	OP_COUNT
+};
+
+// 参考模型：链表中节点编号的顺序，index 是 pxIndex 指向的位置，LIST_TEST_NONE 表示结束标记
+typedef struct
+{
+	uint32_t ids[LIST_TEST_ITEMS];
+	uint32_t n;
+	uint32_t index;
+} ListModel_t;
+
+volatile uint32_t list_steps;
+volatile uint32_t list_errors;
+volatile uint32_t first_error_step;
+volatile uint32_t first_error_code;
+volatile uint32_t op_counts[OP_COUNT];
+volatile uint32_t op_avg_counts[OP_COUNT];
+
+List_t test_lists[2];                       // 0 有序链表，1 轮转链表
+ListModel_t models[2];
+ListItem_t test_items[LIST_TEST_ITEMS];
+uint32_t item_owners[LIST_TEST_ITEMS];      // 节点的拥有者，相当于TCB
+uint32_t item_list[LIST_TEST_ITEMS];        // 节点在哪个链表中，LIST_TEST_NONE 表示不在链表中
+uint32_t op_total_counts[OP_COUNT];
+uint32_t test_seed = 1;
+
+static uint32_t test_random(uint32_t range)
+{
+	test_seed = test_seed * 1664525UL + 1013904223UL;
+	return (test_seed >> 8) % range;
+}
+
+static void test_fail(uint32_t code)
+{
+	if (list_errors == 0)
+	{
+		first_error_step = list_steps;
+		first_error_code = code;
+	}
+	list_errors++;
+}
+
+static void model_insert_at(ListModel_t *model, uint32_t pos, uint32_t id)
+{
+	for (uint32_t k = model->n; k > pos; k--)
+	{
+		model->ids[k] = model->ids[k - 1];
+	}
+	model->ids[pos] = id;
+	model->n++;
+}
+
+// 与 vListInsert 的规则一样：插在第一个比新值大的节点前面，portMAX_DELAY 插在末尾
+static void model_insert_sorted(ListModel_t *model, uint32_t id)
+{
+	TickType_t value = listGET_LIST_ITEM_VALUE(&test_items[id]);
+	uint32_t pos = 0;
+
+	if (value == portMAX_DELAY)
+	{
+		pos = model->n;
+	}
+	else
+	{
+		while ((pos < model->n) && (listGET_LIST_ITEM_VALUE(&test_items[model->ids[pos]]) <= value))
+		{
+			pos++;
+		}
+	}
+	model_insert_at(model, pos, id);
+}
+
+// 插在 pxIndex 前面，pxIndex 是结束标记时插在末尾
+static void model_insert_end(ListModel_t *model, uint32_t id)
+{
+	if (model->index == LIST_TEST_NONE)
+	{
+		model_insert_at(model, model->n, id);
+	}
+	else
+	{
+		model_insert_at(model, model->index, id);
+		model->index++;
+	}
+}
+
+// 删除后 pxIndex 指向被删节点时退到前一个节点，前面没有节点时退到结束标记
+static void model_remove(ListModel_t *model, uint32_t id)
+{
+	uint32_t pos = 0;
+	while (model->ids[pos] != id)
+	{
+		pos++;
+	}
+	for (uint32_t k = pos; k + 1 < model->n; k++)
+	{
+		model->ids[k] = model->ids[k + 1];
+	}
+	model->n--;
+	if (model->index == pos)
+	{
+		model->index = (pos == 0) ? LIST_TEST_NONE : pos - 1;
+	}
+	else if ((model->index != LIST_TEST_NONE) && (model->index > pos))
+	{
+		model->index--;
+	}
+}
+
+static uint32_t model_next_owner(ListModel_t *model)
+{
+	if ((model->index == LIST_TEST_NONE) || (model->index + 1 >= model->n))
+	{
+		model->index = 0;
+	}
+	else
+	{
+		model->index++;
+	}
+	return model->ids[model->index];
+}
+
+static void test_check(uint32_t l)
+{
+	List_t *list = &test_lists[l];
+	ListModel_t *model = &models[l];
+	ListItem_t *item = listGET_HEAD_ENTRY(list);
+	uint32_t k;
+
+	if (listCURRENT_LIST_LENGTH(list) != model->n)
+	{
+		test_fail(1);
+	}
+	for (k = 0; (k < model->n) && (item != listGET_END_MARKER(list)); k++, item = listGET_NEXT(item))
+	{
+		if (item != &test_items[model->ids[k]])
+		{
+			test_fail(2);
+		}
+		if (listIS_CONTAINED_WITHIN(list, item) == pdFALSE)
+		{
+			test_fail(3);
+		}
+		if ((l == 0) && (listGET_NEXT(item) != listGET_END_MARKER(list)) &&
+			(listGET_LIST_ITEM_VALUE(listGET_NEXT(item)) < listGET_LIST_ITEM_VALUE(item)))
+		{
+			test_fail(4);
+		}
+	}
+	if ((k != model->n) || (item != listGET_END_MARKER(list)))
+	{
+		test_fail(5);
+	}
+	item = listGET_PREVIOUS(&(list->xListEnd));   // 结束标记是 MiniListItem_t，直接读它的链接，不转成 ListItem_t
+	for (k = model->n; k > 0; k--, item = listGET_PREVIOUS(item))
+	{
+		if (item != &test_items[model->ids[k - 1]])
+		{
+			test_fail(6);
+			break;
+		}
+	}
+	if (listGET_INDEX(list) != ((model->index == LIST_TEST_NONE) ? (ListItem_t *)listGET_END_MARKER(list) : &test_items[model->ids[model->index]]))
+	{
+		test_fail(7);
+	}
+}
+
+static void test_check_all(void)
+{
+	test_check(0);
+	test_check(1);
+	for (uint32_t id = 0; id < LIST_TEST_ITEMS; id++)
+	{
+		if ((item_list[id] == LIST_TEST_NONE) && (listIS_IN_ANY_LIST(&test_items[id]) != pdFALSE))
+		{
+			test_fail(8);
+		}
+	}
+}
+
+// 模型清空，链表本身由调用者 vListInitialise
+static void test_initialise(uint32_t l)
+{
+	for (uint32_t id = 0; id < LIST_TEST_ITEMS; id++)
+	{
+		if (item_list[id] == l)
+		{   // vListInitialise 不会修改链表中原有的节点，这里当作它们已经离开链表
+			vListInitialiseItem(&test_items[id]);
+			item_list[id] = LIST_TEST_NONE;
+		}
+	}
+	models[l].n = 0;
+	models[l].index = LIST_TEST_NONE;
+}
+
+// 执行一步随机操作，返回操作种类，计时只包括链表函数本身
+static uint32_t test_step(void)
+{
+	uint32_t op = test_random(OP_COUNT);
+	uint32_t id = test_random(LIST_TEST_ITEMS);
+	uint32_t l = (op == OP_INSERT_END || op == OP_NEXT_OWNER) ? 1 : test_random(2);
+	HighResTime_t start = 0, end = 0;
+
+	if ((op == OP_INITIALISE) && (test_random(64) != 0))
+	{   // 清空不能太频繁，否则链表一直很短
+		op = OP_REMOVE;
+	}
+	if ((op >= OP_INSERT) && (op <= OP_INSERT_END) && (item_list[id] != LIST_TEST_NONE))
+	{   // 节点已经在链表中，换成删除它
+		op = OP_REMOVE;
+	}
+	if ((op == OP_REMOVE) && (item_list[id] == LIST_TEST_NONE))
+	{
+		return OP_COUNT;
+	}
+	if ((op == OP_NEXT_OWNER) && (models[1].n == 0))
+	{
+		return OP_COUNT;
+	}
+
+	switch (op)
+	{
+	case OP_INITIALISE:
+		test_initialise(l);
+		start = portGET_HIGH_RES_TIME();
+		vListInitialise(&test_lists[l]);
+		end = portGET_HIGH_RES_TIME();
+		break;
+	case OP_INSERT:
+	case OP_INSERT_BIDIR:
+	case OP_INSERT_HINTED:
+	{
+		// 小范围的值制造大量相等的节点，偶尔用 portMAX_DELAY
+		TickType_t value = (test_random(16) == 0) ? portMAX_DELAY : (TickType_t)test_random(LIST_TEST_ITEMS);
+		ListItem_t *hint = NULL;
+		if ((op == OP_INSERT_HINTED) && (models[0].n != 0) && (test_random(4) != 0))
+		{
+			hint = &test_items[models[0].ids[test_random(models[0].n)]];
+		}
+		listSET_LIST_ITEM_VALUE(&test_items[id], value);
+		start = portGET_HIGH_RES_TIME();
+		if (op == OP_INSERT)
+		{
+			vListInsert(&test_lists[0], &test_items[id]);
+		}
+		else if (op == OP_INSERT_BIDIR)
+		{
+			vListInsertBidirectional(&test_lists[0], &test_items[id]);
+		}
+		else
+		{
+			vListInsertHinted(&test_lists[0], hint, &test_items[id]);
+		}
+		end = portGET_HIGH_RES_TIME();
+		model_insert_sorted(&models[0], id);
+		item_list[id] = 0;
+		break;
+	}
+	case OP_INSERT_END:
+		start = portGET_HIGH_RES_TIME();
+		vListInsertEnd(&test_lists[1], &test_items[id]);
+		end = portGET_HIGH_RES_TIME();
+		model_insert_end(&models[1], id);
+		item_list[id] = 1;
+		break;
+	case OP_REMOVE:
+	{
+		UBaseType_t remaining;
+		l = item_list[id];
+		start = portGET_HIGH_RES_TIME();
+		remaining = uxListRemove(&test_items[id]);
+		end = portGET_HIGH_RES_TIME();
+		model_remove(&models[l], id);
+		item_list[id] = LIST_TEST_NONE;
+		if (remaining != models[l].n)
+		{
+			test_fail(9);
+		}
+		break;
+	}
+	default:
+	{
+		uint32_t *owner;
+		start = portGET_HIGH_RES_TIME();
+		// 跨过结束标记时宏只读它的 pxNext，不读 pvOwner，但编译器按 ListItem_t 大小检查，会误报越界
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+		listGET_OWNER_OF_NEXT_ENTRY(owner, &test_lists[1]);
+#pragma GCC diagnostic pop
+		end = portGET_HIGH_RES_TIME();
+		if (owner != &item_owners[model_next_owner(&models[1])])
+		{
+			test_fail(10);
+		}
+		break;
+	}
+	}
+	op_total_counts[op] += (uint32_t)(end - start);
+	op_counts[op]++;
+	return op;
+}
+
 int main(void)
 {
 	dummy_noinit = 0;
-	
-	while(1)
+	vPortHighResTimeInit();
+	for (uint32_t id = 0; id < LIST_TEST_ITEMS; id++)
+	{
+		vListInitialiseItem(&test_items[id]);
+		listSE_LIST_ITEM_OWNER(&test_items[id], &item_owners[id]);
+		item_list[id] = LIST_TEST_NONE;
+	}
+	test_initialise(0);
+	test_initialise(1);
+	vListInitialise(&test_lists[0]);
+	vListInitialise(&test_lists[1]);
+
+	for (list_steps = 0; list_steps < LIST_TEST_STEPS; list_steps++)
+	{
+		if (test_step() != OP_COUNT)
+		{
+			test_check_all();
+		}
+	}
+	for (uint32_t op = 0; op < OP_COUNT; op++)
+	{
+		op_avg_counts[op] = (op_counts[op] != 0) ? (op_total_counts[op] / op_counts[op]) : 0;
+	}
+
+#if defined(__linux__)
+	// Posix port：没有调试器看变量，打印结果并用返回值表示是否通过
+	printf("steps=%u errors=%u", (unsigned)list_steps, (unsigned)list_errors);
+	if (list_errors != 0)
+	{
+		printf(" first_error_step=%u first_error_code=%u", (unsigned)first_error_step, (unsigned)first_error_code);
+	}
+	printf("\navg:");
+	for (uint32_t op = 0; op < OP_COUNT; op++)
+	{
+		printf(" %u", (unsigned)op_avg_counts[op]);
+	}
+	printf("\n%s\n", (list_errors == 0) ? "PASS" : "FAIL");
+	return (list_errors == 0) ? 0 : 1;
+#else
+	while (1)
 	{
 	}
 	return 0;
+#endif
 }
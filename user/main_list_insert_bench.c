@@ -0,0 +1,194 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 有序插入基准：vListInsert（从头往后找）、vListInsertBidirectional（按头尾选方向）、
+ * vListInsertHinted（用上一次插入的节点作提示）
+ * 每种插入方式、每种数据模式、每个规模都从空链表插满 n 个节点，insert_counts 是平均每次插入的高精度时间计数
+ * （Cortex-M3 上是cpu时钟周期，Posix port 上是纳秒）
+ *   模式0 递增：像延时时间一样越插越靠后，vListInsert 每次都要走完整个链表
+ *   模式1 随机：线性同余随机数
+ *   模式2 尾部附近：在最大值附近小范围随机，相当于很多周期相近的任务
+ * 插满后检查链表有序且节点数正确，list_errors 不为0说明插入位置错了
+ * 10000个节点要200KB内存，Cortex-M3 上默认只测到1000，主机上编译时加 -DBENCH_MAX_ITEMS=10000
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#ifndef BENCH_MAX_ITEMS
+#define BENCH_MAX_ITEMS 1000
+#endif
+#define BENCH_SIZES 4       // n = 10,100,1000,10000，超过 BENCH_MAX_ITEMS 的不测
+#define BENCH_PATTERNS 3
+#define BENCH_METHODS 3
+
+volatile uint32_t insert_counts[BENCH_PATTERNS][BENCH_METHODS][BENCH_SIZES];
+volatile uint32_t list_errors;
+volatile uint32_t bench_done;
+
+List_t bench_list;
+ListItem_t bench_items[BENCH_MAX_ITEMS];
+uint32_t bench_seed;
+
+static TickType_t bench_value(uint32_t pattern, uint32_t i)
+{
+	bench_seed = bench_seed * 1664525UL + 1013904223UL;
+	switch (pattern)
+	{
+	case 0:
+		return (TickType_t)(i * 4U);
+	case 1:
+		return (TickType_t)((bench_seed >> 8) % 60000U);
+	default:
+		return (TickType_t)(i * 4U + ((bench_seed >> 8) % 64U));
+	}
+}
+
+static void bench_check(uint32_t n)
+{
+	ListItem_t *item = listGET_HEAD_ENTRY(&bench_list);
+	uint32_t count = 0;
+
+	for (; item != listGET_END_MARKER(&bench_list); item = listGET_NEXT(item))
+	{
+		if ((listGET_NEXT(item) != listGET_END_MARKER(&bench_list)) &&
+			(listGET_LIST_ITEM_VALUE(listGET_NEXT(item)) < listGET_LIST_ITEM_VALUE(item)))
+		{
+			list_errors++;
+		}
+		count++;
+	}
+	if ((count != n) || (listCURRENT_LIST_LENGTH(&bench_list) != n))
+	{
+		list_errors++;
+	}
+}
+
+void task1_entry(void *p_arg)
+{
+	static const uint32_t sizes[BENCH_SIZES] = {10, 100, 1000, 10000};
+
+	vPortHighResTimeInit();
+	for (uint32_t pattern = 0; pattern < BENCH_PATTERNS; pattern++)
+	{
+		for (uint32_t method = 0; method < BENCH_METHODS; method++)
+		{
+			for (uint32_t s = 0; (s < BENCH_SIZES) && (sizes[s] <= BENCH_MAX_ITEMS); s++)
+			{
+				uint32_t n = sizes[s];
+				ListItem_t *hint = NULL;
+				HighResTime_t start;
+
+				// 每种插入方式用同样的数据
+				bench_seed = 12345;
+				vListInitialise(&bench_list);
+				for (uint32_t i = 0; i < n; i++)
+				{
+					vListInitialiseItem(&bench_items[i]);
+					listSET_LIST_ITEM_VALUE(&bench_items[i], bench_value(pattern, i));
+				}
+
+				start = portGET_HIGH_RES_TIME();
+				for (uint32_t i = 0; i < n; i++)
+				{
+					switch (method)
+					{
+					case 0:
+						vListInsert(&bench_list, &bench_items[i]);
+						break;
+					case 1:
+						vListInsertBidirectional(&bench_list, &bench_items[i]);
+						break;
+					default:
+						vListInsertHinted(&bench_list, hint, &bench_items[i]);
+						hint = &bench_items[i];
+						break;
+					}
+				}
+				insert_counts[pattern][method][s] = (portGET_HIGH_RES_TIME() - start) / n;
+				bench_check(n);
+			}
+		}
+	}
+	bench_done = 1;
+	for (;;)
+	{
+		vTaskDelay(100);
+	}
+}
+
+StaticTask_t Task1TCB;
+TaskHandle_t task1_handle;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	task1_handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task1Stack,
+									 &Task1TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,263 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 发布/订阅扇出基准：零拷贝消息总线与每个订阅者一个拷贝队列对比
+ * freertos_config.h 中设置 configUSE_QUEUES 和 configUSE_MSGBUS 为 1
+ * bench 任务发布 BENCH_FRAMES 帧 FRAME_SIZE 字节的数据，n 个订阅者任务（n = 1,2,4,8,16）每个都收到全部帧：
+ *   bus_counts[i]   消息总线：帧只写一次，每个订阅者收到同一块缓冲区的指针，用完释放
+ *   copy_counts[i]  拷贝队列：每个订阅者一个队列，帧按值拷进每个队列，再拷出到订阅者自己的缓冲区
+ * 数值是每帧从发布到所有订阅者处理完的平均时间，单位是高精度时间计数：Cortex-M3 上是cpu时钟周期(DWT)，Posix port 上是纳秒
+ * 订阅者检查帧首尾的序号，sequence_errors 不为0说明丢失、重复或者数据被覆盖；
+ * 内存：消息总线只要 POOL_BLOCKS 块缓冲区，拷贝队列要 n * COPY_QUEUE_LENGTH 帧
+ * 订阅者的环长度等于缓冲池块数，不会丢消息，dropped 应为0；每轮结束后缓冲池应全部空闲，pool_leaks 应为0
+ * bench_done 为1后在调试器中读数组
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+#include "queue.h"
+#include "msgbus.h"
+
+#if (configUSE_QUEUES == 0) || (configUSE_MSGBUS == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_QUEUES 和 configUSE_MSGBUS 为 1"
+#endif
+#if (configNUMBER_OF_CORES > 1)
+#error "基准只在单核下测量"
+#endif
+
+#define BENCH_SIZES 5
+#define MAX_SUBSCRIBERS 16
+#define BENCH_FRAMES 200
+#define FRAME_SIZE 128
+#define FRAME_WORDS (FRAME_SIZE / sizeof(uint32_t))
+#define POOL_BLOCKS 8
+#define COPY_QUEUE_LENGTH 8
+#define SUBSCRIBER_STACK_SIZE 96
+
+volatile uint32_t bus_counts[BENCH_SIZES];     // n = 1,2,4,8,16
+volatile uint32_t copy_counts[BENCH_SIZES];
+volatile uint32_t sequence_errors;
+volatile uint32_t dropped;
+volatile uint32_t pool_leaks;
+volatile uint32_t bench_done;
+volatile uint32_t use_bus;                      // 本轮订阅者从哪里接收
+
+MsgPool_t FramePool;
+uint64_t frame_pool_storage[msgbusPOOL_STORAGE_WORDS(POOL_BLOCKS, FRAME_SIZE)];
+MsgTopic_t FrameTopic;
+MsgSubscriber_t FrameSubscriber[MAX_SUBSCRIBERS];
+void *frame_rings[MAX_SUBSCRIBERS][POOL_BLOCKS];
+
+StaticQueue_t CopyQueue[MAX_SUBSCRIBERS];
+uint8_t copy_queue_storage[MAX_SUBSCRIBERS][COPY_QUEUE_LENGTH * FRAME_SIZE];
+StaticQueue_t StartSemaphore[MAX_SUBSCRIBERS];
+StaticQueue_t DoneSemaphore;
+
+// 订阅者对一帧的处理：检查首尾序号
+static void check_frame(const uint32_t *frame, uint32_t expected)
+{
+	if (frame[0] != expected || frame[FRAME_WORDS - 1] != expected)
+	{
+		sequence_errors++;
+	}
+}
+
+void subscriber_entry(void *p_arg)
+{
+	uint32_t index = (uint32_t)(uintptr_t)p_arg;
+	uint32_t frame[FRAME_WORDS];
+
+	for (;;)
+	{
+		(void)xQueueReceive(&StartSemaphore[index], NULL, portMAX_DELAY);
+		for (uint32_t seq = 0; seq < BENCH_FRAMES; seq++)
+		{
+			if (use_bus)
+			{
+				const uint32_t *message = pvMsgBusReceive(&FrameSubscriber[index], portMAX_DELAY);
+				check_frame(message, seq);
+				vMsgBusRelease((void *)message);
+			}
+			else
+			{
+				(void)xQueueReceive(&CopyQueue[index], frame, portMAX_DELAY);
+				check_frame(frame, seq);
+			}
+		}
+		(void)xQueueSend(&DoneSemaphore, NULL, portMAX_DELAY);
+	}
+}
+
+static void fill_frame(uint32_t *frame, uint32_t seq)
+{
+	for (uint32_t w = 0; w < FRAME_WORDS; w++)
+	{
+		frame[w] = seq;
+	}
+}
+
+// 返回每帧的平均时间
+static uint32_t run_round(uint32_t n, uint32_t bus)
+{
+	uint32_t frame[FRAME_WORDS];
+	HighResTime_t start;
+
+	use_bus = bus;
+	if (bus)
+	{
+		for (uint32_t k = 0; k < n; k++)
+		{
+			vMsgBusSubscribe(&FrameTopic, &FrameSubscriber[k], frame_rings[k], POOL_BLOCKS);
+		}
+	}
+	for (uint32_t k = 0; k < n; k++)
+	{
+		(void)xQueueSend(&StartSemaphore[k], NULL, 0);
+	}
+
+	start = portGET_HIGH_RES_TIME();
+	for (uint32_t seq = 0; seq < BENCH_FRAMES; seq++)
+	{
+		if (bus)
+		{
+			uint32_t *message = pvMsgBusAlloc(&FramePool, portMAX_DELAY);
+			fill_frame(message, seq);
+			(void)uxMsgBusPublish(&FrameTopic, message, FRAME_SIZE);
+		}
+		else
+		{
+			fill_frame(frame, seq);
+			for (uint32_t k = 0; k < n; k++)
+			{
+				(void)xQueueSend(&CopyQueue[k], frame, portMAX_DELAY);
+			}
+		}
+	}
+	for (uint32_t k = 0; k < n; k++)
+	{
+		(void)xQueueReceive(&DoneSemaphore, NULL, portMAX_DELAY);
+	}
+	start = portGET_HIGH_RES_TIME() - start;
+
+	if (bus)
+	{
+		for (uint32_t k = 0; k < n; k++)
+		{
+			dropped += FrameSubscriber[k].uxDropped;
+			vMsgBusUnsubscribe(&FrameSubscriber[k]);
+		}
+		if (FramePool.uxFree != POOL_BLOCKS)
+		{
+			pool_leaks++;
+		}
+	}
+	return (uint32_t)(start / BENCH_FRAMES);
+}
+
+void bench_entry(void *p_arg)
+{
+	vPortHighResTimeInit();
+	for (uint32_t i = 0; i < BENCH_SIZES; i++)
+	{
+		bus_counts[i] = run_round(1UL << i, 1);
+		copy_counts[i] = run_round(1UL << i, 0);
+	}
+	bench_done = 1;
+	for (;;)
+	{
+		vTaskDelay(100);
+	}
+}
+
+StaticTask_t BenchTCB;
+#define BENCH_STACK_SIZE 128
+StackType_t BenchStack[BENCH_STACK_SIZE];
+StaticTask_t SubscriberTCB[MAX_SUBSCRIBERS];
+StackType_t SubscriberStack[MAX_SUBSCRIBERS][SUBSCRIBER_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	vMsgPoolInitialise(&FramePool, frame_pool_storage, POOL_BLOCKS, FRAME_SIZE);
+	vMsgTopicInitialise(&FrameTopic);
+	(void)xQueueCreateCountingSemaphoreStatic(MAX_SUBSCRIBERS, 0, &DoneSemaphore);
+	for (uint32_t k = 0; k < MAX_SUBSCRIBERS; k++)
+	{
+		(void)xQueueCreateStatic(COPY_QUEUE_LENGTH, FRAME_SIZE, copy_queue_storage[k], &CopyQueue[k]);
+		(void)xQueueCreateCountingSemaphoreStatic(1, 0, &StartSemaphore[k]);
+		xTaskCreateStatic((TaskFunction_t)subscriber_entry,
+						  "subscriber",
+						  SUBSCRIBER_STACK_SIZE,
+						  (void *)(uintptr_t)k,
+						  1,
+						  SubscriberStack[k],
+						  &SubscriberTCB[k]);
+	}
+	// 发布者与订阅者同优先级，释放缓冲区、取走队列数据时不抢占，发布者一次发满缓冲池或队列，切换次数不会掩盖拷贝的代价
+	xTaskCreateStatic((TaskFunction_t)bench_entry,
+					  "bench",
+					  BENCH_STACK_SIZE,
+					  NULL,
+					  1,
+					  BenchStack,
+					  &BenchTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,163 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 故障现场记录
+ * freertos_config.h 中设置 configUSE_POST_MORTEM 为 1（只支持 ARM_CM3、ARM_CM4F），链接脚本中 .bss.noinit 不清零
+ * 第一次启动：task1 每个tick翻转 flag1，task2 运行 200 个tick后执行未定义指令（crash 函数），进入 HardFault，
+ * 记录故障现场后复位。
+ * 第二次启动：main 开头在调度器启动之前读出上次的记录，last_magic 是 postmortemMAGIC_FAULT，
+ * fault_in_crash 为1表示异常帧中的PC就在 crash 函数中，fault_task_is_task2 为1表示出故障的是 task2；
+ * 这次 task2 不再出错，两个任务一直运行。也可以在第二次启动时停在 main 开头导出记录：
+ *   (gdb) dump binary value postmortem.bin xPostMortem
+ *   python3 tools/post_mortem.py 固件.elf postmortem.bin
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_POST_MORTEM == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_POST_MORTEM 为 1"
+#endif
+
+volatile uint32_t flag1;
+volatile uint32_t flag2;
+volatile uint32_t last_magic;
+volatile uint32_t last_fault_pc;
+volatile uint32_t fault_in_crash;
+volatile uint32_t fault_task_is_task2;
+volatile uint32_t task2_stack_free;
+
+StaticTask_t Task1TCB;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+
+__attribute__((noinline)) void crash(void)
+{
+	__asm volatile("udf #0"); // 未定义指令，UsageFault 没有打开，升级为 HardFault
+}
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag1 ^= 1;
+		vTaskDelay(1);
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	vTaskDelay(200);
+	if (last_magic != postmortemMAGIC_FAULT)
+	{
+		crash();
+	}
+	for (;;)
+	{
+		flag2 ^= 1;
+		vTaskDelay(2);
+	}
+}
+
+// 调度器启动时会重新开始记录，上次的内容要在这之前取走
+static void read_last_post_mortem(void)
+{
+	last_magic = xPostMortem.ulMagic;
+	if (last_magic != postmortemMAGIC_FAULT)
+	{
+		return;
+	}
+	last_fault_pc = xPostMortem.ulFrame[6];
+	// udf 是 crash 的第一条指令，PC 在函数开头几个字节之内
+	fault_in_crash = ((last_fault_pc & ~1UL) - ((uint32_t)crash & ~1UL)) < 8UL;
+	fault_task_is_task2 = (xPostMortem.ulCurrentTask == (uint32_t)&Task2TCB);
+	for (uint32_t i = 0; i < xPostMortem.ulStackCount; i++)
+	{
+		if (xPostMortem.xStacks[i].ulTask == (uint32_t)&Task2TCB)
+		{
+			task2_stack_free = xPostMortem.xStacks[i].ulFree;
+		}
+	}
+}
+
+int main(void)
+{
+	dummy_noinit = 0;
+	read_last_post_mortem();
+	xTaskCreateStatic((TaskFunction_t)task1_entry,
+					  "task1",
+					  TASK1_STACK_SIZE,
+					  NULL,
+					  1,
+					  Task1Stack,
+					  &Task1TCB);
+	xTaskCreateStatic((TaskFunction_t)task2_entry,
+					  "task2",
+					  TASK2_STACK_SIZE,
+					  NULL,
+					  2,
+					  Task2Stack,
+					  &Task2TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
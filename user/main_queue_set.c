@@ -0,0 +1,257 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 队列集合
+ * freertos_config.h 中设置 configUSE_QUEUES 和 configUSE_QUEUE_SETS 为 1
+ * gateway 任务只阻塞在一个队列集合上，集合中有6个输入：4个队列、1个二值信号量、1个计数信号量
+ *   1. 队列i由 producer_i 任务发送递增的数，gateway 检查收到的数是连续的，sequence_errors 不为0说明丢失或重复；
+ *      producer_0 优先级比 gateway 高，每次连续发送8个，队列长度只有4，会阻塞等待 gateway 取走
+ *   2. giver 任务给出两个信号量，二值信号量已经给出时再给出会失败，只统计成功的次数
+ *   3. 每隔一段时间所有生产者停顿 QUIET_TICKS 个tick，gateway 选择超时，select_timeouts 计数
+ * 正常时每个输入的 sent[i] 与 received[i] 相差不超过该输入的长度；select_empty 是选中了却取不到数据的次数，应为0
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#if (configUSE_QUEUES == 0) || (configUSE_QUEUE_SETS == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_QUEUES 和 configUSE_QUEUE_SETS 为 1"
+#endif
+
+#define QUEUE_COUNT 4
+#define QUEUE_LENGTH 4
+#define COUNTING_MAX 4
+#define INPUT_COUNT (QUEUE_COUNT + 2)
+#define SET_LENGTH (QUEUE_COUNT * QUEUE_LENGTH + 1 + COUNTING_MAX)
+#define QUIET_TICKS 30
+
+volatile uint32_t sent[INPUT_COUNT];
+volatile uint32_t received[INPUT_COUNT];
+volatile uint32_t sequence_errors;
+volatile uint32_t select_timeouts;
+volatile uint32_t select_empty;
+volatile uint32_t quiet;
+
+StaticQueue_t InputQueue[QUEUE_COUNT];
+uint8_t input_queue_storage[QUEUE_COUNT][QUEUE_LENGTH * sizeof(uint32_t)];
+QueueHandle_t input_queue[QUEUE_COUNT];
+StaticSemaphore_t BinarySemaphore;
+SemaphoreHandle_t binary_semaphore;
+StaticSemaphore_t CountingSemaphore;
+SemaphoreHandle_t counting_semaphore;
+StaticQueue_t GatewaySet;
+uint8_t gateway_set_storage[queueSET_STORAGE_SIZE(SET_LENGTH)];
+QueueSetHandle_t gateway_set;
+
+void gateway_entry(void *p_arg)
+{
+	uint32_t expected[QUEUE_COUNT] = {0};
+	uint32_t number;
+	QueueSetMemberHandle_t member;
+
+	for (;;)
+	{
+		member = xQueueSelectFromSet(gateway_set, 20);
+		if (member == NULL)
+		{
+			select_timeouts++;
+			continue;
+		}
+		if (member == binary_semaphore || member == counting_semaphore)
+		{
+			if (xSemaphoreTake(member, 0) == pdPASS)
+			{
+				received[(member == binary_semaphore) ? QUEUE_COUNT : QUEUE_COUNT + 1]++;
+			}
+			else
+			{
+				select_empty++;
+			}
+			continue;
+		}
+		for (uint32_t i = 0; i < QUEUE_COUNT; i++)
+		{
+			if (member != input_queue[i])
+			{
+				continue;
+			}
+			if (xQueueReceive(member, &number, 0) != pdPASS)
+			{
+				select_empty++;
+				break;
+			}
+			if (number != expected[i])
+			{
+				sequence_errors++;
+			}
+			expected[i] = number + 1;
+			received[i]++;
+			break;
+		}
+	}
+}
+
+void producer_entry(void *p_arg)
+{
+	uint32_t index = (uint32_t)(uintptr_t)p_arg;
+	uint32_t number = 0;
+
+	for (;;)
+	{
+		if (quiet)
+		{
+			vTaskDelay(QUIET_TICKS);
+			continue;
+		}
+		// producer_0 一次发送8个，其余每次1个
+		for (uint32_t burst = 0; burst < ((index == 0) ? 8U : 1U); burst++)
+		{
+			if (xQueueSend(input_queue[index], &number, 100) == pdPASS)
+			{
+				number++;
+				sent[index]++;
+			}
+		}
+		vTaskDelay((TickType_t)(index + 1));
+	}
+}
+
+void giver_entry(void *p_arg)
+{
+	uint32_t round = 0;
+
+	for (;;)
+	{
+		// 每200个tick停顿一次，让 gateway 选择超时
+		if (++round % 200 == 0)
+		{
+			quiet = 1;
+			vTaskDelay(QUIET_TICKS * 2);
+			quiet = 0;
+		}
+		if (xSemaphoreGive(binary_semaphore) == pdPASS)
+		{
+			sent[QUEUE_COUNT]++;
+		}
+		if (xSemaphoreGive(counting_semaphore) == pdPASS)
+		{
+			sent[QUEUE_COUNT + 1]++;
+		}
+		if (xSemaphoreGive(counting_semaphore) == pdPASS)
+		{
+			sent[QUEUE_COUNT + 1]++;
+		}
+		vTaskDelay(1);
+	}
+}
+
+StaticTask_t GatewayTCB;
+#define GATEWAY_STACK_SIZE 256
+StackType_t GatewayStack[GATEWAY_STACK_SIZE];
+StaticTask_t ProducerTCB[QUEUE_COUNT];
+#define PRODUCER_STACK_SIZE 128
+StackType_t ProducerStack[QUEUE_COUNT][PRODUCER_STACK_SIZE];
+StaticTask_t GiverTCB;
+#define GIVER_STACK_SIZE 128
+StackType_t GiverStack[GIVER_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	gateway_set = xQueueCreateSetStatic(SET_LENGTH, gateway_set_storage, &GatewaySet);
+	for (uint32_t i = 0; i < QUEUE_COUNT; i++)
+	{
+		input_queue[i] = xQueueCreateStatic(QUEUE_LENGTH, sizeof(uint32_t), input_queue_storage[i], &InputQueue[i]);
+		xQueueAddToSet(input_queue[i], gateway_set);
+	}
+	binary_semaphore = xSemaphoreCreateBinaryStatic(&BinarySemaphore);
+	xQueueAddToSet(binary_semaphore, gateway_set);
+	counting_semaphore = xSemaphoreCreateCountingStatic(COUNTING_MAX, 0, &CountingSemaphore);
+	xQueueAddToSet(counting_semaphore, gateway_set);
+
+	xTaskCreateStatic((TaskFunction_t)gateway_entry,
+					  "gateway",
+					  GATEWAY_STACK_SIZE,
+					  NULL,
+					  2,
+					  GatewayStack,
+					  &GatewayTCB);
+	for (uint32_t i = 0; i < QUEUE_COUNT; i++)
+	{
+		xTaskCreateStatic((TaskFunction_t)producer_entry,
+						  "producer",
+						  PRODUCER_STACK_SIZE,
+						  (void *)(uintptr_t)i,
+						  (i == 0) ? 3 : 1,
+						  ProducerStack[i],
+						  &ProducerTCB[i]);
+	}
+	xTaskCreateStatic((TaskFunction_t)giver_entry,
+					  "giver",
+					  GIVER_STACK_SIZE,
+					  NULL,
+					  1,
+					  GiverStack,
+					  &GiverTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,267 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 多核调度压力测试，在linux主机上用 Posix port 运行
+ * freertos_config.h 中设置：
+ *   configNUMBER_OF_CORES 2（或更多）
+ *   configTICK_RATE_HZ 1000（可选，tick越快切换越频繁）
+ * 编译运行：
+ *   gcc -O2 -pthread -Ifreertos/include -Ifreertos/portable/GCC/Posix freertos/list.c freertos/task.c \
+ *       freertos/portable/GCC/Posix/port.c user/main_smp.c -o smp && ./smp
+ * 检查的内容：
+ *   1. 临界区互斥：所有工作任务在临界区里做非原子的"读-忙等-写"，共享计数必须等于各任务计数之和
+ *   2. 核号与当前任务一致：任务在临界区里读到的当前任务句柄必须是自己
+ *   3. 亲和性：固定在最后一个核上的 pinned 只能在那个核上运行；mover 不断修改 worker0 的亲和性，worker0 在核间来回搬
+ *   4. 工作窃取：worker 数多于核数，每个核都应该分到工作，migrations 是 worker 换核的次数
+ * monitor 每秒打印一次统计，运行 RUN_SECONDS 秒后以错误数作为进程返回值退出
+ * --------------------------------------------------------------------------
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "task.h"
+
+#if (configNUMBER_OF_CORES < 2)
+#error "本例需要在freertos_config.h中设置 configNUMBER_OF_CORES 大于 1，并使用 Posix port"
+#endif
+
+#define WORKER_NUM 4
+#define RUN_SECONDS 10
+
+typedef struct
+{
+	TaskHandle_t xHandle;
+	volatile uint32_t ulLoops;				// 在临界区中加一的次数
+	volatile uint32_t ulCoreLoops[configNUMBER_OF_CORES]; // 在每个核上的循环次数
+	volatile uint32_t ulMigrations;			// 两次循环之间换了核的次数
+} Worker_t;
+
+Worker_t workers[WORKER_NUM];
+volatile uint32_t shared_counter;
+volatile uint32_t handle_error;
+volatile uint32_t affinity_error;
+volatile uint32_t pinned_loops;
+
+void vDelay(uint32_t delay)
+{
+	for (volatile uint32_t i = 0; i < delay; i++)
+		;
+}
+
+/* 在临界区中检查当前任务句柄，并返回当前核号 */
+static BaseType_t prvCheckedCoreID(TaskHandle_t xSelf)
+{
+	BaseType_t xCoreID;
+	taskENTER_CRITICAL();
+	{
+		xCoreID = portGET_CORE_ID();
+		if (xTaskGetCurrentTaskHandleForCore(xCoreID) != xSelf)
+		{
+			handle_error++;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return xCoreID;
+}
+
+void worker_entry(void *p_arg)
+{
+	Worker_t *const pxWorker = (Worker_t *)p_arg;
+	BaseType_t xLastCore = -1;
+	for (;;)
+	{
+		BaseType_t xCoreID = prvCheckedCoreID(pxWorker->xHandle);
+		if ((xLastCore >= 0) && (xCoreID != xLastCore))
+		{
+			pxWorker->ulMigrations++;
+		}
+		xLastCore = xCoreID;
+		pxWorker->ulCoreLoops[xCoreID]++;
+
+		taskENTER_CRITICAL();
+		{	// 非原子的读改写，没有互斥就会丢失计数
+			uint32_t ulValue = shared_counter;
+			vDelay(50);
+			shared_counter = ulValue + 1;
+			pxWorker->ulLoops++;
+		}
+		taskEXIT_CRITICAL();
+		vDelay(2000);
+	}
+}
+
+/* 固定在最后一个核上，周期性阻塞 */
+void pinned_entry(void *p_arg)
+{
+	TaskHandle_t *pxSelf = (TaskHandle_t *)p_arg;
+	for (;;)
+	{
+		if (prvCheckedCoreID(*pxSelf) != configNUMBER_OF_CORES - 1)
+		{
+			affinity_error++;
+		}
+		pinned_loops++;
+		vTaskDelay(1);
+	}
+}
+
+/* 不断修改 worker0 的亲和性：固定到核0，固定到核1，不限制 */
+void mover_entry(void *p_arg)
+{
+	UBaseType_t uxStep = 0;
+	for (;;)
+	{
+		vTaskDelay(7);
+		switch (uxStep++ % 3)
+		{
+		case 0:
+			vTaskCoreAffinitySet(workers[0].xHandle, 1UL << 0);
+			break;
+		case 1:
+			vTaskCoreAffinitySet(workers[0].xHandle, 1UL << 1);
+			break;
+		default:
+			vTaskCoreAffinitySet(workers[0].xHandle, tskNO_AFFINITY);
+			break;
+		}
+	}
+}
+
+void monitor_entry(void *p_arg)
+{
+	for (uint32_t ulSecond = 1; ; ulSecond++)
+	{
+		uint32_t ulSum = 0, ulShared;
+		vTaskDelay(configTICK_RATE_HZ);
+
+		taskENTER_CRITICAL();
+		{
+			ulShared = shared_counter;
+			for (int i = 0; i < WORKER_NUM; i++)
+			{
+				ulSum += workers[i].ulLoops;
+			}
+			printf("[%2u s] shared=%u sum=%u handle_err=%u affinity_err=%u pinned=%u\n",
+				   (unsigned)ulSecond, (unsigned)ulShared, (unsigned)ulSum,
+				   (unsigned)handle_error, (unsigned)affinity_error, (unsigned)pinned_loops);
+			for (int i = 0; i < WORKER_NUM; i++)
+			{
+				printf("    worker%d loops=%u migrations=%u cores:", i, (unsigned)workers[i].ulLoops, (unsigned)workers[i].ulMigrations);
+				for (int c = 0; c < configNUMBER_OF_CORES; c++)
+				{
+					printf(" %u", (unsigned)workers[i].ulCoreLoops[c]);
+				}
+				printf("\n");
+			}
+			fflush(stdout);
+		}
+		taskEXIT_CRITICAL();
+
+		if (ulShared != ulSum)
+		{
+			printf("FAIL: 临界区没有互斥\n");
+			exit(1);
+		}
+		if (ulSecond == RUN_SECONDS)
+		{
+			uint32_t ulErrors = handle_error + affinity_error + (pinned_loops == 0);
+			printf("%s\n", (ulErrors == 0) ? "PASS" : "FAIL");
+			exit(ulErrors == 0 ? 0 : 1);
+		}
+	}
+}
+
+StaticTask_t WorkerTCB[WORKER_NUM];
+#define WORKER_STACK_SIZE 128
+StackType_t WorkerStack[WORKER_NUM][WORKER_STACK_SIZE];
+StaticTask_t PinnedTCB;
+TaskHandle_t pinned_handle;
+StackType_t PinnedStack[128];
+StaticTask_t MoverTCB;
+StackType_t MoverStack[128];
+StaticTask_t MonitorTCB;
+StackType_t MonitorStack[128];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	for (int i = 0; i < WORKER_NUM; i++)
+	{
+		workers[i].xHandle = xTaskCreateStatic((TaskFunction_t)worker_entry,
+											   "worker",
+											   WORKER_STACK_SIZE,
+											   &workers[i],
+											   1,
+											   WorkerStack[i],
+											   &WorkerTCB[i]);
+	}
+	pinned_handle = xTaskCreateStatic((TaskFunction_t)pinned_entry,
+									  "pinned",
+									  128,
+									  &pinned_handle,
+									  2,
+									  PinnedStack,
+									  &PinnedTCB);
+	vTaskCoreAffinitySet(pinned_handle, 1UL << (configNUMBER_OF_CORES - 1));
+	(void)xTaskCreateStatic((TaskFunction_t)mover_entry, "mover", 128, NULL, 3, MoverStack, &MoverTCB);
+	(void)xTaskCreateStatic((TaskFunction_t)monitor_entry, "monitor", 128, NULL, 4, MonitorStack, &MonitorTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
@@ -0,0 +1,197 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 任务删除与复用池
+ * freertos_config.h 中设置 configUSE_TASK_DELETE 为 1
+ * 开始时用 vTaskPoolAdd 放入3个128深度、1个256深度的栈与控制块，spawner 每 20 个tick用 xTaskCreate 从池中创建三个任务：
+ *   1. worker（需要100）：延时5个tick后 completed++，然后自删除，由空闲任务在它切出后回收
+ *   2. sleeper（需要200）：一直在延时队列中，10个tick后被 spawner 删除，直接回收
+ *   3. spinner（需要100）：优先级1的忙循环，一直在就绪队列中（多核时可能正在另一个核上运行），10个tick后被删除
+ * 另外每轮申请一次512深度，池中没有这么大的，create_failures 应该等于 rounds
+ * 每轮开始时检查任务数回到 task_baseline、池中回到4个，count_errors、pool_errors 应该为0；
+ * 被删除的任务的栈与控制块回到池中，可以一直循环下去
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_TASK_DELETE == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_TASK_DELETE 为 1"
+#endif
+
+#define POOL_SMALL_COUNT 3
+#define POOL_SMALL_DEPTH 128
+#define POOL_LARGE_DEPTH 256
+
+volatile uint32_t flag1;
+volatile uint32_t rounds;
+volatile uint32_t spawned;
+volatile uint32_t completed;
+volatile uint32_t killed;
+volatile uint32_t spins;
+volatile uint32_t create_failures;
+volatile uint32_t count_errors;
+volatile uint32_t pool_errors;
+volatile uint32_t task_baseline;
+
+StaticTask_t PoolTCB[POOL_SMALL_COUNT + 1];
+StackType_t PoolSmallStack[POOL_SMALL_COUNT][POOL_SMALL_DEPTH];
+StackType_t PoolLargeStack[POOL_LARGE_DEPTH];
+
+void worker_entry(void *p_arg)
+{
+	vTaskDelay(5);
+	completed++;
+	vTaskDelete(NULL);
+}
+
+void sleeper_entry(void *p_arg)
+{
+	for (;;)
+	{
+		vTaskDelay(1000);
+	}
+}
+
+void spinner_entry(void *p_arg)
+{
+	for (;;)
+	{
+		spins++;
+	}
+}
+
+void spawner_entry(void *p_arg)
+{
+	TaskHandle_t sleeper_handle;
+	TaskHandle_t spinner_handle;
+	TaskHandle_t unused_handle;
+
+	task_baseline = uxTaskGetNumberOfTasks();
+	for (;;)
+	{
+		if (uxTaskGetNumberOfTasks() != task_baseline)
+		{
+			count_errors++;
+		}
+		if (uxTaskPoolGetCount() != POOL_SMALL_COUNT + 1)
+		{
+			pool_errors++;
+		}
+
+		if (xTaskCreate((TaskFunction_t)worker_entry, "worker", 100, NULL, 2, NULL) == pdPASS)
+		{
+			spawned++;
+		}
+		if (xTaskCreate((TaskFunction_t)sleeper_entry, "sleeper", 200, NULL, 2, &sleeper_handle) == pdPASS)
+		{
+			spawned++;
+		}
+		if (xTaskCreate((TaskFunction_t)spinner_entry, "spinner", 100, NULL, 1, &spinner_handle) == pdPASS)
+		{
+			spawned++;
+		}
+		if (xTaskCreate((TaskFunction_t)worker_entry, "huge", 512, NULL, 2, &unused_handle) != pdPASS)
+		{
+			create_failures++;
+		}
+
+		flag1 = 1;
+		vTaskDelay(10);
+		if (sleeper_handle != NULL)
+		{
+			vTaskDelete(sleeper_handle);
+			killed++;
+		}
+		if (spinner_handle != NULL)
+		{
+			vTaskDelete(spinner_handle);
+			killed++;
+		}
+		flag1 = 0;
+		vTaskDelay(10);
+		rounds++;
+	}
+}
+
+StaticTask_t SpawnerTCB;
+TaskHandle_t spawner_handle;
+#define SPAWNER_STACK_SIZE 128
+StackType_t SpawnerStack[SPAWNER_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	for (uint32_t i = 0; i < POOL_SMALL_COUNT; i++)
+	{
+		vTaskPoolAdd(&PoolTCB[i], PoolSmallStack[i], POOL_SMALL_DEPTH);
+	}
+	vTaskPoolAdd(&PoolTCB[POOL_SMALL_COUNT], PoolLargeStack, POOL_LARGE_DEPTH);
+
+	spawner_handle = xTaskCreateStatic((TaskFunction_t)spawner_entry,
+									   "spawner",
+									   SPAWNER_STACK_SIZE,
+									   NULL,
+									   3,
+									   SpawnerStack,
+									   &SpawnerTCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}
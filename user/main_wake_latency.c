@@ -0,0 +1,170 @@
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+ * dummy_noinit 变量放置在名为 ".bss.noinit" 的内存段中，
+ * __attribute__((section(".bss.noinit")))：请编译器把这个变量放到名为 .bss.noinit 的段（section）(在文件ARMCM3_ac6.sct)中。
+ *
+ * 具体来说：
+ * - section(".bss.noinit") 指定该变量属于名为 ".bss.noinit" 的段。
+ * - 该段通常定义在链接脚本（scatter 文件）中，标记为 UNINIT，
+ *   意味着启动时不会对该段内变量进行初始化（不会被清零，也不会从 Flash 复制初值）。
+ * - 这样变量的值可以在复位或掉电后保留（如果硬件支持），适用于保存状态或调试信息。
+ *
+ * 使用场景示例：
+ * - 保存掉电不丢失的数据（如运行计数器、日志等）
+ * - 调试时保留上次运行数据，辅助分析问题
+ *
+ * 注意事项：
+ * - __attribute__ 是编译器扩展，非标准 C 语法，使用时需确认编译器支持。
+ * - 其作用仅在编译阶段生效，影响代码生成和链接过程。
+ * - 必须保证链接脚本中存在 ".bss.noinit" 段的定义
+ * - 变量必须是全局或静态变量，且有合适的对齐要求
+ * - 使用该属性的变量不会自动初始化，使用时需注意变量初值的正确性
+ * --------------------------------------------------------------------------
+ *
+ * 编译链接运行流程说明：
+ *
+ * 1. 编译阶段
+ *    - 使用 __attribute__((section(".bss.noinit"))) 修饰变量时，
+ *      编译器会将该变量放入目标文件的 ".bss.noinit" 段。
+ *    - 这时 ".bss.noinit" 只是一个段名，变量的数据尚未确定存放的地址。
+ *
+ * 2. 链接阶段
+ *    - 链接器读取 scatter 文件（*.sct），该文件本质是链接器脚本，
+ *      用于告诉链接器如何将不同段映射到最终内存地址。
+ *    - 例如 scatter 文件中可能包含：
+ *        RW_NOINIT __RW_BASE UNINIT __RW_SIZE {
+ *          *(.bss.noinit)
+ *        }
+ *      表示收集所有目标文件中的 ".bss.noinit" 段放入 RW_NOINIT 区域。
+ *    - 因为该段是 UNINIT 类型，链接器不会将其内容写入 Flash 镜像，
+ *      该区域只在运行时 RAM 中分配空间。
+ *    - 链接器根据 scatter 文件，分配每个段的起始地址，生成最终的 ELF 和二进制文件。
+ *
+ * 3. 运行时启动阶段
+ *    - 复位后启动代码执行：
+ *      - 初始化 .data 段（从 Flash 拷贝到 RAM）
+ *      - 清零 .bss 段
+ *      - 跳过 UNINIT 段（如 .bss.noinit），保留该段内存原有数据
+ *
+ * 总结：
+ *  阶段          | 作用                                  | 参与元素
+ * -------------- | ----------------------------------- | -------------------------------
+ *  编译          | 把变量放入 ".bss.noinit" 段            | __attribute__((section(".bss.noinit")))
+ *  链接          | 根据 scatter 文件分配内存地址           | scatter 文件、链接器
+ *  运行时启动    | 跳过该段初始化，保留内存数据             | 启动代码（startup）
+ */
+
+__attribute__((section(".bss.noinit"))) uint32_t dummy_noinit;
+/* ----------------------------------------------------------------------------
+ * 任务唤醒延迟
+ * freertos_config.h 中设置 configUSE_WAKE_LATENCY 为 1
+ * task1（优先级1）与 task2（优先级2）都每个tick唤醒一次，task2 醒来后先忙 WORK_LOOPS 次循环再延时，
+ * 所以 task1 每次都要等 task2 忙完才能运行：
+ *   task2 的唤醒延迟只有tick中断与任务切换的开销，task1 的唤醒延迟还要加上 task2 的忙循环
+ * task3（优先级3）每 100 个tick读一次两者的统计，单位换成微秒放在 task1_us/task2_us（最小、最大）中，
+ * 之后清零，看的是每一段的结果；task1_waits_longer 为1表示 task1 的最小延迟比 task2 的最大延迟还长
+ * --------------------------------------------------------------------------
+ */
+#include "task.h"
+
+#if (configUSE_WAKE_LATENCY == 0)
+#error "需要在 freertos_config.h 中设置 configUSE_WAKE_LATENCY 为 1"
+#endif
+
+#define WORK_LOOPS 2000
+
+volatile uint32_t flag1;
+volatile uint32_t flag2;
+volatile uint32_t crunch_result;
+volatile uint32_t task1_us[2];
+volatile uint32_t task2_us[2];
+volatile uint32_t task1_wakes;
+volatile uint32_t task2_wakes;
+volatile uint32_t task1_waits_longer;
+
+TaskHandle_t Task1_Handle;
+TaskHandle_t Task2_Handle;
+
+void task1_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag1 ^= 1;
+		vTaskDelay(1);
+	}
+}
+
+void task2_entry(void *p_arg)
+{
+	for (;;)
+	{
+		flag2 ^= 1;
+		for (uint32_t i = 0; i < WORK_LOOPS; i++)
+		{
+			crunch_result = crunch_result * 1103515245UL + 12345UL;
+		}
+		vTaskDelay(1);
+	}
+}
+
+void task3_entry(void *p_arg)
+{
+	TaskWakeLatency_t latency1, latency2;
+
+	for (;;)
+	{
+		vTaskDelay(100);
+		vTaskGetWakeLatency(Task1_Handle, &latency1);
+		vTaskGetWakeLatency(Task2_Handle, &latency2);
+		vTaskResetWakeLatency(Task1_Handle);
+		vTaskResetWakeLatency(Task2_Handle);
+		task1_us[0] = portHIGH_RES_TIME_TO_US(latency1.ulMin);
+		task1_us[1] = portHIGH_RES_TIME_TO_US(latency1.ulMax);
+		task2_us[0] = portHIGH_RES_TIME_TO_US(latency2.ulMin);
+		task2_us[1] = portHIGH_RES_TIME_TO_US(latency2.ulMax);
+		task1_wakes += latency1.ulCount;
+		task2_wakes += latency2.ulCount;
+		task1_waits_longer = (latency1.ulMin > latency2.ulMax) ? 1 : 0;
+	}
+}
+
+StaticTask_t Task1TCB;
+#define TASK1_STACK_SIZE 128
+StackType_t Task1Stack[TASK1_STACK_SIZE];
+StaticTask_t Task2TCB;
+#define TASK2_STACK_SIZE 128
+StackType_t Task2Stack[TASK2_STACK_SIZE];
+StaticTask_t Task3TCB;
+#define TASK3_STACK_SIZE 128
+StackType_t Task3Stack[TASK3_STACK_SIZE];
+
+int main(void)
+{
+	dummy_noinit = 0;
+	Task1_Handle = xTaskCreateStatic((TaskFunction_t)task1_entry,
+									 "task1",
+									 TASK1_STACK_SIZE,
+									 NULL,
+									 1,
+									 Task1Stack,
+									 &Task1TCB);
+	Task2_Handle = xTaskCreateStatic((TaskFunction_t)task2_entry,
+									 "task2",
+									 TASK2_STACK_SIZE,
+									 NULL,
+									 2,
+									 Task2Stack,
+									 &Task2TCB);
+	xTaskCreateStatic((TaskFunction_t)task3_entry,
+					  "task3",
+					  TASK3_STACK_SIZE,
+					  NULL,
+					  3,
+					  Task3Stack,
+					  &Task3TCB);
+	vTaskStartScheduler();
+	while (1)
+	{
+	}
+}